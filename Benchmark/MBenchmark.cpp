@@ -0,0 +1,1475 @@
+﻿//----------------------------------------------------------------------
+// 길찾기 / 충돌 체크 벤치마크
+//
+// 사용법 : MBenchmark [--sizes 128,256,512] [--queries 200] [--seed 1]
+//                     [--map a.map --scen a.map.scen] [--label 이름] [--out result.json]
+//
+// 생성한 맵 (random / maze / open / room)과 Moving AI 맵 / 시나리오를 검색 방식별로 검색해서
+// 지연 시간 백분위, 확장한 노드 수, 메모리 할당 수, 같은 이동 방식의 최단 경로 대비 길이 비율을 JSON으로 출력한다
+// 검색 방식 : A* (4 / 8방향), JPS, 양방향 A*, ALT, 비트 그리드, 월드 좌표 A* / Theta*,
+//             HPA* (MHierarchy), 플로우 필드 (단일 / 멀티 스레드), D* Lite, ARA* (MPathSearch)
+// 그 밖의 시나리오 : D* Lite 재계획 (이동 중 주변 타일 막힘을 바꿀 때 처음부터 검색하는 A*와 비교),
+//                   ARA* 스케줄러 (프레임 확장 수 제한), 도달할 수 없는 종료 위치 (연결 영역 정보 사용 / 미사용)
+// 커밋끼리 비교할 수 있도록 --label에 커밋 이름을 넣는다
+// MASTAR_SEARCH_STATS를 정의해서 빌드하면 검색 통계 평균도 출력한다
+// 호출자 버퍼 검색을 다시 실행해서 반복 검색중 메모리 할당 수 (steady_state_allocs)를 확인한다
+//
+// 빌드 : 이 저장소에는 빌드 파일이 없고 기본 헤더 (MPrerequisites.h / MType.h / MVector.h / MTrace.h)가
+//        포함되어 있지 않으므로 그 헤더가 있는 프로젝트에서 Benchmark/*.cpp와 루트의 *.cpp를 함께 빌드한다
+//        (예 : g++ -std=c++17 -O2 -pthread -I<기본 헤더> -I. -IBenchmark Benchmark/*.cpp *.cpp -o MBenchmark)
+//----------------------------------------------------------------------
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "MBenchmarkScenario.h"
+#include "MBenchmarkAlloc.h"
+#include "MAstar.h"
+#include "MBitGrid.h"
+#include "MLandmark.h"
+#include "MCollision.h"
+#include "MCooperative.h"
+#include "MComponent.h"
+#include "MDStarLite.h"
+#include "MFlowField.h"
+#include "MHierarchy.h"
+#include "MPathSearch.h"
+
+
+namespace MAstar
+{
+    namespace
+    {
+        typedef std::chrono::steady_clock MClock;
+
+        // 시간 측정 전에 검색해서 임시 메모리를 미리 할당해둘 문제 수
+        const MINT32 WarmupQueryCount = 16;
+
+        // 랜드마크 수
+        const MINT32 BenchmarkLandmarkCount = 16;
+
+        // 2D경로 찾기에 사용할 타일 크기 / 반지름
+        const MFLOAT BenchmarkTileSize = 1.0f;
+        const MFLOAT BenchmarkRadius = 0.4f;
+
+        // 충돌 체크 박스 수 / 체크할 박스 수
+        const MINT32 CollisionBoxCount = 4096;
+        const MINT32 CollisionQueryCount = 256;
+
+        // 협동 경로 검색 맵 크기 / 틱 수
+        const MINT32 CooperativeMapSize = 128;
+        const MINT32 CooperativeTickCount = 300;
+
+        // 흐름 필드 방향 계산 스레드 수
+        const MINT32 FlowFieldThreadCount = 4;
+
+        // ARA* 처음 가중치 / 경로를 찾을때마다 줄일 가중치 / Step 한번에 확장할 노드 수
+        const MFLOAT IncrementalWeight = 2.0f;
+        const MFLOAT IncrementalWeightStep = 0.5f;
+        const MINT32 IncrementalStepExpandCount = 1024;
+
+        // 스케줄러 프레임당 확장 수 / 최대 프레임 수
+        const MINT32 SchedulerExpandBudget = 4096;
+        const MINT32 SchedulerMaxFrameCount = 100000;
+
+        // D* Lite 재계획 : 문제 수 / 타일을 바꾸는 이동 간격 / 한번에 바꿀 타일 수 / 에이전트 주변 범위 (타일 수)
+        const MINT32 ReplanQueryCount = 20;
+        const MINT32 ReplanStepInterval = 4;
+        const MINT32 ReplanToggleCount = 8;
+        const MINT32 ReplanToggleRange = 8;
+
+        //------------------------------------------------------------------
+        // 검색 방식
+        //------------------------------------------------------------------
+        enum class MBenchmarkEngine
+        {
+            AStar4,
+            AStar8,
+            AStar8CornerCut,
+            JumpPoint,
+            Bidirectional4,
+            Bidirectional8,
+            Landmark4,
+            BitGrid4,
+            AStarWorld,
+            ThetaStarWorld,
+        };
+
+        const MBenchmarkEngine EngineList[] = {
+            MBenchmarkEngine::AStar4, MBenchmarkEngine::AStar8, MBenchmarkEngine::AStar8CornerCut, MBenchmarkEngine::JumpPoint,
+            MBenchmarkEngine::Bidirectional4, MBenchmarkEngine::Bidirectional8, MBenchmarkEngine::Landmark4, MBenchmarkEngine::BitGrid4,
+            MBenchmarkEngine::AStarWorld, MBenchmarkEngine::ThetaStarWorld,
+        };
+
+        //------------------------------------------------------------------
+        // 이동 방식 (검색 방식마다 같은 이동 방식의 최단 경로와 길이를 비교한다)
+        //------------------------------------------------------------------
+        enum class MMovementModel
+        {
+            Four,               // 상하좌우
+            Eight,              // 대각선 포함 (모서리 통과 불가)
+            EightCornerCut,     // 대각선 포함 (모서리 통과)
+            AnyAngle,           // 직선 이동 (정확한 최단 경로 대신 대각선 최단 경로를 기준으로 사용, 1보다 작을수록 짧다)
+            Count,
+        };
+
+        MMovementModel GetMovementModel(MBenchmarkEngine inEngine)
+        {
+            switch (inEngine)
+            {
+            case MBenchmarkEngine::AStar8:
+            case MBenchmarkEngine::Bidirectional8:
+                return MMovementModel::Eight;
+
+            case MBenchmarkEngine::AStar8CornerCut:
+                return MMovementModel::EightCornerCut;
+
+            case MBenchmarkEngine::AStarWorld:
+            case MBenchmarkEngine::ThetaStarWorld:
+                return MMovementModel::AnyAngle;
+
+            default:
+                return MMovementModel::Four;
+            }
+        }
+
+        const char* GetMovementModelName(MMovementModel inModel)
+        {
+            switch (inModel)
+            {
+            case MMovementModel::Four:              return "four";
+            case MMovementModel::Eight:             return "eight";
+            case MMovementModel::EightCornerCut:    return "eight_cornercut";
+            case MMovementModel::AnyAngle:          return "any_angle";
+            default:                                break;
+            }
+
+            return "unknown";
+        }
+
+        const char* GetEngineName(MBenchmarkEngine inEngine)
+        {
+            switch (inEngine)
+            {
+            case MBenchmarkEngine::AStar4:          return "astar4";
+            case MBenchmarkEngine::AStar8:          return "astar8";
+            case MBenchmarkEngine::AStar8CornerCut: return "astar8_cornercut";
+            case MBenchmarkEngine::JumpPoint:       return "jps";
+            case MBenchmarkEngine::Bidirectional4:  return "bidirectional4";
+            case MBenchmarkEngine::Bidirectional8:  return "bidirectional8";
+            case MBenchmarkEngine::Landmark4:       return "alt4";
+            case MBenchmarkEngine::BitGrid4:        return "bitgrid4";
+            case MBenchmarkEngine::AStarWorld:      return "astar_world";
+            case MBenchmarkEngine::ThetaStarWorld:  return "thetastar_world";
+            }
+
+            return "unknown";
+        }
+
+        //------------------------------------------------------------------
+        // 보호된 함수를 직접 측정하기 위한 길찾기
+        //------------------------------------------------------------------
+        class MBenchmarkPathFinder : public MPathFinder
+        {
+        public:
+            using MPathFinder::CheckBlockLine;
+        };
+
+        //------------------------------------------------------------------
+        // 간단한 JSON 출력 (쉼표 / 들여쓰기만 관리)
+        //------------------------------------------------------------------
+        class MJsonWriter
+        {
+        public:
+            explicit MJsonWriter(FILE* inFile) : File(inFile) {}
+
+            void BeginObject(const char* inKey = nullptr) {
+                Begin(inKey, '{');
+            }
+
+            void EndObject() {
+                End('}');
+            }
+
+            void BeginArray(const char* inKey = nullptr) {
+                Begin(inKey, '[');
+            }
+
+            void EndArray() {
+                End(']');
+            }
+
+            void Write(const char* inKey, const char* inValue)
+            {
+                WriteKey(inKey);
+                fprintf(File, "\"%s\"", inValue);
+            }
+
+            void Write(const char* inKey, double inValue)
+            {
+                WriteKey(inKey);
+                fprintf(File, "%.6g", std::isfinite(inValue) ? inValue : 0.0);
+            }
+
+            void Write(const char* inKey, MINT64 inValue)
+            {
+                WriteKey(inKey);
+                fprintf(File, "%lld", static_cast<long long>(inValue));
+            }
+
+        protected:
+            void Begin(const char* inKey, char inBracket)
+            {
+                WriteKey(inKey);
+                fputc(inBracket, File);
+                IsFirstList.push_back(MTRUE);
+            }
+
+            void End(char inBracket)
+            {
+                IsFirstList.pop_back();
+                NewLine();
+                fputc(inBracket, File);
+
+                if (MTRUE == IsFirstList.empty()) {
+                    fputc('\n', File);
+                }
+            }
+
+            void WriteKey(const char* inKey)
+            {
+                if (MTRUE == IsFirstList.empty()) {
+                    return;
+                }
+
+                if (MFALSE == IsFirstList.back()) {
+                    fputc(',', File);
+                }
+                IsFirstList.back() = MFALSE;
+
+                NewLine();
+                if (nullptr != inKey) {
+                    fprintf(File, "\"%s\": ", inKey);
+                }
+            }
+
+            void NewLine()
+            {
+                fputc('\n', File);
+                for (size_t i = 0; i < IsFirstList.size(); ++i) {
+                    fputs("  ", File);
+                }
+            }
+
+        protected:
+            FILE* File = nullptr;
+
+            // 단계별로 아직 값을 쓰지 않았는지
+            std::vector<MBOOL> IsFirstList;
+        };
+
+        //------------------------------------------------------------------
+        // 측정값 목록의 통계
+        //------------------------------------------------------------------
+        struct MSampleStat
+        {
+        public:
+            double Mean = 0;
+            double P50 = 0;
+            double P90 = 0;
+            double P99 = 0;
+            double Max = 0;
+        };
+
+        MSampleStat GetSampleStat(std::vector<double> inSampleList)
+        {
+            MSampleStat stat;
+            if (MTRUE == inSampleList.empty()) {
+                return stat;
+            }
+
+            std::sort(inSampleList.begin(), inSampleList.end());
+
+            const size_t count = inSampleList.size();
+            auto GetPercentile = [&](double inRate) {
+                return inSampleList[std::min(count - 1, static_cast<size_t>(inRate * count))];
+            };
+
+            double total = 0;
+            for (const double sample : inSampleList) {
+                total += sample;
+            }
+
+            stat.Mean = total / count;
+            stat.P50 = GetPercentile(0.5);
+            stat.P90 = GetPercentile(0.9);
+            stat.P99 = GetPercentile(0.99);
+            stat.Max = inSampleList.back();
+
+            return stat;
+        }
+
+        void WriteSampleStat(MJsonWriter& inWriter, const char* inKey, const std::vector<double>& inSampleList)
+        {
+            const MSampleStat stat = GetSampleStat(inSampleList);
+
+            inWriter.BeginObject(inKey);
+            inWriter.Write("mean", stat.Mean);
+            inWriter.Write("p50", stat.P50);
+            inWriter.Write("p90", stat.P90);
+            inWriter.Write("p99", stat.P99);
+            inWriter.Write("max", stat.Max);
+            inWriter.EndObject();
+        }
+
+        double GetElapsedMicro(const MClock::time_point& inStart)
+        {
+            return std::chrono::duration<double, std::micro>(MClock::now() - inStart).count();
+        }
+
+        //------------------------------------------------------------------
+        // 검색 통계 합 / 문제당 평균 출력
+        //------------------------------------------------------------------
+        void AddStats(MSearchStats& outTotal, const MSearchStats& inStats)
+        {
+            outTotal.ExpandCount += inStats.ExpandCount;
+            outTotal.MaxOpenCount += inStats.MaxOpenCount;
+            outTotal.HeapPushCount += inStats.HeapPushCount;
+            outTotal.HeapPopCount += inStats.HeapPopCount;
+            outTotal.HeapUpdateCount += inStats.HeapUpdateCount;
+            outTotal.BlockLineCount += inStats.BlockLineCount;
+            outTotal.CheckOBBCount += inStats.CheckOBBCount;
+            outTotal.SmoothCount += inStats.SmoothCount;
+            outTotal.SearchTime += inStats.SearchTime;
+            outTotal.SmoothTime += inStats.SmoothTime;
+            outTotal.TotalTime += inStats.TotalTime;
+        }
+
+        void WriteStats(MJsonWriter& inWriter, const MSearchStats& inTotal, MINT32 inQueryCount)
+        {
+            const double count = inQueryCount;
+
+            inWriter.BeginObject("stats_mean");
+            inWriter.Write("expanded", inTotal.ExpandCount / count);
+            inWriter.Write("max_open", inTotal.MaxOpenCount / count);
+            inWriter.Write("heap_push", inTotal.HeapPushCount / count);
+            inWriter.Write("heap_pop", inTotal.HeapPopCount / count);
+            inWriter.Write("heap_update", inTotal.HeapUpdateCount / count);
+            inWriter.Write("block_line", inTotal.BlockLineCount / count);
+            inWriter.Write("check_obb", inTotal.CheckOBBCount / count);
+            inWriter.Write("smooth", inTotal.SmoothCount / count);
+            inWriter.Write("search_us", inTotal.SearchTime / count);
+            inWriter.Write("smooth_us", inTotal.SmoothTime / count);
+            inWriter.Write("total_us", inTotal.TotalTime / count);
+            inWriter.EndObject();
+        }
+
+        //------------------------------------------------------------------
+        // 경로 길이 (타일 단위 직선 거리 합)
+        //------------------------------------------------------------------
+        template<typename POINT, typename FUNC>
+        double GetPathLength(const std::vector<POINT>& inList, const FUNC& inGetPosition)
+        {
+            double length = 0;
+            for (size_t i = 1; i < inList.size(); ++i)
+            {
+                const double x = inGetPosition(inList[i]).X - inGetPosition(inList[i - 1]).X;
+                const double y = inGetPosition(inList[i]).Y - inGetPosition(inList[i - 1]).Y;
+                length += sqrt((x * x) + (y * y));
+            }
+
+            return length;
+        }
+
+        double GetIndexPathLength(const std::vector<MIntPoint>& inList)
+        {
+            return GetPathLength(inList, [](const MIntPoint& inPoint) { return MVector2(static_cast<MFLOAT>(inPoint.X), static_cast<MFLOAT>(inPoint.Y)); });
+        }
+
+        double GetWorldPathLength(const std::vector<MVector2>& inList, const MVector2& inStartPos)
+        {
+            // 2D경로는 시작 위치가 빠져있다
+            double length = GetPathLength(inList, [](const MVector2& inPos) { return inPos; });
+            if (MFALSE == inList.empty())
+            {
+                const double x = inList.front().X - inStartPos.X;
+                const double y = inList.front().Y - inStartPos.Y;
+                length += sqrt((x * x) + (y * y));
+            }
+
+            return length / BenchmarkTileSize;
+        }
+
+        MVector2 GetTileCenterPos(const MIntPoint& inIndex2D)
+        {
+            return MVector2((inIndex2D.X + 0.5f) * BenchmarkTileSize, (inIndex2D.Y + 0.5f) * BenchmarkTileSize);
+        }
+
+        //------------------------------------------------------------------
+        // 검색 방식 하나의 측정값
+        //------------------------------------------------------------------
+        struct MEngineResult
+        {
+        public:
+            // 문제별 지연 시간 / 확장한 노드 수 (확장 수를 알 수 없는 방식은 비어있다) / 최단 경로 대비 길이
+            std::vector<double> LatencyList;
+            std::vector<double> ExpandList;
+            std::vector<double> RatioList;
+
+            MUINT64 AllocCount = 0;
+            MUINT64 AllocSize = 0;
+            MINT32 SolveCount = 0;
+        };
+
+        // 문제 하나를 측정 (inFunc는 찾은 경로 길이를 리턴, 찾지 못했다면 음수)
+        template<typename FUNC>
+        double MeasureQuery(MEngineResult& outResult, const FUNC& inFunc)
+        {
+            const MUINT64 prevAllocCount = GetAllocCount();
+            const MUINT64 prevAllocSize = GetAllocSize();
+            const MClock::time_point start = MClock::now();
+
+            const double length = inFunc();
+
+            outResult.LatencyList.push_back(GetElapsedMicro(start));
+            outResult.AllocCount += GetAllocCount() - prevAllocCount;
+            outResult.AllocSize += GetAllocSize() - prevAllocSize;
+
+            return length;
+        }
+
+        //------------------------------------------------------------------
+        // 흐름 필드를 따라간 경로 길이 (도착하지 못했다면 음수)
+        //------------------------------------------------------------------
+        double GetFlowFieldPathLength(const MFlowField& inFlowField, const MIntPoint& inStartIndex2D, const MIntPoint& inEndIndex2D, MINT32 inMaxStepCount)
+        {
+            MIntPoint index2D = inStartIndex2D;
+
+            MINT32 stepCount = 0;
+            for (; stepCount < inMaxStepCount && MFALSE == (index2D == inEndIndex2D); ++stepCount)
+            {
+                if (MFALSE == inFlowField.GetNextIndex2D(index2D, index2D)) {
+                    return -1.0;
+                }
+            }
+
+            return (index2D == inEndIndex2D) ? stepCount : -1.0;
+        }
+
+        //------------------------------------------------------------------
+        // 시나리오 하나를 모든 검색 방식으로 측정
+        //------------------------------------------------------------------
+        class MScenarioRunner
+        {
+        public:
+            explicit MScenarioRunner(const MBenchmarkScenario& inScenario) : Scenario(inScenario)
+            {
+                BitGrid.Build(&Scenario.Grid);
+                LandmarkMap.Build(&Scenario.Grid, BenchmarkLandmarkCount);
+
+                BuildReferenceLength();
+            }
+
+            void Run(MJsonWriter& inWriter)
+            {
+                for (const MBenchmarkEngine engine : EngineList) {
+                    RunEngine(inWriter, engine);
+                }
+
+                RunHierarchical(inWriter);
+                RunFlowField(inWriter, 1);
+                RunFlowField(inWriter, FlowFieldThreadCount);
+                RunDStarLite(inWriter);
+                RunIncremental(inWriter);
+            }
+
+        protected:
+            //------------------------------------------------------------------
+            // 이동 방식별 최단 경로 길이
+            // 시나리오의 최단 경로 길이는 대각선 (모서리 통과 불가) 이동 기준이므로 그 방식에만 사용하고
+            // 나머지는 같은 이동 방식의 A*로 계산한다 (직선 이동은 대각선 최단 경로를 그대로 사용)
+            //------------------------------------------------------------------
+            void BuildReferenceLength()
+            {
+                const std::pair<MMovementModel, MNeighborMode> modelList[] = {
+                    { MMovementModel::Four, MNeighborMode::Four },
+                    { MMovementModel::Eight, MNeighborMode::Eight },
+                    { MMovementModel::EightCornerCut, MNeighborMode::EightCornerCut },
+                };
+
+                std::vector<MIntPoint> pathList;
+                for (const auto& model : modelList)
+                {
+                    MPathFinder pathFinder;
+                    pathFinder.SetNeighborMode(model.second);
+
+                    std::vector<double>& lengthList = ReferenceLengthList[static_cast<size_t>(model.first)];
+                    for (const MBenchmarkQuery& query : Scenario.QueryList)
+                    {
+                        if (MMovementModel::Eight == model.first && 0 <= query.OptimalLength)
+                        {
+                            lengthList.push_back(query.OptimalLength);
+                            continue;
+                        }
+
+                        pathFinder.FindPath(pathList, &Scenario.Grid, query.StartIndex2D, query.EndIndex2D);
+                        lengthList.push_back(GetIndexPathLength(pathList));
+                    }
+                }
+
+                ReferenceLengthList[static_cast<size_t>(MMovementModel::AnyAngle)] = ReferenceLengthList[static_cast<size_t>(MMovementModel::Eight)];
+            }
+
+            void SetupPathFinder(MPathFinder& inPathFinder, MBenchmarkEngine inEngine)
+            {
+                switch (inEngine)
+                {
+                case MBenchmarkEngine::AStar8:
+                case MBenchmarkEngine::Bidirectional8:
+                    inPathFinder.SetNeighborMode(MNeighborMode::Eight);
+                    break;
+
+                case MBenchmarkEngine::AStar8CornerCut:
+                    inPathFinder.SetNeighborMode(MNeighborMode::EightCornerCut);
+                    break;
+
+                case MBenchmarkEngine::JumpPoint:
+                    inPathFinder.SetPathEngine(MPathEngine::JumpPoint);
+                    break;
+
+                case MBenchmarkEngine::Landmark4:
+                    inPathFinder.SetLandmarkMap(&LandmarkMap);
+                    break;
+
+                case MBenchmarkEngine::ThetaStarWorld:
+                    inPathFinder.SetPathEngine(MPathEngine::ThetaStar);
+                    break;
+
+                default:
+                    break;
+                }
+
+                if (MBenchmarkEngine::Bidirectional4 == inEngine || MBenchmarkEngine::Bidirectional8 == inEngine) {
+                    inPathFinder.SetBidirectional(MTRUE);
+                }
+            }
+
+            // 문제 하나 검색 (찾은 경로 길이를 리턴, 찾지 못했다면 음수)
+            double RunQuery(MPathFinder& inPathFinder, MBenchmarkEngine inEngine, const MBenchmarkQuery& inQuery)
+            {
+                if (MBenchmarkEngine::AStarWorld == inEngine || MBenchmarkEngine::ThetaStarWorld == inEngine)
+                {
+                    const MVector2 startPos = GetTileCenterPos(inQuery.StartIndex2D);
+                    const MVector2 endPos = GetTileCenterPos(inQuery.EndIndex2D);
+
+                    inPathFinder.FindPath(PositionList, MVector2(0, 0), BenchmarkTileSize, &Scenario.Grid, startPos, endPos, BenchmarkRadius);
+                    return (MTRUE == PositionList.empty()) ? -1.0 : GetWorldPathLength(PositionList, startPos);
+                }
+
+                if (MBenchmarkEngine::BitGrid4 == inEngine) {
+                    inPathFinder.FindPath(IndexList, &BitGrid, inQuery.StartIndex2D, inQuery.EndIndex2D);
+                }
+                else {
+                    inPathFinder.FindPath(IndexList, &Scenario.Grid, inQuery.StartIndex2D, inQuery.EndIndex2D);
+                }
+
+                return (MTRUE == IndexList.empty()) ? -1.0 : GetIndexPathLength(IndexList);
+            }
+
+            // 문제 하나를 호출자 버퍼로 검색 (경로 수를 리턴)
+            MINT32 RunBufferQuery(MPathFinder& inPathFinder, MBenchmarkEngine inEngine, const MBenchmarkQuery& inQuery)
+            {
+                const MINT32 capacity = static_cast<MINT32>(IndexBuffer.size());
+
+                if (MBenchmarkEngine::AStarWorld == inEngine || MBenchmarkEngine::ThetaStarWorld == inEngine) {
+                    return inPathFinder.FindPath(PositionBuffer.data(), capacity, MVector2(0, 0), BenchmarkTileSize, &Scenario.Grid, GetTileCenterPos(inQuery.StartIndex2D), GetTileCenterPos(inQuery.EndIndex2D), BenchmarkRadius);
+                }
+
+                if (MBenchmarkEngine::BitGrid4 == inEngine) {
+                    return inPathFinder.FindPath(IndexBuffer.data(), capacity, &BitGrid, inQuery.StartIndex2D, inQuery.EndIndex2D);
+                }
+
+                return inPathFinder.FindPath(IndexBuffer.data(), capacity, &Scenario.Grid, inQuery.StartIndex2D, inQuery.EndIndex2D);
+            }
+
+            //------------------------------------------------------------------
+            // 모든 문제를 한번씩 검색한 뒤에 다시 검색하면 메모리를 할당하지 않아야 한다
+            // 양방향 검색은 스레드를 만들 수 있으므로 할당 수는 참고용
+            //------------------------------------------------------------------
+            MUINT64 RunSteadyState(MPathFinder& inPathFinder, MBenchmarkEngine inEngine)
+            {
+                const size_t tileCount = Scenario.Grid.TileList.size();
+                IndexBuffer.resize(tileCount);
+                PositionBuffer.resize(tileCount);
+
+                for (const MBenchmarkQuery& query : Scenario.QueryList) {
+                    RunBufferQuery(inPathFinder, inEngine, query);
+                }
+
+                const MUINT64 prevAllocCount = GetAllocCount();
+                for (const MBenchmarkQuery& query : Scenario.QueryList) {
+                    RunBufferQuery(inPathFinder, inEngine, query);
+                }
+
+                return GetAllocCount() - prevAllocCount;
+            }
+
+            void RunEngine(MJsonWriter& inWriter, MBenchmarkEngine inEngine)
+            {
+                MPathFinder pathFinder;
+                SetupPathFinder(pathFinder, inEngine);
+
+                const MINT32 queryCount = static_cast<MINT32>(Scenario.QueryList.size());
+                const MMovementModel model = GetMovementModel(inEngine);
+
+                // 임시 메모리를 미리 할당
+                for (MINT32 i = 0; i < std::min(queryCount, WarmupQueryCount); ++i) {
+                    RunQuery(pathFinder, inEngine, Scenario.QueryList[i]);
+                }
+
+                MEngineResult result;
+
+                // 검색 통계 합
+                MSearchStats totalStats;
+
+                for (MINT32 i = 0; i < queryCount; ++i)
+                {
+                    const double length = MeasureQuery(result, [&]() { return RunQuery(pathFinder, inEngine, Scenario.QueryList[i]); });
+
+                    result.ExpandList.push_back(pathFinder.GetExpandCount());
+                    AddStats(totalStats, pathFinder.GetSearchStats());
+
+                    AddLength(result, model, i, length);
+                }
+
+                const MUINT64 steadyAllocCount = RunSteadyState(pathFinder, inEngine);
+                if (0 < steadyAllocCount) {
+                    fprintf(stderr, "warning : %s %s allocated %llu times in steady state\n", Scenario.Name.c_str(), GetEngineName(inEngine), static_cast<unsigned long long>(steadyAllocCount));
+                }
+
+                WriteResult(inWriter, GetEngineName(inEngine), model, result);
+                inWriter.Write("steady_state_allocs", static_cast<MINT64>(steadyAllocCount));
+
+                if (MTRUE == MSearchStatsPolicy::IsEnable && 0 < queryCount) {
+                    WriteStats(inWriter, totalStats, queryCount);
+                }
+                inWriter.EndObject();
+            }
+
+            //------------------------------------------------------------------
+            // HPA* (그래프 생성 시간은 따로 출력하고 검색만 측정)
+            //------------------------------------------------------------------
+            void RunHierarchical(MJsonWriter& inWriter)
+            {
+                const MClusterGraphConfig config;
+
+                const MClock::time_point buildStart = MClock::now();
+                MClusterGraph graph;
+                graph.Build(&Scenario.Grid, config);
+                const double buildTime = GetElapsedMicro(buildStart);
+
+                MHierarchicalPathFinder pathFinder(&graph);
+
+                auto RunHierarchicalQuery = [&](const MBenchmarkQuery& inQuery)
+                {
+                    pathFinder.FindPath(IndexList, inQuery.StartIndex2D, inQuery.EndIndex2D);
+                    return (MTRUE == IndexList.empty()) ? -1.0 : GetIndexPathLength(IndexList);
+                };
+
+                const MINT32 queryCount = static_cast<MINT32>(Scenario.QueryList.size());
+                for (MINT32 i = 0; i < std::min(queryCount, WarmupQueryCount); ++i) {
+                    RunHierarchicalQuery(Scenario.QueryList[i]);
+                }
+
+                MEngineResult result;
+                for (MINT32 i = 0; i < queryCount; ++i)
+                {
+                    const double length = MeasureQuery(result, [&]() { return RunHierarchicalQuery(Scenario.QueryList[i]); });
+                    AddLength(result, MMovementModel::Four, i, length);
+                }
+
+                WriteResult(inWriter, "hpa4", MMovementModel::Four, result);
+                inWriter.Write("cluster_size", static_cast<MINT64>(config.ClusterSize));
+                inWriter.Write("max_transition_gap", static_cast<MINT64>(config.MaxTransitionGap));
+                inWriter.Write("abstract_nodes", static_cast<MINT64>(graph.GetNodeCount()));
+                inWriter.Write("build_us", buildTime);
+                inWriter.EndObject();
+            }
+
+            //------------------------------------------------------------------
+            // 흐름 필드 (문제마다 종료 위치로 필드를 만들고 시작 위치에서 따라간다)
+            //------------------------------------------------------------------
+            void RunFlowField(MJsonWriter& inWriter, MINT32 inThreadCount)
+            {
+                MFlowField flowField;
+                flowField.SetThreadCount(inThreadCount);
+
+                const MINT32 maxStepCount = static_cast<MINT32>(Scenario.Grid.TileList.size());
+
+                auto RunFlowFieldQuery = [&](const MBenchmarkQuery& inQuery)
+                {
+                    flowField.Build(&Scenario.Grid, inQuery.EndIndex2D);
+                    return GetFlowFieldPathLength(flowField, inQuery.StartIndex2D, inQuery.EndIndex2D, maxStepCount);
+                };
+
+                const MINT32 queryCount = static_cast<MINT32>(Scenario.QueryList.size());
+                for (MINT32 i = 0; i < std::min(queryCount, WarmupQueryCount); ++i) {
+                    RunFlowFieldQuery(Scenario.QueryList[i]);
+                }
+
+                MEngineResult result;
+                for (MINT32 i = 0; i < queryCount; ++i)
+                {
+                    const double length = MeasureQuery(result, [&]() { return RunFlowFieldQuery(Scenario.QueryList[i]); });
+                    AddLength(result, MMovementModel::Four, i, length);
+                }
+
+                WriteResult(inWriter, (1 < inThreadCount) ? "flowfield4_thread" : "flowfield4", MMovementModel::Four, result);
+                inWriter.Write("threads", static_cast<MINT64>(inThreadCount));
+                inWriter.EndObject();
+            }
+
+            //------------------------------------------------------------------
+            // D* Lite 첫 검색 (타일 변경 후 재계획은 RunReplanning에서 측정)
+            //------------------------------------------------------------------
+            void RunDStarLite(MJsonWriter& inWriter)
+            {
+                MDStarLitePlanner planner;
+
+                auto RunDStarLiteQuery = [&](const MBenchmarkQuery& inQuery)
+                {
+                    if (MFALSE == planner.Initialize(&Scenario.Grid, inQuery.StartIndex2D, inQuery.EndIndex2D)) {
+                        return -1.0;
+                    }
+
+                    planner.FindPath(IndexList);
+                    return (MTRUE == IndexList.empty()) ? -1.0 : GetIndexPathLength(IndexList);
+                };
+
+                const MINT32 queryCount = static_cast<MINT32>(Scenario.QueryList.size());
+                for (MINT32 i = 0; i < std::min(queryCount, WarmupQueryCount); ++i) {
+                    RunDStarLiteQuery(Scenario.QueryList[i]);
+                }
+
+                MEngineResult result;
+                for (MINT32 i = 0; i < queryCount; ++i)
+                {
+                    const double length = MeasureQuery(result, [&]() { return RunDStarLiteQuery(Scenario.QueryList[i]); });
+
+                    result.ExpandList.push_back(planner.GetLastExpandCount());
+                    AddLength(result, MMovementModel::Four, i, length);
+                }
+
+                WriteResult(inWriter, "dstarlite4", MMovementModel::Four, result);
+                inWriter.EndObject();
+            }
+
+            //------------------------------------------------------------------
+            // ARA* (MPathSearch를 끝날때까지 Step, 첫 경로까지의 시간 / 길이도 출력)
+            //------------------------------------------------------------------
+            void RunIncremental(MJsonWriter& inWriter)
+            {
+                MPathSearch search;
+
+                std::vector<double> firstLatencyList;
+                std::vector<double> firstRatioList;
+
+                auto RunIncrementalQuery = [&](const MBenchmarkQuery& inQuery, MINT32 inQueryIndex)
+                {
+                    const MClock::time_point start = MClock::now();
+                    search.Begin(&Scenario.Grid, inQuery.StartIndex2D, inQuery.EndIndex2D, IncrementalWeight, IncrementalWeightStep);
+
+                    MBOOL isFirstPath = MFALSE;
+                    while (MFALSE == search.IsFinished())
+                    {
+                        const MPathSearchState state = search.Step(IncrementalStepExpandCount);
+                        if (MTRUE == isFirstPath || (MPathSearchState::Improving != state && MPathSearchState::Done != state)) {
+                            continue;
+                        }
+
+                        isFirstPath = MTRUE;
+                        if (0 <= inQueryIndex && MTRUE == search.GetPath(IndexList))
+                        {
+                            firstLatencyList.push_back(GetElapsedMicro(start));
+
+                            const double referenceLength = ReferenceLengthList[static_cast<size_t>(MMovementModel::Four)][inQueryIndex];
+                            if (0 < referenceLength) {
+                                firstRatioList.push_back(GetIndexPathLength(IndexList) / referenceLength);
+                            }
+                        }
+                    }
+
+                    return (MFALSE == search.GetPath(IndexList)) ? -1.0 : GetIndexPathLength(IndexList);
+                };
+
+                const MINT32 queryCount = static_cast<MINT32>(Scenario.QueryList.size());
+                for (MINT32 i = 0; i < std::min(queryCount, WarmupQueryCount); ++i) {
+                    RunIncrementalQuery(Scenario.QueryList[i], -1);
+                }
+
+                MEngineResult result;
+                for (MINT32 i = 0; i < queryCount; ++i)
+                {
+                    const double length = MeasureQuery(result, [&]() { return RunIncrementalQuery(Scenario.QueryList[i], i); });
+
+                    result.ExpandList.push_back(search.GetExpandCount());
+                    AddLength(result, MMovementModel::Four, i, length);
+                }
+
+                WriteResult(inWriter, "ara4", MMovementModel::Four, result);
+                inWriter.Write("weight", static_cast<double>(IncrementalWeight));
+                WriteSampleStat(inWriter, "first_path_us", firstLatencyList);
+                WriteSampleStat(inWriter, "first_path_ratio", firstRatioList);
+                inWriter.EndObject();
+            }
+
+            //------------------------------------------------------------------
+            // 측정값 정리 / 출력
+            //------------------------------------------------------------------
+            // 찾은 경로 길이를 같은 이동 방식의 최단 경로와 비교 (찾지 못했다면 음수)
+            void AddLength(MEngineResult& outResult, MMovementModel inModel, MINT32 inQueryIndex, double inLength) const
+            {
+                if (inLength < 0) {
+                    return;
+                }
+
+                ++outResult.SolveCount;
+
+                const double referenceLength = ReferenceLengthList[static_cast<size_t>(inModel)][inQueryIndex];
+                if (0 < referenceLength) {
+                    outResult.RatioList.push_back(inLength / referenceLength);
+                }
+            }
+
+            // 공통 항목을 출력 (검색 방식별 항목을 더 쓸 수 있도록 오브젝트는 열어둔다)
+            void WriteResult(MJsonWriter& inWriter, const char* inEngineName, MMovementModel inModel, const MEngineResult& inResult) const
+            {
+                const MINT32 queryCount = static_cast<MINT32>(Scenario.QueryList.size());
+
+                inWriter.BeginObject();
+                inWriter.Write("scenario", Scenario.Name.c_str());
+                inWriter.Write("width", static_cast<MINT64>(Scenario.Grid.TileCount.X));
+                inWriter.Write("height", static_cast<MINT64>(Scenario.Grid.TileCount.Y));
+                inWriter.Write("engine", inEngineName);
+                inWriter.Write("movement_model", GetMovementModelName(inModel));
+                inWriter.Write("queries", static_cast<MINT64>(queryCount));
+                inWriter.Write("solved", static_cast<MINT64>(inResult.SolveCount));
+                WriteSampleStat(inWriter, "latency_us", inResult.LatencyList);
+
+                if (MFALSE == inResult.ExpandList.empty()) {
+                    WriteSampleStat(inWriter, "expanded", inResult.ExpandList);
+                }
+
+                inWriter.Write("allocs_per_query", (0 < queryCount) ? static_cast<double>(inResult.AllocCount) / queryCount : 0.0);
+                inWriter.Write("alloc_bytes_per_query", (0 < queryCount) ? static_cast<double>(inResult.AllocSize) / queryCount : 0.0);
+                WriteSampleStat(inWriter, "optimality_ratio", inResult.RatioList);
+
+                fprintf(stderr, "%-12s %4dx%-4d %-18s p50 %9.1fus p99 %9.1fus\n", Scenario.Name.c_str(), Scenario.Grid.TileCount.X, Scenario.Grid.TileCount.Y,
+                    inEngineName, GetSampleStat(inResult.LatencyList).P50, GetSampleStat(inResult.LatencyList).P99);
+            }
+
+        protected:
+            const MBenchmarkScenario& Scenario;
+
+            MBitGrid BitGrid;
+            MLandmarkMap LandmarkMap;
+
+            // 이동 방식별 / 문제별 최단 경로 길이
+            std::vector<double> ReferenceLengthList[static_cast<size_t>(MMovementModel::Count)];
+
+            // 결과 경로 (검색마다 재사용)
+            std::vector<MIntPoint> IndexList;
+            std::vector<MVector2> PositionList;
+
+            // 호출자 버퍼 (타일 수만큼 할당)
+            std::vector<MIntPoint> IndexBuffer;
+            std::vector<MVector2> PositionBuffer;
+        };
+
+        //------------------------------------------------------------------
+        // 경로 직선 체크 (CheckBlockLine)
+        //------------------------------------------------------------------
+        void RunBlockLine(MJsonWriter& inWriter, const MBenchmarkScenario& inScenario, MUINT32 inSeed)
+        {
+            MBenchmarkPathFinder pathFinder;
+            std::mt19937 random(inSeed);
+
+            std::vector<double> latencyList;
+            MINT32 blockCount = 0;
+
+            for (const MBenchmarkQuery& query : inScenario.QueryList)
+            {
+                // 가까운 거리에서 시야가 막히지 않는 경우도 포함되도록 종료 위치를 가깝게 당긴다
+                const MFLOAT rate = std::uniform_real_distribution<MFLOAT>(0.05f, 1.0f)(random);
+                const MVector2 startPos = GetTileCenterPos(query.StartIndex2D);
+                const MVector2 endPos = startPos + ((GetTileCenterPos(query.EndIndex2D) - startPos) * rate);
+
+                const MClock::time_point start = MClock::now();
+                blockCount += (MTRUE == pathFinder.CheckBlockLine(MVector2(0, 0), BenchmarkTileSize, &inScenario.Grid, startPos, endPos, BenchmarkRadius)) ? 1 : 0;
+                latencyList.push_back(GetElapsedMicro(start));
+            }
+
+            inWriter.BeginObject();
+            inWriter.Write("scenario", inScenario.Name.c_str());
+            inWriter.Write("width", static_cast<MINT64>(inScenario.Grid.TileCount.X));
+            inWriter.Write("height", static_cast<MINT64>(inScenario.Grid.TileCount.Y));
+            inWriter.Write("lines", static_cast<MINT64>(inScenario.QueryList.size()));
+            inWriter.Write("blocked", static_cast<MINT64>(blockCount));
+            WriteSampleStat(inWriter, "latency_us", latencyList);
+            inWriter.EndObject();
+        }
+
+        //------------------------------------------------------------------
+        // D* Lite 재계획
+        // 에이전트가 경로를 따라 이동하면서 일정 간격마다 주변 타일의 막힘을 무작위로 바꾸고
+        // D* Lite 재계획과 현재 위치에서 처음부터 하는 A* 검색을 같은 그리드에서 비교한다
+        //------------------------------------------------------------------
+        void RunReplanning(MJsonWriter& inWriter, const MBenchmarkScenario& inScenario, MUINT32 inSeed)
+        {
+            MGrid grid = inScenario.Grid;
+            std::mt19937 random(inSeed);
+
+            MDStarLitePlanner planner;
+            MPathFinder pathFinder;
+
+            std::vector<MIntPoint> pathList;
+            std::vector<MIntPoint> searchPathList;
+            std::vector<MIntPoint> changedList;
+
+            std::vector<double> replanLatencyList;
+            std::vector<double> replanExpandList;
+            std::vector<double> searchLatencyList;
+            std::vector<double> searchExpandList;
+
+            // 처음부터 검색한 경로와 길이가 다른 재계획 수 / 종료 위치에 도착한 수
+            MINT32 mismatchCount = 0;
+            MINT32 arriveCount = 0;
+
+            const MINT32 queryCount = std::min(static_cast<MINT32>(inScenario.QueryList.size()), ReplanQueryCount);
+            for (MINT32 i = 0; i < queryCount; ++i)
+            {
+                const MBenchmarkQuery& query = inScenario.QueryList[i];
+
+                // 이전 문제에서 바꾼 타일은 되돌린다
+                grid.TileList = inScenario.Grid.TileList;
+
+                if (MFALSE == planner.Initialize(&grid, query.StartIndex2D, query.EndIndex2D)) {
+                    continue;
+                }
+
+                planner.FindPath(pathList);
+
+                MIntPoint index2D = query.StartIndex2D;
+                MINT32 stepCount = 0;
+
+                for (size_t pathIndex = 1; pathIndex < pathList.size(); ++pathIndex)
+                {
+                    index2D = pathList[pathIndex];
+                    if (index2D == query.EndIndex2D || 0 != (++stepCount % ReplanStepInterval)) {
+                        continue;
+                    }
+
+                    // 에이전트 주변 타일의 막힘을 바꾼다 (현재 / 종료 위치 제외)
+                    changedList.clear();
+                    for (MINT32 k = 0; k < ReplanToggleCount; ++k)
+                    {
+                        const MIntPoint toggleIndex2D(index2D.X + static_cast<MINT32>(random() % (2 * ReplanToggleRange + 1)) - ReplanToggleRange,
+                            index2D.Y + static_cast<MINT32>(random() % (2 * ReplanToggleRange + 1)) - ReplanToggleRange);
+
+                        if (nullptr == grid.GetTile(toggleIndex2D) || toggleIndex2D == index2D || toggleIndex2D == query.EndIndex2D) {
+                            continue;
+                        }
+
+                        MTile& tile = grid.TileList[grid.GetTileIndex(toggleIndex2D)];
+                        tile.IsBlocked = (MTRUE == tile.IsBlocked) ? MFALSE : MTRUE;
+                        changedList.push_back(toggleIndex2D);
+                    }
+
+                    MClock::time_point start = MClock::now();
+                    planner.SetStart(index2D);
+                    planner.UpdateTiles(changedList);
+                    planner.FindPath(pathList);
+                    replanLatencyList.push_back(GetElapsedMicro(start));
+                    replanExpandList.push_back(planner.GetLastExpandCount());
+
+                    start = MClock::now();
+                    pathFinder.FindPath(searchPathList, &grid, index2D, query.EndIndex2D);
+                    searchLatencyList.push_back(GetElapsedMicro(start));
+                    searchExpandList.push_back(pathFinder.GetExpandCount());
+
+                    if (pathList.size() != searchPathList.size()) {
+                        ++mismatchCount;
+                    }
+
+                    // 새 경로의 처음은 현재 위치
+                    pathIndex = 0;
+                }
+
+                if (index2D == query.EndIndex2D) {
+                    ++arriveCount;
+                }
+            }
+
+            inWriter.BeginObject();
+            inWriter.Write("scenario", inScenario.Name.c_str());
+            inWriter.Write("width", static_cast<MINT64>(inScenario.Grid.TileCount.X));
+            inWriter.Write("height", static_cast<MINT64>(inScenario.Grid.TileCount.Y));
+            inWriter.Write("queries", static_cast<MINT64>(queryCount));
+            inWriter.Write("arrived", static_cast<MINT64>(arriveCount));
+            inWriter.Write("replans", static_cast<MINT64>(replanLatencyList.size()));
+            inWriter.Write("mismatches", static_cast<MINT64>(mismatchCount));
+            WriteSampleStat(inWriter, "dstarlite_replan_us", replanLatencyList);
+            WriteSampleStat(inWriter, "dstarlite_expanded", replanExpandList);
+            WriteSampleStat(inWriter, "astar4_search_us", searchLatencyList);
+            WriteSampleStat(inWriter, "astar4_expanded", searchExpandList);
+            inWriter.EndObject();
+        }
+
+        //------------------------------------------------------------------
+        // ARA* 스케줄러 (모든 문제를 한번에 등록하고 빌 때까지 프레임 진행)
+        //------------------------------------------------------------------
+        void RunScheduler(MJsonWriter& inWriter, const MBenchmarkScenario& inScenario)
+        {
+            const MINT32 queryCount = static_cast<MINT32>(inScenario.QueryList.size());
+
+            std::vector<MPathSearch> searchList(queryCount);
+            MPathScheduler scheduler;
+            scheduler.SetExpandBudget(SchedulerExpandBudget);
+
+            for (MINT32 i = 0; i < queryCount; ++i)
+            {
+                const MBenchmarkQuery& query = inScenario.QueryList[i];
+
+                searchList[i].Begin(&inScenario.Grid, query.StartIndex2D, query.EndIndex2D, IncrementalWeight, IncrementalWeightStep);
+                scheduler.Add(&searchList[i]);
+            }
+
+            // 문제별 첫 경로를 찾은 / 끝난 프레임
+            std::vector<MINT32> firstFrameList(queryCount, -1);
+            std::vector<MINT32> doneFrameList(queryCount, -1);
+
+            std::vector<double> latencyList;
+            MINT32 frameCount = 0;
+
+            for (; 0 < scheduler.GetSearchCount() && frameCount < SchedulerMaxFrameCount; ++frameCount)
+            {
+                const MClock::time_point start = MClock::now();
+                scheduler.Update();
+                latencyList.push_back(GetElapsedMicro(start));
+
+                for (MINT32 i = 0; i < queryCount; ++i)
+                {
+                    const MPathSearchState state = searchList[i].GetState();
+                    if (firstFrameList[i] < 0 && (MPathSearchState::Improving == state || MPathSearchState::Done == state)) {
+                        firstFrameList[i] = frameCount;
+                    }
+
+                    if (doneFrameList[i] < 0 && MTRUE == searchList[i].IsFinished()) {
+                        doneFrameList[i] = frameCount;
+                    }
+                }
+            }
+
+            std::vector<double> firstFrameSampleList;
+            std::vector<double> doneFrameSampleList;
+            for (MINT32 i = 0; i < queryCount; ++i)
+            {
+                if (0 <= firstFrameList[i]) {
+                    firstFrameSampleList.push_back(firstFrameList[i] + 1);
+                }
+
+                if (0 <= doneFrameList[i]) {
+                    doneFrameSampleList.push_back(doneFrameList[i] + 1);
+                }
+            }
+
+            inWriter.BeginObject();
+            inWriter.Write("scenario", inScenario.Name.c_str());
+            inWriter.Write("width", static_cast<MINT64>(inScenario.Grid.TileCount.X));
+            inWriter.Write("height", static_cast<MINT64>(inScenario.Grid.TileCount.Y));
+            inWriter.Write("searches", static_cast<MINT64>(queryCount));
+            inWriter.Write("expand_budget", static_cast<MINT64>(SchedulerExpandBudget));
+            inWriter.Write("frames", static_cast<MINT64>(frameCount));
+            WriteSampleStat(inWriter, "frame_latency_us", latencyList);
+            WriteSampleStat(inWriter, "first_path_frames", firstFrameSampleList);
+            WriteSampleStat(inWriter, "done_frames", doneFrameSampleList);
+            inWriter.EndObject();
+        }
+
+        //------------------------------------------------------------------
+        // 도달할 수 없는 종료 위치 (연결 영역 정보 사용 / 미사용)
+        // 연결 영역 정보가 없으면 시작 위치의 연결 영역 전체를 확장한 뒤에 실패한다
+        //------------------------------------------------------------------
+        void RunUnreachable(MJsonWriter& inWriter, const MBenchmarkScenario& inScenario, MINT32 inQueryCount, MUINT32 inSeed)
+        {
+            std::vector<MBenchmarkQuery> queryList;
+            inScenario.GenerateUnreachableQueryList(inQueryCount, inSeed, queryList);
+
+            if (MTRUE == queryList.empty()) {
+                return;
+            }
+
+            const MClock::time_point buildStart = MClock::now();
+            MComponentMap componentMap;
+            componentMap.Build(&inScenario.Grid);
+            const double buildTime = GetElapsedMicro(buildStart);
+
+            std::vector<MIntPoint> pathList;
+
+            for (const MBOOL isUseComponent : { MFALSE, MTRUE })
+            {
+                MPathFinder pathFinder;
+                if (MTRUE == isUseComponent) {
+                    pathFinder.SetComponentMap(&componentMap);
+                }
+
+                std::vector<double> latencyList;
+                std::vector<double> expandList;
+                MINT32 solveCount = 0;
+
+                for (const MBenchmarkQuery& query : queryList)
+                {
+                    const MClock::time_point start = MClock::now();
+                    pathFinder.FindPath(pathList, &inScenario.Grid, query.StartIndex2D, query.EndIndex2D);
+                    latencyList.push_back(GetElapsedMicro(start));
+
+                    expandList.push_back(pathFinder.GetExpandCount());
+                    solveCount += (MFALSE == pathList.empty()) ? 1 : 0;
+                }
+
+                inWriter.BeginObject();
+                inWriter.Write("scenario", inScenario.Name.c_str());
+                inWriter.Write("width", static_cast<MINT64>(inScenario.Grid.TileCount.X));
+                inWriter.Write("height", static_cast<MINT64>(inScenario.Grid.TileCount.Y));
+                inWriter.Write("engine", (MTRUE == isUseComponent) ? "astar4_component" : "astar4");
+                inWriter.Write("queries", static_cast<MINT64>(queryList.size()));
+                inWriter.Write("solved", static_cast<MINT64>(solveCount));
+                WriteSampleStat(inWriter, "latency_us", latencyList);
+                WriteSampleStat(inWriter, "expanded", expandList);
+
+                if (MTRUE == isUseComponent) {
+                    inWriter.Write("component_build_us", buildTime);
+                }
+                inWriter.EndObject();
+            }
+        }
+
+        //------------------------------------------------------------------
+        // OBB 체크 (하나씩 / 묶어서)
+        //------------------------------------------------------------------
+        void RunCollision(MJsonWriter& inWriter, MUINT32 inSeed)
+        {
+            std::mt19937 random(inSeed);
+            std::uniform_real_distribution<MFLOAT> position(0.0f, 256.0f);
+            std::uniform_real_distribution<MFLOAT> angle(0.0f, 6.2831853f);
+            std::uniform_real_distribution<MFLOAT> extent(0.5f, 4.0f);
+
+            auto MakeBox = [&]()
+            {
+                const MFLOAT radian = angle(random);
+                const MVector2 axisRight(cosf(radian), sinf(radian));
+                const MVector2 axisUp(-axisRight.Y, axisRight.X);
+
+                return MCollision::MOBB2D(MVector2(position(random), position(random)), axisRight, axisUp, extent(random), extent(random));
+            };
+
+            std::vector<MCollision::MOBB2D> boxList;
+            MCollision::MBoxBatch boxBatch;
+
+            for (MINT32 i = 0; i < CollisionBoxCount; ++i)
+            {
+                boxList.push_back(MakeBox());
+                boxBatch.Add(boxList.back());
+            }
+
+            std::vector<MCollision::MOBB2D> queryList;
+            std::vector<MCollision::MBox2D> queryBoxList;
+            for (MINT32 i = 0; i < CollisionQueryCount; ++i)
+            {
+                queryList.push_back(MakeBox());
+                queryBoxList.push_back(queryList.back().GetBox());
+            }
+
+            const double checkCount = static_cast<double>(CollisionBoxCount) * CollisionQueryCount;
+            MINT64 hitCount = 0;
+
+            // 네 꼭지점 박스
+            MClock::time_point start = MClock::now();
+            for (const MCollision::MBox2D& query : queryBoxList)
+            {
+                for (const MCollision::MOBB2D& box : boxList) {
+                    hitCount += (MTRUE == MCollision::CheckOBB(box, query)) ? 1 : 0;
+                }
+            }
+            const double boxTime = GetElapsedMicro(start);
+
+            // 축 정규화가 된 박스
+            start = MClock::now();
+            for (const MCollision::MOBB2D& query : queryList)
+            {
+                for (const MCollision::MOBB2D& box : boxList) {
+                    hitCount += (MTRUE == MCollision::CheckOBB(query, box)) ? 1 : 0;
+                }
+            }
+            const double obbTime = GetElapsedMicro(start);
+
+            // 묶어서 체크
+            std::vector<MINT32> hitList;
+            start = MClock::now();
+            for (const MCollision::MOBB2D& query : queryList) {
+                hitCount += MCollision::CheckOBB_BatchList(query, boxBatch, hitList);
+            }
+            const double batchTime = GetElapsedMicro(start);
+
+            inWriter.BeginObject("collision");
+            inWriter.Write("checks", static_cast<MINT64>(checkCount));
+            inWriter.Write("hits", hitCount);
+            inWriter.Write("check_obb_box_ns", (boxTime * 1000.0) / checkCount);
+            inWriter.Write("check_obb_ns", (obbTime * 1000.0) / checkCount);
+            inWriter.Write("check_obb_batch_ns", (batchTime * 1000.0) / checkCount);
+            inWriter.EndObject();
+        }
+
+        //------------------------------------------------------------------
+        // 협동 경로 검색 (좁은 방 맵에 에이전트 수백개, 도착하면 새 목표)
+        //------------------------------------------------------------------
+        void RunCooperative(MJsonWriter& inWriter, MINT32 inAgentCount, MUINT32 inSeed)
+        {
+            MBenchmarkScenario scenario;
+            scenario.Generate(MBenchmarkMapType::Room, CooperativeMapSize, inSeed);
+
+            std::vector<MIntPoint> walkableList;
+            for (const MTile& tile : scenario.Grid.TileList)
+            {
+                if (MFALSE == tile.IsBlocked) {
+                    walkableList.push_back(tile.Index2D);
+                }
+            }
+
+            std::mt19937 random(inSeed);
+            std::shuffle(walkableList.begin(), walkableList.end(), random);
+
+            const MINT32 agentCount = std::min(inAgentCount, static_cast<MINT32>(walkableList.size()));
+
+            MCooperativePlanner planner;
+            planner.Reset(&scenario.Grid);
+
+            for (MINT32 i = 0; i < agentCount; ++i) {
+                planner.AddAgent(walkableList[i], walkableList[random() % walkableList.size()]);
+            }
+
+            std::vector<double> latencyList;
+            for (MINT32 tick = 0; tick < CooperativeTickCount; ++tick)
+            {
+                const MClock::time_point start = MClock::now();
+                planner.Update();
+                latencyList.push_back(GetElapsedMicro(start));
+
+                for (MINT32 i = 0; i < agentCount; ++i)
+                {
+                    if (MTRUE == planner.IsArrived(i)) {
+                        planner.SetGoal(i, walkableList[random() % walkableList.size()]);
+                    }
+                }
+            }
+
+            inWriter.BeginObject();
+            inWriter.Write("scenario", scenario.Name.c_str());
+            inWriter.Write("width", static_cast<MINT64>(scenario.Grid.TileCount.X));
+            inWriter.Write("height", static_cast<MINT64>(scenario.Grid.TileCount.Y));
+            inWriter.Write("agents", static_cast<MINT64>(agentCount));
+            inWriter.Write("ticks", static_cast<MINT64>(CooperativeTickCount));
+            inWriter.Write("arrivals", static_cast<MINT64>(planner.GetArriveCount()));
+            inWriter.Write("arrivals_per_100_ticks", (100.0 * planner.GetArriveCount()) / CooperativeTickCount);
+            inWriter.Write("moves", static_cast<MINT64>(planner.GetMoveCount()));
+            inWriter.Write("replans", static_cast<MINT64>(planner.GetReplanCount()));
+            inWriter.Write("failed_plans", static_cast<MINT64>(planner.GetFailedPlanCount()));
+            inWriter.Write("conflicts", static_cast<MINT64>(planner.GetConflictCount()));
+            inWriter.Write("expanded", static_cast<MINT64>(planner.GetExpandCount()));
+            WriteSampleStat(inWriter, "tick_latency_us", latencyList);
+            inWriter.EndObject();
+        }
+
+        //------------------------------------------------------------------
+        // 실행 인자
+        //------------------------------------------------------------------
+        struct MBenchmarkOption
+        {
+        public:
+            std::vector<MINT32> SizeList = { 128, 256, 512 };
+            MINT32 QueryCount = 200;
+            MUINT32 Seed = 1;
+
+            const char* MapPath = nullptr;
+            const char* ScenarioPath = nullptr;
+            const char* Label = "";
+            const char* OutPath = nullptr;
+        };
+
+        MBOOL ParseOption(MINT32 inArgCount, char** inArgList, MBenchmarkOption& outOption)
+        {
+            for (MINT32 i = 1; i < inArgCount; ++i)
+            {
+                const char* name = inArgList[i];
+                const char* value = (i + 1 < inArgCount) ? inArgList[i + 1] : nullptr;
+
+                if (nullptr == value) {
+                    return MFALSE;
+                }
+
+                if (0 == strcmp(name, "--sizes"))
+                {
+                    outOption.SizeList.clear();
+                    for (const char* text = value; nullptr != text; text = strchr(text, ','))
+                    {
+                        text += (',' == *text) ? 1 : 0;
+                        outOption.SizeList.push_back(atoi(text));
+                    }
+                }
+                else if (0 == strcmp(name, "--queries")) {
+                    outOption.QueryCount = atoi(value);
+                }
+                else if (0 == strcmp(name, "--seed")) {
+                    outOption.Seed = static_cast<MUINT32>(atoi(value));
+                }
+                else if (0 == strcmp(name, "--map")) {
+                    outOption.MapPath = value;
+                }
+                else if (0 == strcmp(name, "--scen")) {
+                    outOption.ScenarioPath = value;
+                }
+                else if (0 == strcmp(name, "--label")) {
+                    outOption.Label = value;
+                }
+                else if (0 == strcmp(name, "--out")) {
+                    outOption.OutPath = value;
+                }
+                else {
+                    return MFALSE;
+                }
+
+                ++i;
+            }
+
+            return MTRUE;
+        }
+    }
+};
+
+
+int main(int inArgCount, char** inArgList)
+{
+    using namespace MAstar;
+
+    MBenchmarkOption option;
+    if (MFALSE == ParseOption(inArgCount, inArgList, option))
+    {
+        fprintf(stderr, "usage : MBenchmark [--sizes 128,256,512] [--queries 200] [--seed 1] [--map a.map --scen a.map.scen] [--label name] [--out result.json]\n");
+        return 1;
+    }
+
+    //----------------------------------------------------------------
+    // 시나리오 준비
+    //----------------------------------------------------------------
+    std::vector<MBenchmarkScenario> scenarioList;
+
+    const MBenchmarkMapType mapTypeList[] = { MBenchmarkMapType::Random, MBenchmarkMapType::Maze, MBenchmarkMapType::Open, MBenchmarkMapType::Room };
+    for (const MINT32 size : option.SizeList)
+    {
+        for (const MBenchmarkMapType mapType : mapTypeList)
+        {
+            scenarioList.emplace_back();
+            scenarioList.back().Generate(mapType, size, option.Seed);
+            scenarioList.back().GenerateQueryList(option.QueryCount, option.Seed);
+        }
+    }
+
+    if (nullptr != option.MapPath)
+    {
+        MBenchmarkScenario scenario;
+        if (MFALSE == scenario.LoadMap(option.MapPath))
+        {
+            fprintf(stderr, "failed to load map : %s\n", option.MapPath);
+            return 1;
+        }
+
+        if (nullptr == option.ScenarioPath) {
+            scenario.GenerateQueryList(option.QueryCount, option.Seed);
+        }
+        else if (MFALSE == scenario.LoadScenario(option.ScenarioPath))
+        {
+            fprintf(stderr, "failed to load scenario : %s\n", option.ScenarioPath);
+            return 1;
+        }
+
+        scenarioList.push_back(scenario);
+    }
+
+    //----------------------------------------------------------------
+    // 측정 / 출력
+    //----------------------------------------------------------------
+    FILE* file = (nullptr != option.OutPath) ? fopen(option.OutPath, "w") : stdout;
+    if (nullptr == file)
+    {
+        fprintf(stderr, "failed to open : %s\n", option.OutPath);
+        return 1;
+    }
+
+    MJsonWriter writer(file);
+    writer.BeginObject();
+    writer.Write("label", option.Label);
+    writer.Write("seed", static_cast<MINT64>(option.Seed));
+
+    writer.BeginArray("pathfinding");
+    for (const MBenchmarkScenario& scenario : scenarioList) {
+        MScenarioRunner(scenario).Run(writer);
+    }
+    writer.EndArray();
+
+    writer.BeginArray("block_line");
+    for (const MBenchmarkScenario& scenario : scenarioList) {
+        RunBlockLine(writer, scenario, option.Seed);
+    }
+    writer.EndArray();
+
+    writer.BeginArray("replanning");
+    for (const MBenchmarkScenario& scenario : scenarioList) {
+        RunReplanning(writer, scenario, option.Seed);
+    }
+    writer.EndArray();
+
+    writer.BeginArray("scheduler");
+    for (const MBenchmarkScenario& scenario : scenarioList) {
+        RunScheduler(writer, scenario);
+    }
+    writer.EndArray();
+
+    writer.BeginArray("unreachable");
+    for (const MBenchmarkScenario& scenario : scenarioList) {
+        RunUnreachable(writer, scenario, option.QueryCount, option.Seed);
+    }
+    writer.EndArray();
+
+    RunCollision(writer, option.Seed);
+
+    writer.BeginArray("cooperative");
+    for (const MINT32 agentCount : { 100, 300 }) {
+        RunCooperative(writer, agentCount, option.Seed);
+    }
+    writer.EndArray();
+
+    writer.EndObject();
+
+    if (stdout != file) {
+        fclose(file);
+    }
+
+    return 0;
+}
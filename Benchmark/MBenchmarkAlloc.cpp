@@ -0,0 +1,95 @@
+﻿//----------------------------------------------------------------------
+// 전역 new / delete 교체 (메모리 할당 수 측정)
+// 배열 / 크기 / nothrow 형식도 모두 같은 할당 함수를 거치고 해제는 크기 없는 delete 하나로 모은다
+// 호출하는 쪽에서 인라인되면 컴파일러가 malloc / free 짝을 new / delete 짝과 다르다고 경고하므로 별도 파일에 둔다
+// 정렬을 지정하는 형식은 기본 구현을 사용한다 (검색에서 사용하지 않는다)
+//----------------------------------------------------------------------
+#include "MBenchmarkAlloc.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+
+namespace
+{
+    std::atomic<MUINT64> AllocCount(0);
+    std::atomic<MUINT64> AllocSize(0);
+
+    void* AllocateCounted(size_t inSize) noexcept
+    {
+        ++AllocCount;
+        AllocSize += inSize;
+
+        return malloc(0 < inSize ? inSize : 1);
+    }
+}
+
+namespace MAstar
+{
+    MUINT64 GetAllocCount()
+    {
+        return AllocCount;
+    }
+
+    MUINT64 GetAllocSize()
+    {
+        return AllocSize;
+    }
+};
+
+
+void* operator new(size_t inSize)
+{
+    void* data = AllocateCounted(inSize);
+    if (nullptr == data) {
+        throw std::bad_alloc();
+    }
+
+    return data;
+}
+
+void* operator new[](size_t inSize)
+{
+    return ::operator new(inSize);
+}
+
+void* operator new(size_t inSize, const std::nothrow_t&) noexcept
+{
+    return AllocateCounted(inSize);
+}
+
+void* operator new[](size_t inSize, const std::nothrow_t&) noexcept
+{
+    return AllocateCounted(inSize);
+}
+
+void operator delete(void* inData) noexcept
+{
+    free(inData);
+}
+
+void operator delete[](void* inData) noexcept
+{
+    ::operator delete(inData);
+}
+
+void operator delete(void* inData, size_t) noexcept
+{
+    ::operator delete(inData);
+}
+
+void operator delete[](void* inData, size_t) noexcept
+{
+    ::operator delete(inData);
+}
+
+void operator delete(void* inData, const std::nothrow_t&) noexcept
+{
+    ::operator delete(inData);
+}
+
+void operator delete[](void* inData, const std::nothrow_t&) noexcept
+{
+    ::operator delete(inData);
+}
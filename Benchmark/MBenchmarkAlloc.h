@@ -0,0 +1,14 @@
+﻿#pragma once
+
+#include "MPrerequisites.h"
+#include "MType.h"
+
+
+namespace MAstar
+{
+    //----------------------------------------------------------------------
+    // 전역 new 호출 수 / 할당한 크기 합 (MBenchmarkAlloc.cpp에서 전역 new / delete를 교체해서 센다)
+    //----------------------------------------------------------------------
+    MUINT64 GetAllocCount();
+    MUINT64 GetAllocSize();
+};
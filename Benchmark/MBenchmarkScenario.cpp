@@ -0,0 +1,375 @@
+﻿#include "MBenchmarkScenario.h"
+#include "MComponent.h"
+
+#include <cstdio>
+#include <cstring>
+#include <random>
+
+
+namespace MAstar
+{
+    namespace
+    {
+        // 무작위 맵 장애물 비율
+        const MFLOAT RandomBlockRate = 0.25f;
+
+        // 넓은 지형의 장애물 크기 / 타일당 장애물 수
+        const MINT32 OpenObstacleSize = 4;
+        const MFLOAT OpenObstacleRate = 0.004f;
+
+        // 방 크기 (벽 포함)
+        const MINT32 RoomSize = 16;
+    }
+
+    void MBenchmarkScenario::Generate(MBenchmarkMapType inType, MINT32 inSize, MUINT32 inSeed)
+    {
+        Name = GetMapTypeName(inType);
+        QueryList.clear();
+
+        std::mt19937 random(inSeed);
+        std::uniform_real_distribution<MFLOAT> rate(0.0f, 1.0f);
+
+        switch (inType)
+        {
+        case MBenchmarkMapType::Random:
+            ResetGrid(inSize, inSize, MFALSE);
+            for (MTile& tile : Grid.TileList) {
+                tile.IsBlocked = rate(random) < RandomBlockRate;
+            }
+            break;
+
+        case MBenchmarkMapType::Maze:
+        {
+            //----------------------------------------------------------------
+            // 홀수 위치의 칸을 깊이 우선으로 이어서 한칸 통로를 만든다
+            //----------------------------------------------------------------
+            ResetGrid(inSize, inSize, MTRUE);
+
+            const MINT32 cellCount = (inSize - 1) / 2;
+            if (cellCount <= 0) {
+                break;
+            }
+
+            const MIntPoint directionList[4] = { MIntPoint(1, 0), MIntPoint(-1, 0), MIntPoint(0, 1), MIntPoint(0, -1) };
+
+            std::vector<MUINT8> visitList(cellCount * cellCount, 0);
+            std::vector<MIntPoint> stackList;
+
+            stackList.push_back(MIntPoint(0, 0));
+            visitList[0] = 1;
+            SetBlocked(1, 1, MFALSE);
+
+            while (MFALSE == stackList.empty())
+            {
+                const MIntPoint cell = stackList.back();
+
+                // 방문하지 않은 이웃 칸
+                MIntPoint nextList[4];
+                MINT32 nextCount = 0;
+
+                for (const MIntPoint& direction : directionList)
+                {
+                    const MIntPoint next = cell + direction;
+                    if (0 <= next.X && next.X < cellCount && 0 <= next.Y && next.Y < cellCount && 0 == visitList[(next.Y * cellCount) + next.X]) {
+                        nextList[nextCount++] = next;
+                    }
+                }
+
+                if (0 == nextCount)
+                {
+                    stackList.pop_back();
+                    continue;
+                }
+
+                const MIntPoint next = nextList[random() % nextCount];
+                visitList[(next.Y * cellCount) + next.X] = 1;
+
+                // 두 칸 사이의 벽을 뚫는다
+                SetBlocked((next.X * 2) + 1, (next.Y * 2) + 1, MFALSE);
+                SetBlocked(cell.X + next.X + 1, cell.Y + next.Y + 1, MFALSE);
+
+                stackList.push_back(next);
+            }
+            break;
+        }
+
+        case MBenchmarkMapType::Open:
+        {
+            ResetGrid(inSize, inSize, MFALSE);
+
+            const MINT32 obstacleCount = static_cast<MINT32>(inSize * inSize * OpenObstacleRate);
+            for (MINT32 i = 0; i < obstacleCount; ++i)
+            {
+                const MINT32 left = random() % inSize;
+                const MINT32 top = random() % inSize;
+                const MINT32 width = 1 + (random() % OpenObstacleSize);
+                const MINT32 height = 1 + (random() % OpenObstacleSize);
+
+                for (MINT32 y = top; y < std::min(top + height, inSize); ++y)
+                {
+                    for (MINT32 x = left; x < std::min(left + width, inSize); ++x) {
+                        SetBlocked(x, y, MTRUE);
+                    }
+                }
+            }
+            break;
+        }
+
+        case MBenchmarkMapType::Room:
+        {
+            //----------------------------------------------------------------
+            // 일정 간격으로 벽을 세우고 방마다 오른쪽 / 아래쪽 벽에 문을 낸다
+            //----------------------------------------------------------------
+            ResetGrid(inSize, inSize, MFALSE);
+
+            for (MINT32 y = 0; y < inSize; ++y)
+            {
+                for (MINT32 x = 0; x < inSize; ++x)
+                {
+                    if (0 == (x % RoomSize) || 0 == (y % RoomSize)) {
+                        SetBlocked(x, y, MTRUE);
+                    }
+                }
+            }
+
+            for (MINT32 top = 0; top < inSize; top += RoomSize)
+            {
+                for (MINT32 left = 0; left < inSize; left += RoomSize)
+                {
+                    const MINT32 doorX = left + 1 + (random() % (RoomSize - 1));
+                    const MINT32 doorY = top + 1 + (random() % (RoomSize - 1));
+
+                    // 가장자리 벽은 막아둔다
+                    if (0 < left && doorY < inSize) {
+                        SetBlocked(left, doorY, MFALSE);
+                    }
+
+                    if (0 < top && doorX < inSize) {
+                        SetBlocked(doorX, top, MFALSE);
+                    }
+                }
+            }
+            break;
+        }
+        }
+    }
+
+    //----------------------------------------------------------------
+    // Moving AI 맵
+    // type octile / height H / width W / map 뒤에 한줄에 한행씩
+    // '.' 'G' 'S'는 이동 가능, 그 외 ('@' 'O' 'T' 'W')는 막힘
+    //----------------------------------------------------------------
+    MBOOL MBenchmarkScenario::LoadMap(const char* inPath)
+    {
+        FILE* file = fopen(inPath, "r");
+        if (nullptr == file) {
+            return MFALSE;
+        }
+
+        char type[64] = {};
+        MINT32 height = 0;
+        MINT32 width = 0;
+        char mapTag[64] = {};
+
+        MBOOL isSuccess = (1 == fscanf(file, " type %63s", type));
+        isSuccess = isSuccess && (1 == fscanf(file, " height %d", &height));
+        isSuccess = isSuccess && (1 == fscanf(file, " width %d", &width));
+        isSuccess = isSuccess && (1 == fscanf(file, " %63s", mapTag)) && 0 == strcmp(mapTag, "map");
+        isSuccess = isSuccess && 0 < width && 0 < height;
+
+        if (MTRUE == isSuccess)
+        {
+            ResetGrid(width, height, MTRUE);
+
+            // 줄바꿈은 건너뛰고 한 글자씩 읽는다
+            for (MINT32 y = 0; y < height && MTRUE == isSuccess; ++y)
+            {
+                for (MINT32 x = 0; x < width; ++x)
+                {
+                    MINT32 tile = fgetc(file);
+                    while ('\n' == tile || '\r' == tile) {
+                        tile = fgetc(file);
+                    }
+
+                    if (EOF == tile)
+                    {
+                        isSuccess = MFALSE;
+                        break;
+                    }
+
+                    SetBlocked(x, y, ('.' == tile || 'G' == tile || 'S' == tile) ? MFALSE : MTRUE);
+                }
+            }
+        }
+
+        fclose(file);
+
+        if (MFALSE == isSuccess) {
+            return MFALSE;
+        }
+
+        // 경로를 빼고 파일 이름만 사용
+        const char* fileName = strrchr(inPath, '/');
+        Name = (nullptr != fileName) ? (fileName + 1) : inPath;
+        QueryList.clear();
+
+        return MTRUE;
+    }
+
+    //----------------------------------------------------------------
+    // Moving AI 시나리오
+    // version 1 뒤에 한줄에 한 문제씩
+    // 버킷 / 맵 이름 / 맵 너비 / 맵 높이 / 시작 X / 시작 Y / 종료 X / 종료 Y / 최단 거리
+    //----------------------------------------------------------------
+    MBOOL MBenchmarkScenario::LoadScenario(const char* inPath)
+    {
+        FILE* file = fopen(inPath, "r");
+        if (nullptr == file) {
+            return MFALSE;
+        }
+
+        QueryList.clear();
+
+        MFLOAT version = 0;
+        MBOOL isSuccess = (1 == fscanf(file, " version %f", &version));
+
+        while (MTRUE == isSuccess)
+        {
+            MINT32 bucket = 0;
+            char mapName[256] = {};
+            MINT32 width = 0;
+            MINT32 height = 0;
+            MBenchmarkQuery query;
+            double optimalLength = 0;
+
+            if (9 != fscanf(file, " %d %255s %d %d %d %d %d %d %lf", &bucket, mapName, &width, &height,
+                &query.StartIndex2D.X, &query.StartIndex2D.Y, &query.EndIndex2D.X, &query.EndIndex2D.Y, &optimalLength)) {
+                break;
+            }
+
+            // 맵 크기가 다르면 시나리오가 맞지 않는다
+            if (width != Grid.TileCount.X || height != Grid.TileCount.Y)
+            {
+                isSuccess = MFALSE;
+                break;
+            }
+
+            query.OptimalLength = static_cast<MFLOAT>(optimalLength);
+            QueryList.push_back(query);
+        }
+
+        fclose(file);
+
+        return isSuccess && MFALSE == QueryList.empty();
+    }
+
+    void MBenchmarkScenario::GenerateQueryList(MINT32 inCount, MUINT32 inSeed)
+    {
+        QueryList.clear();
+
+        std::vector<MIntPoint> walkableList;
+        for (const MTile& tile : Grid.TileList)
+        {
+            if (MFALSE == tile.IsBlocked) {
+                walkableList.push_back(tile.Index2D);
+            }
+        }
+
+        if (walkableList.size() < 2) {
+            return;
+        }
+
+        // 같은 연결 영역의 타일만 고른다
+        MComponentMap componentMap;
+        componentMap.Build(&Grid);
+
+        std::mt19937 random(inSeed);
+
+        const MINT32 maxTryCount = inCount * 100;
+        for (MINT32 i = 0; i < maxTryCount && static_cast<MINT32>(QueryList.size()) < inCount; ++i)
+        {
+            MBenchmarkQuery query;
+            query.StartIndex2D = walkableList[random() % walkableList.size()];
+            query.EndIndex2D = walkableList[random() % walkableList.size()];
+
+            if (query.StartIndex2D == query.EndIndex2D || MFALSE == componentMap.IsReachable(query.StartIndex2D, query.EndIndex2D)) {
+                continue;
+            }
+
+            QueryList.push_back(query);
+        }
+    }
+
+    void MBenchmarkScenario::GenerateUnreachableQueryList(MINT32 inCount, MUINT32 inSeed, std::vector<MBenchmarkQuery>& outList) const
+    {
+        outList.clear();
+
+        std::vector<MIntPoint> walkableList;
+        for (const MTile& tile : Grid.TileList)
+        {
+            if (MFALSE == tile.IsBlocked) {
+                walkableList.push_back(tile.Index2D);
+            }
+        }
+
+        if (walkableList.size() < 2) {
+            return;
+        }
+
+        MComponentMap componentMap;
+        componentMap.Build(&Grid);
+
+        std::mt19937 random(inSeed);
+
+        const MINT32 maxTryCount = inCount * 100;
+        for (MINT32 i = 0; i < maxTryCount && static_cast<MINT32>(outList.size()) < inCount; ++i)
+        {
+            MBenchmarkQuery query;
+            query.StartIndex2D = walkableList[random() % walkableList.size()];
+            query.EndIndex2D = walkableList[random() % walkableList.size()];
+
+            if (MTRUE == componentMap.IsReachable(query.StartIndex2D, query.EndIndex2D)) {
+                continue;
+            }
+
+            outList.push_back(query);
+        }
+    }
+
+    const char* MBenchmarkScenario::GetMapTypeName(MBenchmarkMapType inType)
+    {
+        switch (inType)
+        {
+        case MBenchmarkMapType::Random:
+            return "random";
+
+        case MBenchmarkMapType::Maze:
+            return "maze";
+
+        case MBenchmarkMapType::Open:
+            return "open";
+
+        case MBenchmarkMapType::Room:
+            return "room";
+        }
+
+        return "unknown";
+    }
+
+    void MBenchmarkScenario::ResetGrid(MINT32 inSizeX, MINT32 inSizeY, MBOOL inIsBlocked)
+    {
+        Grid.TileCount = MIntSize(inSizeX, inSizeY);
+        Grid.TileList.clear();
+        Grid.TileList.resize(inSizeX * inSizeY);
+
+        for (MINT32 y = 0; y < inSizeY; ++y)
+        {
+            for (MINT32 x = 0; x < inSizeX; ++x)
+            {
+                MTile& tile = Grid.TileList[(y * inSizeX) + x];
+                tile.Index2D = MIntPoint(x, y);
+                tile.IsBlocked = inIsBlocked;
+            }
+        }
+    }
+};
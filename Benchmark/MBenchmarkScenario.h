@@ -0,0 +1,75 @@
+﻿#pragma once
+
+#include <string>
+#include <vector>
+
+#include "MPrerequisites.h"
+#include "MType.h"
+#include "MAstar.h"
+
+
+namespace MAstar
+{
+    //----------------------------------------------------------------------
+    // 벤치마크 맵 종류
+    //----------------------------------------------------------------------
+    enum class MBenchmarkMapType
+    {
+        Random,         // 무작위 장애물
+        Maze,           // 한칸 통로 미로
+        Open,           // 작은 장애물이 드문드문 있는 넓은 지형
+        Room,           // 문으로 연결된 방
+    };
+
+
+    //----------------------------------------------------------------------
+    // 검색 문제 (Moving AI 시나리오 한줄)
+    //----------------------------------------------------------------------
+    struct MBenchmarkQuery
+    {
+    public:
+        MIntPoint StartIndex2D;
+        MIntPoint EndIndex2D;
+
+        // 최단 경로 길이 (대각선 이동, 모서리 통과 불가, 타일 단위, 모른다면 음수)
+        MFLOAT OptimalLength = -1;
+    };
+
+
+    //----------------------------------------------------------------------
+    // 벤치마크 시나리오 (맵 + 검색 문제 목록)
+    //----------------------------------------------------------------------
+    class MBenchmarkScenario
+    {
+    public:
+        // 맵 생성 (같은 inSeed는 같은 맵)
+        void Generate(MBenchmarkMapType inType, MINT32 inSize, MUINT32 inSeed);
+
+        // Moving AI 맵 (.map) / 시나리오 (.scen) 불러오기
+        MBOOL LoadMap(const char* inPath);
+        MBOOL LoadScenario(const char* inPath);
+
+        // 연결된 타일끼리 무작위 검색 문제를 만든다 (기존 목록은 지운다)
+        void GenerateQueryList(MINT32 inCount, MUINT32 inSeed);
+
+        // 연결되지 않은 타일끼리 검색 문제를 만든다 (연결 영역이 하나뿐이라면 빈 목록)
+        void GenerateUnreachableQueryList(MINT32 inCount, MUINT32 inSeed, std::vector<MBenchmarkQuery>& outList) const;
+
+        static const char* GetMapTypeName(MBenchmarkMapType inType);
+
+    public:
+        // 이름 (맵 종류 또는 파일 이름)
+        std::string Name;
+
+        MGrid Grid;
+        std::vector<MBenchmarkQuery> QueryList;
+
+    protected:
+        // 크기만큼 타일을 만든다 (inIsBlocked로 초기화)
+        void ResetGrid(MINT32 inSizeX, MINT32 inSizeY, MBOOL inIsBlocked);
+
+        void SetBlocked(MINT32 inX, MINT32 inY, MBOOL inIsBlocked) {
+            Grid.TileList[Grid.GetTileIndex(MIntPoint(inX, inY))].IsBlocked = inIsBlocked;
+        }
+    };
+};
@@ -1,10 +1,135 @@
-#include "MAstar.h"
+﻿#include "MAstar.h"
 #include "MTrace.h"
 #include "MCollision.h"
+#include "MClearance.h"
+#include "MComponent.h"
+#include "MLandmark.h"
+#include "MBitGrid.h"
+#include "MPathCache.h"
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 
 
 namespace MAstar
 {
+    namespace
+    {
+        // 양방향 검색을 스레드로 진행할때 한 라운드에 방향별로 확장할 노드 수
+        const MINT32 BidirectionalRoundExpandCount = 256;
+
+        // 양방향 검색의 동점 처리 단계 수
+        // G를 (2 * 단계 수)배, 양쪽 남은 거리 차이를 단계 수배로 저장하고 남은 거리에 시작 ~ 종료 직선에서 떨어진 거리 (0 ~ 단계 수 - 1)를 더한다
+        // 더한 값은 이동 비용 1보다 작으므로 F가 같은 노드끼리의 순서만 바뀐다
+        const MINT32 BidirectionalTieScale = 4;
+
+        //----------------------------------------------------------------
+        // 양방향 검색 종료 조건의 여유
+        // G는 (2 * 단계 수)의 배수이므로 찾은 경로보다 짧은 경로는 (찾은 경로 - 2 * 단계 수) 이하이고
+        // 양쪽 F에 더해진 직선 거리는 합쳐서 2 * (단계 수 - 1) 이하이므로
+        // 양쪽의 가장 작은 F 합이 (찾은 경로 - 여유) 이상이면 더 짧은 경로가 없다
+        //----------------------------------------------------------------
+        const MINT32 BidirectionalFinishMargin = (2 * BidirectionalTieScale) - (2 * (BidirectionalTieScale - 1)) - 1;
+
+        // Jump Point Search 비트 행에서 타일이 이동 가능한지 (행 밖은 막힘)
+        MBOOL IsJumpRowBit(const MUINT64* inBits, MINT32 inX, MINT32 inWidth)
+        {
+            return 0 <= inX && inX < inWidth && 0 != ((inBits[inX / 64] >> (inX % 64)) & 1);
+        }
+
+        //----------------------------------------------------------------
+        // 경로 출력 대상
+        // 경로를 만드는 함수는 전체 수를 먼저 정하고 (Resize) 위치별로 채우거나 (Set) 뒤에 추가한다 (Add)
+        //----------------------------------------------------------------
+        // std::vector에 쓴다
+        template<typename POINT>
+        class MPathListSink
+        {
+        public:
+            explicit MPathListSink(std::vector<POINT>& outList)
+                : List(outList) {}
+
+            void Clear() {
+                List.clear();
+            }
+
+            MINT32 GetCount() const {
+                return static_cast<MINT32>(List.size());
+            }
+
+            void Resize(MINT32 inCount) {
+                List.resize(inCount);
+            }
+
+            void Set(MINT32 inIndex, const POINT& inPoint) {
+                List[inIndex] = inPoint;
+            }
+
+            void Add(const POINT& inPoint) {
+                List.push_back(inPoint);
+            }
+
+            void Assign(const POINT* inBegin, const POINT* inEnd) {
+                List.assign(inBegin, inEnd);
+            }
+
+            // 저장된 경로 (항상 전체 경로)
+            const POINT* GetData() const {
+                return List.data();
+            }
+
+        private:
+            std::vector<POINT>& List;
+        };
+
+        // 호출자 버퍼에 쓴다 (버퍼보다 길다면 앞쪽만 쓰고 전체 수는 센다)
+        template<typename POINT>
+        class MPathBufferSink
+        {
+        public:
+            MPathBufferSink(POINT* outBuffer, MINT32 inCapacity)
+                : Buffer(outBuffer), Capacity(std::max(inCapacity, 0)) {}
+
+            void Clear() {
+                Count = 0;
+            }
+
+            MINT32 GetCount() const {
+                return Count;
+            }
+
+            void Resize(MINT32 inCount) {
+                Count = inCount;
+            }
+
+            void Set(MINT32 inIndex, const POINT& inPoint) {
+                if (inIndex < Capacity) {
+                    Buffer[inIndex] = inPoint;
+                }
+            }
+
+            void Add(const POINT& inPoint) {
+                Set(Count++, inPoint);
+            }
+
+            void Assign(const POINT* inBegin, const POINT* inEnd) {
+                Count = static_cast<MINT32>(inEnd - inBegin);
+                std::copy(inBegin, inBegin + std::min(Count, Capacity), Buffer);
+            }
+
+            // 저장된 경로 (버퍼보다 길어서 일부만 저장되었다면 nullptr)
+            const POINT* GetData() const {
+                return (Count <= Capacity) ? Buffer : nullptr;
+            }
+
+        private:
+            POINT* Buffer = nullptr;
+            MINT32 Capacity = 0;
+            MINT32 Count = 0;
+        };
+    }
+
     //---------------------------------------------------------------------------
     // Grid
     //---------------------------------------------------------------------------
@@ -33,335 +158,1429 @@ namespace MAstar
     //---------------------------------------------------------------------------
     // PathData
     //---------------------------------------------------------------------------
-    void MNode::InitNode(const MIntPoint &inIndex2D, const MINT32 inDistance_H)
+    void MNode::InitNode(const MINT32 inDistance_H)
     {
-        Index2D = inIndex2D;
-
         // 이전 경로 데이터 초기화
-        PrevNode = nullptr;
+        PrevIndex = -1;
 
         // 경로 정보 초기화
         Distance_H = inDistance_H;
         Distance_G = INFINITY_DISTANCE;
-        Distance_F = inDistance_H;
 
-        IsClose = false;
+        HeapIndex = -1;
     }
 
-    void MNode::SetDistance_G(MINT32 inDistance)
+    //---------------------------------------------------------------------------
+    // NodeTable
+    //---------------------------------------------------------------------------
+    void MNodeTable::BeginSearch(MINT32 inNodeCount)
     {
-        Distance_G = inDistance;
-        Distance_F = Distance_H + Distance_G;
+        if (static_cast<MINT32>(NodeList.size()) != inNodeCount)
+        {
+            // 크기가 바뀌었다면 재할당하고 세대값을 처음부터 사용
+            NodeList.assign(inNodeCount, MNode());
+            StampList.assign(inNodeCount, 0);
+            CurrentStamp = 0;
+        }
+        else if (0xFFFFFFF0 <= CurrentStamp)
+        {
+            // 세대값이 한바퀴 돌기전에 초기화
+            std::fill(StampList.begin(), StampList.end(), 0);
+            CurrentStamp = 0;
+        }
+
+        // 0은 사용하지 않은 노드로 남겨둔다
+        CurrentStamp += 2;
+    }
+
+    //---------------------------------------------------------------------------
+    // OpenList
+    //---------------------------------------------------------------------------
+    void MOpenList::Reset(MNode* inNodeList)
+    {
+        NodeList = inNodeList;
+        HeapList.clear();
+    }
+
+    void MOpenList::Push(MINT32 inIndex)
+    {
+        HeapList.push_back(inIndex);
+
+        const MINT32 heapIndex = static_cast<MINT32>(HeapList.size()) - 1;
+        NodeList[inIndex].SetHeapIndex(heapIndex);
+
+        SiftUp(heapIndex);
+    }
+
+    MINT32 MOpenList::Pop()
+    {
+        if (MTRUE == HeapList.empty()) {
+            return -1;
+        }
+
+        const MINT32 topIndex = HeapList.front();
+        NodeList[topIndex].SetHeapIndex(-1);
+
+        // 마지막 노드를 맨 앞으로 옮기고 아래로 내린다
+        const MINT32 lastIndex = HeapList.back();
+        HeapList.pop_back();
+
+        if (MFALSE == HeapList.empty())
+        {
+            SetAt(0, lastIndex);
+            SiftDown(0);
+        }
+
+        return topIndex;
+    }
+
+    void MOpenList::Update(MINT32 inIndex)
+    {
+        // 거리가 줄어드는 경우만 있으므로 위로만 올린다
+        SiftUp(NodeList[inIndex].GetHeapIndex());
+    }
+
+    void MOpenList::Rebuild()
+    {
+        // 아래쪽 부모부터 내린다
+        for (MINT32 heapIndex = (static_cast<MINT32>(HeapList.size()) / 2) - 1; 0 <= heapIndex; --heapIndex) {
+            SiftDown(heapIndex);
+        }
+    }
+
+    MBOOL MOpenList::IsHigherPriority(MINT32 inLeft, MINT32 inRight) const
+    {
+        const MNode& leftNode = NodeList[inLeft];
+        const MNode& rightNode = NodeList[inRight];
+
+        const MINT32 leftDistance_F = leftNode.GetDistance_F();
+        const MINT32 rightDistance_F = rightNode.GetDistance_F();
+        if (leftDistance_F != rightDistance_F) {
+            return leftDistance_F < rightDistance_F;
+        }
+
+        if (leftNode.GetDistance_H() != rightNode.GetDistance_H()) {
+            return leftNode.GetDistance_H() < rightNode.GetDistance_H();
+        }
+
+        // 타일 인덱스는 (Y, X) 순서
+        return inLeft < inRight;
+    }
+
+    void MOpenList::SiftUp(MINT32 inHeapIndex)
+    {
+        const MINT32 index = HeapList[inHeapIndex];
+
+        while (0 < inHeapIndex)
+        {
+            const MINT32 parentHeapIndex = (inHeapIndex - 1) / 2;
+            const MINT32 parentIndex = HeapList[parentHeapIndex];
+
+            if (MFALSE == IsHigherPriority(index, parentIndex)) {
+                break;
+            }
+
+            SetAt(inHeapIndex, parentIndex);
+            inHeapIndex = parentHeapIndex;
+        }
+
+        SetAt(inHeapIndex, index);
+    }
+
+    void MOpenList::SiftDown(MINT32 inHeapIndex)
+    {
+        const MINT32 count = static_cast<MINT32>(HeapList.size());
+        const MINT32 index = HeapList[inHeapIndex];
+
+        while (MTRUE)
+        {
+            MINT32 childHeapIndex = (inHeapIndex * 2) + 1;
+            if (count <= childHeapIndex) {
+                break;
+            }
+
+            // 두 자식중 우선순위가 높은쪽
+            const MINT32 rightHeapIndex = childHeapIndex + 1;
+            if (rightHeapIndex < count && MTRUE == IsHigherPriority(HeapList[rightHeapIndex], HeapList[childHeapIndex])) {
+                childHeapIndex = rightHeapIndex;
+            }
+
+            if (MFALSE == IsHigherPriority(HeapList[childHeapIndex], index)) {
+                break;
+            }
+
+            SetAt(inHeapIndex, HeapList[childHeapIndex]);
+            inHeapIndex = childHeapIndex;
+        }
+
+        SetAt(inHeapIndex, index);
     }
 
     //---------------------------------------------------------------------------
     // AStar
     //---------------------------------------------------------------------------
+    //----------------------------------------------------------------
+    // 양방향 검색의 종료 위치쪽 작업 스레드
+    // 라운드 값을 올리면 Job을 한번 실행하고 FinishRound를 같은 값으로 맞춘다
+    //----------------------------------------------------------------
+    struct MPathFinder::MBackwardWorker
+    {
+    public:
+        std::thread Thread;
+
+        std::mutex Mutex;
+        std::condition_variable Condition;
+
+        // 이번 검색의 확장 (확장을 중단할 F를 받아서 확장한 노드 수를 리턴)
+        std::function<MINT32(MINT32)> Job;
+
+        MINT32 Round = 0;
+        MINT32 FinishRound = 0;
+        MINT32 Bound = INFINITY_DISTANCE;
+        MBOOL IsStop = MFALSE;
+
+        // 이번 검색에서 확장한 노드 수 / 통계 (검색이 끝나면 합친다)
+        MINT32 ExpandCount = 0;
+        MSearchStats Stats;
+    };
+
     MPathFinder::MPathFinder()
     {
 
-    }
+    }
+
+    MPathFinder::~MPathFinder()
+    {
+        if (nullptr != BackwardWorker)
+        {
+            {
+                std::lock_guard<std::mutex> lock(BackwardWorker->Mutex);
+                BackwardWorker->IsStop = MTRUE;
+            }
+            BackwardWorker->Condition.notify_all();
+
+            BackwardWorker->Thread.join();
+        }
+    }
+
+    void MPathFinder::FindPath(std::vector<MIntPoint> &inList, const MGrid* inGrid, const MIntPoint &inStartIndex2D, const MIntPoint &inEndIndex2D, MINT32 inClearance)
+    {
+        // 타일 경로는 월드 위치 정보가 없으므로 Theta*도 A*로 처리
+        MPathListSink<MIntPoint> path(inList);
+        FindTilePath(path, inGrid, inStartIndex2D, inEndIndex2D, inClearance, MAnyAngleSearch());
+    }
+
+    template<typename SINK>
+    void MPathFinder::FindTilePath(SINK& outPath, const MGrid* inGrid, const MIntPoint& inStartIndex2D, const MIntPoint& inEndIndex2D, MINT32 inClearance, const MAnyAngleSearch& inAnyAngle)
+    {
+        // 정보 클리어
+        outPath.Clear();
+        ExpandCount = 0;
+
+        MSearchStatsPolicy::Reset(Stats);
+        MSearchStatsPolicy::MPhaseTimer totalTimer(Stats.TotalTime);
+
+        // 시작 / 종료 타일
+        const MTile* startTile = inGrid->GetTile(inStartIndex2D);
+        const MTile* endTile = inGrid->GetTile(inEndIndex2D);
+
+        if (nullptr == startTile || nullptr == endTile)
+        {
+            // 에러코드
+            return;
+        }
+
+        // 연결 영역이 다르면 검색하지 않는다
+        if (nullptr != ComponentMap && inGrid == ComponentMap->GetGrid() && MFALSE == (inStartIndex2D == inEndIndex2D) && MFALSE == ComponentMap->IsReachable(inStartIndex2D, inEndIndex2D))
+        {
+            // 시작 위치와 같은 영역에서 가장 가까운 타일로 대신 검색
+            const MINT32 startComponent = ComponentMap->GetComponent(inStartIndex2D);
+
+            MIntPoint nearIndex2D;
+            if (MTRUE == IsNearestGoalFallback && 0 <= startComponent && MTRUE == ComponentMap->FindNearestTile(inEndIndex2D, startComponent, NearestGoalDistance, nearIndex2D)) {
+                FindTilePath(outPath, inGrid, inStartIndex2D, nearIndex2D, inClearance, inAnyAngle);
+            }
+
+            return;
+        }
+
+        StartIndex2D = inStartIndex2D;
+        EndIndex2D = inEndIndex2D;
+
+        // 여유 공간은 같은 그리드의 정보가 있을때만 체크
+        RequiredClearance = 0;
+        if (1 < inClearance && nullptr != ClearanceMap && inGrid == ClearanceMap->GetGrid()) {
+            RequiredClearance = inClearance;
+        }
+
+        // 랜드마크 거리는 상하좌우 이동 기준이므로 직선으로 이동하는 Theta*에는 사용하지 않는다
+        SearchLandmarkMap = nullptr;
+        if (nullptr != LandmarkMap && inGrid == LandmarkMap->GetGrid() && 0 < LandmarkMap->GetLandmarkCount() && MFALSE == inAnyAngle.IsEnable) {
+            SearchLandmarkMap = LandmarkMap;
+        }
+
+        // 저장된 경로가 있다면 검색하지 않는다 (버전은 검색 전에 얻어서 검색중에 그리드가 바뀐 경로는 저장하지 않는다)
+        // 버전을 그리드 확인보다 먼저 얻으므로 그 사이에 Reset으로 그리드가 바뀌어도 저장되지 않는다
+        const MUINT32 cacheVersion = (nullptr != PathCache) ? PathCache->GetVersion() : 0;
+        const MBOOL isUseCache = (nullptr != PathCache && inGrid == PathCache->GetGrid());
+
+        MPathCacheKey cacheKey;
+
+        if (MTRUE == isUseCache)
+        {
+            cacheKey = GetPathCacheKey(inGrid->GetTileIndex(inStartIndex2D), inGrid->GetTileIndex(inEndIndex2D), inAnyAngle);
+
+            if (MTRUE == PathCache->FindPath(cacheKey, inStartIndex2D, outPath)) {
+                return;
+            }
+        }
+
+        // 노드 저장소 / 열린 리스트 준비
+        NodeTable.BeginSearch(inGrid->TileCount.X * inGrid->TileCount.Y);
+        OpenList.Reset(NodeTable.GetNodeData());
+
+        const MINT32 startIndex = inGrid->GetTileIndex(inStartIndex2D);
+        const MINT32 endIndex = inGrid->GetTileIndex(inEndIndex2D);
+        StartIndex = startIndex;
+        EndIndex = endIndex;
+
+        // 시작 노드 설정
+        {
+            MNode& startNode = GetNode(startIndex, inStartIndex2D, inAnyAngle.IsEnable);
+
+            // 시작노드의 G는 0으로 설정
+            startNode.SetDistance_G(0);
+
+            // 열린 노드에 등록
+            OpenList.Push(startIndex);
+            MSearchStatsPolicy::AddPush(Stats, OpenList.GetCount());
+        }
+
+        MSearchStatsPolicy::MPhaseTimer searchTimer(Stats.SearchTime);
+        
+        // A*는 설정된 방식의 검색 루프를 사용
+        if (MPathEngine::JumpPoint != PathEngine && MFALSE == inAnyAngle.IsEnable)
+        {
+            if (MTRUE == IsUseTileCost) {
+                SearchPath_Neighbor<MGrid, MTileCost>(inGrid, startIndex, endIndex);
+            }
+            else {
+                SearchPath_Neighbor<MGrid, MUniformCost>(inGrid, startIndex, endIndex);
+            }
+
+            BuildSearchPath(outPath, inGrid);
+
+            if (MTRUE == isUseCache) {
+                AddCachePath(cacheKey, cacheVersion, outPath.GetData(), outPath.GetCount(), inAnyAngle);
+            }
+
+            return;
+        }
+
+        if (MPathEngine::JumpPoint == PathEngine && MFALSE == inAnyAngle.IsEnable) {
+            BeginJumpRowSearch(inGrid);
+        }
+
+        // 
+        while (MTRUE)
+        {
+            const MINT32 checkIndex = GetNextCheckNode();
+            if (checkIndex < 0)
+            {
+                // 더이상 열린 노드가 없다
+                break;
+            }
+            
+            if (checkIndex == endIndex)
+            {
+                // 끝에 종료 위치까지 도달
+                break;
+            }
+
+            // 열린 리스트에서 제거
+            OpenList.Pop();
+            MSearchStatsPolicy::AddPop(Stats);
+
+            // 닫힘 처리
+            NodeTable.SetClose(checkIndex);
+            ++ExpandCount;
+            MSearchStatsPolicy::AddExpand(Stats);
+
+            // 정보를 갱신
+            if (MPathEngine::JumpPoint == PathEngine) {
+                UpdateJumpPointNode(inGrid, checkIndex);
+            }
+            else {
+                UpdateThetaStarNode(inGrid, checkIndex, inAnyAngle);
+            }
+        }
+
+        BuildPath(outPath, inGrid, inEndIndex2D, endIndex, inAnyAngle.IsEnable);
+
+        if (MTRUE == isUseCache) {
+            AddCachePath(cacheKey, cacheVersion, outPath.GetData(), outPath.GetCount(), inAnyAngle);
+        }
+    }
+
+    void MPathFinder::FindPath(std::vector<MIntPoint>& inList, const MBitGrid* inGrid, const MIntPoint& inStartIndex2D, const MIntPoint& inEndIndex2D)
+    {
+        MPathListSink<MIntPoint> path(inList);
+        FindTilePath(path, inGrid, inStartIndex2D, inEndIndex2D);
+    }
+
+    template<typename SINK>
+    void MPathFinder::FindTilePath(SINK& outPath, const MBitGrid* inGrid, const MIntPoint& inStartIndex2D, const MIntPoint& inEndIndex2D)
+    {
+        outPath.Clear();
+        ExpandCount = 0;
+
+        MSearchStatsPolicy::Reset(Stats);
+        MSearchStatsPolicy::MPhaseTimer totalTimer(Stats.TotalTime);
+
+        if (MFALSE == inGrid->IsInside(inStartIndex2D.X, inStartIndex2D.Y) || MFALSE == inGrid->IsInside(inEndIndex2D.X, inEndIndex2D.Y)) {
+            return;
+        }
+
+        // 여유 공간 / 랜드마크 정보는 MGrid 전용
+        StartIndex2D = inStartIndex2D;
+        EndIndex2D = inEndIndex2D;
+        RequiredClearance = 0;
+        SearchLandmarkMap = nullptr;
+
+        NodeTable.BeginSearch(inGrid->TileCount.X * inGrid->TileCount.Y);
+        OpenList.Reset(NodeTable.GetNodeData());
+
+        const MINT32 startIndex = inGrid->GetTileIndex(inStartIndex2D);
+        const MINT32 endIndex = inGrid->GetTileIndex(inEndIndex2D);
+        StartIndex = startIndex;
+        EndIndex = endIndex;
+
+        GetNode(startIndex, inStartIndex2D, MFALSE).SetDistance_G(0);
+        OpenList.Push(startIndex);
+        MSearchStatsPolicy::AddPush(Stats, OpenList.GetCount());
+
+        MSearchStatsPolicy::MPhaseTimer searchTimer(Stats.SearchTime);
+        SearchPath_Neighbor<MBitGrid, MUniformCost>(inGrid, startIndex, endIndex);
+
+        BuildSearchPath(outPath, inGrid);
+    }
+
+    void MPathFinder::FindPath(std::vector<MVector2>& inList, const MVector2& inGridPos, float inTileSize, const MGrid* inGrid, const MVector2& inStartPos, const MVector2& inEndPos, MFLOAT inRadius)
+    {
+        MPathListSink<MVector2> path(inList);
+        FindPositionPath(path, inGridPos, inTileSize, inGrid, inStartPos, inEndPos, inRadius);
+    }
+
+    template<typename SINK>
+    void MPathFinder::FindPositionPath(SINK& outPath, const MVector2& inGridPos, float inTileSize, const MGrid* inGrid, const MVector2& inStartPos, const MVector2& inEndPos, MFLOAT inRadius)
+    {
+        outPath.Clear();
+
+        // 타일 검색에서 다시 초기화 되지만 같은 위치인 경우를 위해 먼저 초기화
+        MSearchStatsPolicy::Reset(Stats);
+        MSearchStatsPolicy::MPhaseTimer totalTimer(Stats.TotalTime);
+
+        // 시작 / 종료 위치 인덱스를 구한다
+        MIntPoint startIndex2D = GetIndex2DByPosition(inGridPos, inTileSize, inStartPos);
+        MIntPoint endIndex2D = GetIndex2DByPosition(inGridPos, inTileSize, inEndPos);
+
+        // 동일 위치인경우 그냥 결과 위치로 이동
+        if (startIndex2D == endIndex2D)
+        {
+            outPath.Add(inEndPos);
+            return;
+        }
+
+        // Theta*는 검색중에 시야 체크를 하므로 검색 정보를 넘긴다
+        MAnyAngleSearch anyAngle;
+        anyAngle.IsEnable = (MPathEngine::ThetaStar == PathEngine);
+        anyAngle.GridPos = inGridPos;
+        anyAngle.TileSize = inTileSize;
+        anyAngle.Radius = inRadius;
+
+        // 인덱스 리스트를 구한다 (여유 공간 정보가 있다면 반지름이 들어갈 수 있는 타일로만)
+        std::vector<MIntPoint>& index2DList = PathIndex2DList;
+        MPathListSink<MIntPoint> index2DPath(index2DList);
+        FindTilePath(index2DPath, inGrid, startIndex2D, endIndex2D, MClearanceMap::GetRequiredClearance(inRadius, inTileSize), anyAngle);
+
+        if (MTRUE == index2DList.empty()) {
+            return;
+        }
+
+        MSearchStatsPolicy::MPhaseTimer smoothTimer(Stats.SmoothTime);
+
+        // 리스트를 돌면서 중앙 지점을 구한다
+        const MINT32 count = index2DList.size();
+        std::vector<MVector2>& positionList = PathPositionList;
+        positionList.resize(count);
+
+        for (MINT32 i = 0; i < count; ++i) {
+            positionList[i] = GetCenterPosByIndex2D(inGridPos, inTileSize, index2DList[i]);
+        }
+
+        // 마지막 위치는 종료 위치 (가까운 타일로 대신 검색했다면 그 타일의 중앙)
+        const MBOOL isEndPos = (0 < count && index2DList[count - 1] == endIndex2D);
+        if (MTRUE == isEndPos) {
+            positionList[count - 1] = inEndPos;
+        }
+
+        // 시작점 추가 (버퍼가 짧으면 저장되지 않을 수 있으므로 마지막으로 추가한 위치를 따로 가지고 있는다)
+        outPath.Add(inStartPos);
+        MVector2 lastPos = inStartPos;
+
+        //----------------------------------------------------------------
+        // Theta* 경로는 타일 중앙끼리 직선으로 연결되어 있다
+        // 시작 / 종료 위치는 타일 중앙이 아닐 수 있으므로 양 끝 구간만 다시 체크해서
+        // 막힌다면 시작 / 종료 타일 중앙을 거쳐간다
+        //----------------------------------------------------------------
+        if (MTRUE == anyAngle.IsEnable)
+        {
+            // 가까운 타일로 대신 검색한 결과가 시작 타일이라면 타일 하나뿐이므로 시작 타일 중앙으로만 이동
+            if (count < 2)
+            {
+                outPath.Add(positionList[0]);
+                return;
+            }
+
+            if (MTRUE == CheckBlockLine(inGridPos, inTileSize, inGrid, inStartPos, positionList[1], inRadius))
+            {
+                outPath.Add(positionList[0]);
+                lastPos = positionList[0];
+            }
+
+            for (MINT32 i = 1; i < count - 1; ++i)
+            {
+                outPath.Add(positionList[i]);
+                lastPos = positionList[i];
+            }
+
+            if (MTRUE == isEndPos && MTRUE == CheckBlockLine(inGridPos, inTileSize, inGrid, lastPos, inEndPos, inRadius)) {
+                outPath.Add(GetCenterPosByIndex2D(inGridPos, inTileSize, endIndex2D));
+            }
+
+            outPath.Add(positionList[count - 1]);
+            return;
+        }
+
+        //----------------------------------------------------------------
+        // OBB 체크
+        // 기준 위치에서 앞으로 나아가다가 막히면 바로 이전 위치를 다음 기준 위치로 삼는다
+        // 위치마다 한번씩만 체크하므로 경로 길이에 비례
+        //----------------------------------------------------------------
+        const MINT32 lastIndex = positionList.size() - 1;
+
+        MINT32 checkIndex = 0;
+        for (MINT32 i = 2; i <= lastIndex; ++i)
+        {
+            MSearchStatsPolicy::AddSmooth(Stats);
+
+            // 바로 옆 위치는 항상 이동 가능
+            if (MTRUE == CheckBlockLine(inGridPos, inTileSize, inGrid, positionList[checkIndex], positionList[i], inRadius))
+            {
+                checkIndex = i - 1;
+                outPath.Add(positionList[checkIndex]);
+            }
+        }
+
+        outPath.Add(positionList[lastIndex]);
+    }
+
+    MINT32 MPathFinder::FindPath(MIntPoint* outBuffer, MINT32 inCapacity, const MGrid* inGrid, const MIntPoint& inStartIndex2D, const MIntPoint& inEndIndex2D, MINT32 inClearance)
+    {
+        MPathBufferSink<MIntPoint> path(outBuffer, inCapacity);
+        FindTilePath(path, inGrid, inStartIndex2D, inEndIndex2D, inClearance, MAnyAngleSearch());
+        return path.GetCount();
+    }
+
+    MINT32 MPathFinder::FindPath(MIntPoint* outBuffer, MINT32 inCapacity, const MBitGrid* inGrid, const MIntPoint& inStartIndex2D, const MIntPoint& inEndIndex2D)
+    {
+        MPathBufferSink<MIntPoint> path(outBuffer, inCapacity);
+        FindTilePath(path, inGrid, inStartIndex2D, inEndIndex2D);
+        return path.GetCount();
+    }
+
+    MINT32 MPathFinder::FindPath(MVector2* outBuffer, MINT32 inCapacity, const MVector2& inGridPos, float inTileSize, const MGrid* inGrid, const MVector2& inStartPos, const MVector2& inEndPos, MFLOAT inRadius)
+    {
+        MPathBufferSink<MVector2> path(outBuffer, inCapacity);
+        FindPositionPath(path, inGridPos, inTileSize, inGrid, inStartPos, inEndPos, inRadius);
+        return path.GetCount();
+    }
+
+
+    MNode& MPathFinder::GetNode(MINT32 inIndex, const MIntPoint& inIndex2D, MBOOL inIsAnyAngle)
+    {
+        // 결과 까지의 거리를 얻는다
+        // 맨허튼 거리 측정 (Theta*는 직선으로 이동하므로 직선 거리)
+        MINT32 distanceH = (MTRUE == inIsAnyAngle) ?
+            GetLineDistance(inIndex2D, EndIndex2D) :
+            (abs(EndIndex2D.X - inIndex2D.X) * 10) + (abs(EndIndex2D.Y - inIndex2D.Y) * 10);
+
+        // 랜드마크 하한이 더 크다면 사용 (둘 다 실제 거리보다 작으므로 큰 값도 작다)
+        if (nullptr != SearchLandmarkMap) {
+            distanceH = std::max(distanceH, SearchLandmarkMap->GetHeuristic(inIndex, EndIndex));
+        }
+
+        // 이번 검색에서 처음 사용하는 노드라면 초기화 된다
+        return NodeTable.VisitNode(inIndex, distanceH);
+    }
+
+
+    //----------------------------------------------------------------
+    // 열린 리스트에서 우선순위가 가장 높은 노드를 얻는다
+    //----------------------------------------------------------------
+    MINT32 MPathFinder::GetNextCheckNode()
+    {
+        return OpenList.Top();
+    }
+
+    //----------------------------------------------------------------
+    // 경로 저장소
+    // 같은 타일 경로가 나오는 검색 조건끼리만 경로를 공유한다
+    //----------------------------------------------------------------
+    MPathCacheKey MPathFinder::GetPathCacheKey(MINT32 inStartIndex, MINT32 inEndIndex, const MAnyAngleSearch& inAnyAngle) const
+    {
+        MPathCacheKey key;
+        key.StartIndex = inStartIndex;
+        key.EndIndex = inEndIndex;
+        key.Clearance = RequiredClearance;
+
+        if (MTRUE == inAnyAngle.IsEnable)
+        {
+            // Theta*는 검색중에 반지름으로 직선 체크를 한다
+            key.Option = 2;
+            key.Radius = inAnyAngle.Radius / inAnyAngle.TileSize;
+        }
+        else if (MPathEngine::JumpPoint == PathEngine) {
+            key.Option = 1;
+        }
+        else {
+            key.Option = (static_cast<MUINT32>(NeighborMode) << 2) | ((MTRUE == IsUseTileCost) ? 0x10 : 0);
+        }
+
+        return key;
+    }
+
+    void MPathFinder::AddCachePath(const MPathCacheKey& inKey, MUINT32 inVersion, const MIntPoint* inList, MINT32 inCount, const MAnyAngleSearch& inAnyAngle)
+    {
+        if (nullptr == inList) {
+            return;
+        }
+
+        // 대각선 이동은 양옆 타일, 여유 공간은 (여유 공간 - 1) 거리 안의 타일에 영향을 받는다
+        MINT32 margin = std::max(1, RequiredClearance - 1);
+
+        // Theta* 직선은 반지름 안의 타일에 영향을 받는다
+        if (MTRUE == inAnyAngle.IsEnable) {
+            margin = std::max(margin, static_cast<MINT32>(std::ceil(inAnyAngle.Radius / inAnyAngle.TileSize)) + 1);
+        }
+
+        PathCache->AddPath(inKey, inVersion, margin, inList, inCount);
+    }
+
+    MBOOL MPathFinder::IsWalkable(const MGrid* inGrid, MINT32 inX, MINT32 inY) const
+    {
+        if (MFALSE == inGrid->IsWalkable(inX, inY)) {
+            return MFALSE;
+        }
+
+        // 종료 타일은 여유 공간과 상관없이 도착할 수 있다
+        if (1 < RequiredClearance && (inX != EndIndex2D.X || inY != EndIndex2D.Y)) {
+            return RequiredClearance <= ClearanceMap->GetClearance(inX, inY);
+        }
+
+        return MTRUE;
+    }
+
+    MBOOL MPathFinder::IsWalkable(const MBitGrid* inGrid, MINT32 inX, MINT32 inY) const
+    {
+        return inGrid->IsWalkable(inX, inY);
+    }
+
+    //----------------------------------------------------------------
+    // A*
+    // 주변 타일 / 비용 방식을 템플릿 인자로 받아서 방식마다 루프를 따로 만든다
+    //----------------------------------------------------------------
+    template<typename GRID, typename COST>
+    void MPathFinder::SearchPath_Neighbor(const GRID* inGrid, MINT32 inStartIndex, MINT32 inEndIndex)
+    {
+        switch (NeighborMode)
+        {
+        case MNeighborMode::Eight:
+            SearchPath_Direction<GRID, MNeighbor8<2>, COST>(inGrid, inStartIndex, inEndIndex);
+            break;
+
+        case MNeighborMode::EightCornerCut:
+            SearchPath_Direction<GRID, MNeighbor8<1>, COST>(inGrid, inStartIndex, inEndIndex);
+            break;
+
+        default:
+            SearchPath_Direction<GRID, MNeighbor4, COST>(inGrid, inStartIndex, inEndIndex);
+            break;
+        }
+    }
+
+    template<typename GRID, typename NEIGHBOR, typename COST>
+    void MPathFinder::SearchPath_Direction(const GRID* inGrid, MINT32 inStartIndex, MINT32 inEndIndex)
+    {
+        if (MTRUE == IsBidirectional)
+        {
+            SearchBidirectional<GRID, NEIGHBOR, COST>(inGrid, inStartIndex, inEndIndex);
+            return;
+        }
+
+        SearchPath<GRID, NEIGHBOR, COST>(inGrid, inEndIndex);
+    }
+
+    //----------------------------------------------------------------
+    // 검색 루프는 출력 대상과 상관없이 한번만 인스턴스화하고
+    // 경로를 만드는 부분만 출력 대상별로 인스턴스화한다
+    //----------------------------------------------------------------
+    template<typename GRID, typename SINK>
+    void MPathFinder::BuildSearchPath(SINK& outPath, const GRID* inGrid)
+    {
+        if (MTRUE == IsBidirectional) {
+            BuildBidirectionalPath(outPath, inGrid);
+        }
+        else {
+            BuildPath(outPath, inGrid, EndIndex2D, EndIndex, MFALSE);
+        }
+    }
+
+    template<typename GRID, typename NEIGHBOR, typename COST>
+    void MPathFinder::SearchPath(const GRID* inGrid, MINT32 inEndIndex)
+    {
+        while (MTRUE)
+        {
+            // 더이상 열린 노드가 없거나 종료 위치까지 도달
+            const MINT32 checkIndex = GetNextCheckNode();
+            if (checkIndex < 0 || checkIndex == inEndIndex) {
+                break;
+            }
+
+            OpenList.Pop();
+            NodeTable.SetClose(checkIndex);
+            ++ExpandCount;
+
+            MSearchStatsPolicy::AddPop(Stats);
+            MSearchStatsPolicy::AddExpand(Stats);
+
+            UpdateAroundNode<GRID, NEIGHBOR, COST>(inGrid, checkIndex);
+        }
+    }
+
+    template<typename GRID, typename NEIGHBOR, typename COST>
+    void MPathFinder::UpdateAroundNode(const GRID* inGrid, MINT32 inBaseIndex)
+    {
+        // 기본 인덱스 정보
+        const MIntPoint baseIndex2D = inGrid->GetTileIndex2D(inBaseIndex);
+        const MINT32 baseDistance_G = NodeTable.GetNode(inBaseIndex).GetDistance_G();
+
+        auto IsTargetWalkable = [this, inGrid](MINT32 inX, MINT32 inY)
+        {
+            return IsWalkable(inGrid, inX, inY);
+        };
+
+        ForEachNeighbor<NEIGHBOR>(baseIndex2D, IsTargetWalkable, [&](const MIntPoint& inTargetIndex2D, MINT32 inDistance)
+        {
+            // 닫힌노드인경우 넘어간다
+            const MINT32 targetIndex = inGrid->GetTileIndex(inTargetIndex2D);
+            if (MTRUE == NodeTable.IsClose(targetIndex)) {
+                return;
+            }
+
+            // 기본노드를 거쳐서 대상 노드까지의 거리가 기존보다 적다면 이동 정보를 갱신
+            MNode& targetNode = GetNode<NEIGHBOR>(targetIndex, inTargetIndex2D);
+
+            const MINT32 distance_G = baseDistance_G + COST::GetMoveCost(inGrid, targetIndex, inDistance);
+            if (targetNode.GetDistance_G() <= distance_G) {
+                return;
+            }
+
+            targetNode.SetDistance_G(distance_G);
+            targetNode.SetPrevIndex(inBaseIndex);
+
+            if (MTRUE == OpenList.IsContain(targetIndex)) {
+                OpenList.Update(targetIndex);
+                MSearchStatsPolicy::AddUpdate(Stats);
+            }
+            else {
+                OpenList.Push(targetIndex);
+                MSearchStatsPolicy::AddPush(Stats, OpenList.GetCount());
+            }
+        });
+    }
+
+    template<typename NEIGHBOR>
+    MNode& MPathFinder::GetNode(MINT32 inIndex, const MIntPoint& inIndex2D)
+    {
+        MINT32 distanceH = NEIGHBOR::GetDistance_H(abs(EndIndex2D.X - inIndex2D.X), abs(EndIndex2D.Y - inIndex2D.Y));
+
+        // 랜드마크 거리는 상하좌우 이동 기준이므로 대각선 이동에는 사용하지 않는다
+        if (MFALSE == NEIGHBOR::IsDiagonal && nullptr != SearchLandmarkMap) {
+            distanceH = std::max(distanceH, SearchLandmarkMap->GetHeuristic(inIndex, EndIndex));
+        }
+
+        return NodeTable.VisitNode(inIndex, distanceH);
+    }
+
+    template<typename GRID, typename SINK>
+    void MPathFinder::BuildPath(SINK& outPath, const GRID* inGrid, const MIntPoint& inEndIndex2D, MINT32 inEndIndex, MBOOL inIsAnyAngle)
+    {
+        // 종료 위치에 도달하지 못했다
+        if (MFALSE == NodeTable.IsVisited(inEndIndex)) {
+            return;
+        }
+
+        //----------------------------------------------------------------
+        // 역추적해서 경로 타일 수를 먼저 구하고 뒤에서부터 채워서 뒤집지 않는다
+        // 점프 포인트 사이는 한칸씩 채우므로 두 노드의 체비셰프 거리만큼 타일이 있다
+        // Theta* 경로는 시야가 닿는 노드끼리 연결되어 있으므로 노드만 추가
+        //----------------------------------------------------------------
+        MINT32 count = 1;
+        MIntPoint currentIndex2D = inEndIndex2D;
+
+        for (MINT32 prevIndex = NodeTable.GetNode(inEndIndex).GetPrevIndex(); 0 <= prevIndex; prevIndex = NodeTable.GetNode(prevIndex).GetPrevIndex())
+        {
+            const MIntPoint prevIndex2D = inGrid->GetTileIndex2D(prevIndex);
+            count += (MTRUE == inIsAnyAngle) ? 1 : std::max(abs(prevIndex2D.X - currentIndex2D.X), abs(prevIndex2D.Y - currentIndex2D.Y));
+            currentIndex2D = prevIndex2D;
+        }
+
+        const MINT32 baseCount = outPath.GetCount();
+        outPath.Resize(baseCount + count);
+
+        MINT32 writeIndex = baseCount + count - 1;
+        currentIndex2D = inEndIndex2D;
 
-    MPathFinder::~MPathFinder()
-    {
-        if (MFALSE == UseNodeMap.empty())
+        for (MINT32 prevIndex = NodeTable.GetNode(inEndIndex).GetPrevIndex(); 0 <= prevIndex; prevIndex = NodeTable.GetNode(prevIndex).GetPrevIndex())
         {
-            // 남아있다면 반납이 정상적으로 이루어지지 않은것
-            MASSERT(MFALSE);
+            const MIntPoint prevIndex2D = inGrid->GetTileIndex2D(prevIndex);
+            if (MTRUE == inIsAnyAngle)
+            {
+                outPath.Set(writeIndex--, currentIndex2D);
+                currentIndex2D = prevIndex2D;
+                continue;
+            }
+
+            const MIntPoint step((prevIndex2D.X > currentIndex2D.X) - (prevIndex2D.X < currentIndex2D.X), (prevIndex2D.Y > currentIndex2D.Y) - (prevIndex2D.Y < currentIndex2D.Y));
+
+            while (MFALSE == (currentIndex2D == prevIndex2D))
+            {
+                outPath.Set(writeIndex--, currentIndex2D);
+                currentIndex2D = currentIndex2D + step;
+            }
         }
 
-        MCLEAR_PTR_STACK(NodePool);
+        outPath.Set(writeIndex, currentIndex2D);
     }
 
-    void MPathFinder::FindPath(std::vector<MIntPoint> &inList, const MGrid* inGrid, const MIntPoint &inStartIndex2D, const MIntPoint &inEndIndex2D)
+    //----------------------------------------------------------------
+    // 양방향 A*
+    // 시작 위치쪽은 기존 노드 저장소로, 종료 위치쪽은 별도 저장소로 검색한다
+    // 종료 위치쪽은 간선을 거꾸로 따라가므로 기본 노드로 들어가는 비용을 사용하고
+    // 양쪽 검색에서 모두 사용된 노드의 G 합이 지금까지 찾은 경로 비용이 된다
+    // 남은 거리는 (종료까지 남은 거리 - 시작부터 남은 거리) / 2를 양쪽이 부호만 바꿔 사용해서
+    // 양쪽의 가장 작은 F 합이 찾은 경로 비용 이상이면 최단 경로로 확정한다
+    // 2로 나누지 않고 동점 처리 값을 더할 수 있도록 G를 (2 * BidirectionalTieScale)배로 저장한다
+    // 비용이 같은 최단 경로가 많은 열린 지형은 직선 거리 동점 처리로 양쪽이 같은 경로를 따라가서 가운데에서 만난다
+    // 그래도 단방향 A*가 경로 길이만큼만 확장하는 지형이라 확장 수가 비슷하고 관리 비용만큼 느리다
+    // 종료 거리와 시작 거리를 따로 사용하는 방식 / F가 작은쪽을 확장하는 방식은 다른 지형에서 확장 수가 더 늘어나서 사용하지 않는다
+    //----------------------------------------------------------------
+    template<typename GRID, typename NEIGHBOR, typename COST>
+    void MPathFinder::SearchBidirectional(const GRID* inGrid, MINT32 inStartIndex, MINT32 inEndIndex)
     {
-        // 정보 클리어
-        inList.clear();
-
-        // 시작 / 종료 타일
-        const MTile* startTile = inGrid->GetTile(inStartIndex2D);
-        const MTile* endTile = inGrid->GetTile(inEndIndex2D);
+        // 경로는 검색이 끝난 뒤에 만나는 지점으로 만드므로 먼저 초기화
+        MeetIndex = -1;
+        MeetDistance = INFINITY_DISTANCE;
 
-        if (nullptr == startTile || nullptr == endTile)
-        {
-            // 에러코드
+        // 막힌 종료 위치는 단방향 검색과 같이 도달할 수 없다
+        if (inStartIndex != inEndIndex && MFALSE == IsWalkable(inGrid, EndIndex2D.X, EndIndex2D.Y)) {
             return;
         }
 
-        StartIndex2D = inStartIndex2D;
-        EndIndex2D = inEndIndex2D;
+        // 시작 노드는 호출전에 등록되어 있으므로 남은 거리만 양방향 방식으로 다시 설정 (열린 노드가 하나라서 순서는 그대로)
+        NodeTable.GetNode(inStartIndex).Distance_H = GetBidirectionalDistance_H<NEIGHBOR>(MFALSE, inStartIndex, StartIndex2D);
 
-        // 시작 노드 설정
-        {
-            MNode* startNode = GetNode(inStartIndex2D);
+        // 종료 위치쪽 검색 준비
+        BackwardNodeTable.BeginSearch(inGrid->TileCount.X * inGrid->TileCount.Y);
+        BackwardOpenList.Reset(BackwardNodeTable.GetNodeData());
 
-            // 시작노드의 G는 0으로 설정
-            startNode->SetDistance_G(0);
+        BackwardNodeTable.VisitNode(inEndIndex, GetBidirectionalDistance_H<NEIGHBOR>(MTRUE, inEndIndex, EndIndex2D)).SetDistance_G(0);
+        BackwardOpenList.Push(inEndIndex);
+        MSearchStatsPolicy::AddPush(Stats, BackwardOpenList.GetCount());
 
-            // 열린 노드에 등록
-            OpenNodeSet.insert(startNode);
+        ForwardTouchList.clear();
+        BackwardTouchList.clear();
+        ForwardTouchList.push_back(inStartIndex);
+
+        UpdateMeetNode(MFALSE);
+
+        if (MFALSE == IsBidirectionalThread)
+        {
+            // 열린 노드가 적은쪽을 한개씩 확장
+            while (MFALSE == IsBidirectionalFinish())
+            {
+                const MBOOL isBackward = BackwardOpenList.GetCount() < OpenList.GetCount();
+
+                ExpandCount += ExpandBidirectional<GRID, NEIGHBOR, COST>(inGrid, isBackward, 1, INFINITY_DISTANCE, Stats);
+                UpdateMeetNode(isBackward);
+            }
         }
-        
-        // 
-        while (MTRUE)
+        else
         {
-            MNode* checkNode = GetNextCheckNode();
-            if (nullptr == checkNode)
+            //------------------------------------------------------------
+            // 종료 위치쪽은 작업 스레드에서 확장
+            // 양쪽 노드 저장소는 각 스레드만 수정하고 만나는 지점은 매 라운드가 끝난 뒤에 갱신한다
+            // 반대쪽의 가장 작은 F는 줄어들지 않으므로 라운드 시작시의 값으로 확장을 중단할 F를 정한다
+            //------------------------------------------------------------
+            if (nullptr == BackwardWorker)
             {
-                // 더이상 열린 노드가 없다
-                break;
+                BackwardWorker.reset(new MBackwardWorker());
+                BackwardWorker->Thread = std::thread(&MPathFinder::BackwardWorkerLoop, this);
             }
-            
-            if(checkNode->GetIndex2D() == inEndIndex2D )
+
+            MBackwardWorker& worker = *BackwardWorker;
             {
-                // 끝에 종료 위치까지 도달
-                break;
+                std::lock_guard<std::mutex> lock(worker.Mutex);
+
+                worker.Job = [this, inGrid](MINT32 inBound) {
+                    return ExpandBidirectional<GRID, NEIGHBOR, COST>(inGrid, MTRUE, BidirectionalRoundExpandCount, inBound, BackwardWorker->Stats);
+                };
+                worker.ExpandCount = 0;
+                MSearchStatsPolicy::Reset(worker.Stats);
             }
 
-            // 열린셋에서제거
-            OpenNodeSet.erase(checkNode);
+            while (MFALSE == IsBidirectionalFinish())
+            {
+                const MINT32 forwardBound = MeetDistance - BackwardNodeTable.GetNode(BackwardOpenList.Top()).GetDistance_F() - BidirectionalFinishMargin;
+                {
+                    std::lock_guard<std::mutex> lock(worker.Mutex);
+                    worker.Bound = MeetDistance - NodeTable.GetNode(OpenList.Top()).GetDistance_F() - BidirectionalFinishMargin;
+                    ++worker.Round;
+                }
+                worker.Condition.notify_all();
 
-            // 닫힘 처리
-            checkNode->SetIsClose(MTRUE);
+                ExpandCount += ExpandBidirectional<GRID, NEIGHBOR, COST>(inGrid, MFALSE, BidirectionalRoundExpandCount, forwardBound, Stats);
 
-            // 정보를 갱신
-            UpdateAroundNode(inGrid, checkNode);
+                {
+                    std::unique_lock<std::mutex> lock(worker.Mutex);
+                    worker.Condition.wait(lock, [&worker]() { return worker.FinishRound == worker.Round; });
+                }
+
+                UpdateMeetNode(MFALSE);
+                UpdateMeetNode(MTRUE);
+            }
+
+            // 작업 스레드가 확장한 노드 수 / 통계를 합친다
+            ExpandCount += worker.ExpandCount;
+            MSearchStatsPolicy::Merge(Stats, worker.Stats);
         }
+    }
+
+    template<typename GRID, typename NEIGHBOR, typename COST>
+    MINT32 MPathFinder::ExpandBidirectional(const GRID* inGrid, MBOOL inIsBackward, MINT32 inMaxExpandCount, MINT32 inBound, MSearchStats& outStats)
+    {
+        MNodeTable& nodeTable = (MTRUE == inIsBackward) ? BackwardNodeTable : NodeTable;
+        MOpenList& openList = (MTRUE == inIsBackward) ? BackwardOpenList : OpenList;
+        std::vector<MINT32>& touchList = (MTRUE == inIsBackward) ? BackwardTouchList : ForwardTouchList;
+
+        auto IsTargetWalkable = [this, inGrid](MINT32 inX, MINT32 inY)
+        {
+            return IsWalkable(inGrid, inX, inY);
+        };
 
+        MINT32 expandCount = 0;
 
-        // 결과 위치에서 역추적한다
+        for (; expandCount < inMaxExpandCount; ++expandCount)
         {
-            auto findIter = UseNodeMap.find(inEndIndex2D);
-            if (UseNodeMap.end() != findIter)
+            const MINT32 baseIndex = openList.Top();
+            if (baseIndex < 0 || inBound <= nodeTable.GetNode(baseIndex).GetDistance_F()) {
+                break;
+            }
+
+            openList.Pop();
+            nodeTable.SetClose(baseIndex);
+
+            MSearchStatsPolicy::AddPop(outStats);
+            MSearchStatsPolicy::AddExpand(outStats);
+
+            const MIntPoint baseIndex2D = inGrid->GetTileIndex2D(baseIndex);
+            const MINT32 baseDistance_G = nodeTable.GetNode(baseIndex).GetDistance_G();
+
+            ForEachNeighbor<NEIGHBOR>(baseIndex2D, IsTargetWalkable, [&](const MIntPoint& inTargetIndex2D, MINT32 inDistance)
             {
-                MNode* currentNode = findIter->second;
-                while (nullptr != currentNode)
-                {
-                    inList.push_back(currentNode->GetIndex2D());
-                    currentNode = currentNode->GetPrevNode();
+                const MINT32 targetIndex = inGrid->GetTileIndex(inTargetIndex2D);
+                if (MTRUE == nodeTable.IsClose(targetIndex)) {
+                    return;
                 }
-            }
 
-            // 역순으로 변경
-            std::reverse(inList.begin(), inList.end());
+                // 거꾸로 따라가는 경우 대상 노드에서 기본 노드로 들어가는 비용
+                const MINT32 distance_G = baseDistance_G + (2 * BidirectionalTieScale * COST::GetMoveCost(inGrid, (MTRUE == inIsBackward) ? baseIndex : targetIndex, inDistance));
+                if (MTRUE == nodeTable.IsVisited(targetIndex) && nodeTable.GetNode(targetIndex).GetDistance_G() <= distance_G) {
+                    return;
+                }
+
+                MNode& targetNode = nodeTable.VisitNode(targetIndex, GetBidirectionalDistance_H<NEIGHBOR>(inIsBackward, targetIndex, inTargetIndex2D));
+                targetNode.SetDistance_G(distance_G);
+                targetNode.SetPrevIndex(baseIndex);
+
+                if (MTRUE == openList.IsContain(targetIndex)) {
+                    openList.Update(targetIndex);
+                    MSearchStatsPolicy::AddUpdate(outStats);
+                }
+                else {
+                    openList.Push(targetIndex);
+                    MSearchStatsPolicy::AddPush(outStats, openList.GetCount());
+                }
+
+                touchList.push_back(targetIndex);
+            });
         }
 
-        // 반납
+        return expandCount;
+    }
+
+    template<typename NEIGHBOR>
+    MINT32 MPathFinder::GetBidirectionalDistance_H(MBOOL inIsBackward, MINT32 inIndex, const MIntPoint& inIndex2D) const
+    {
+        MINT32 endDistanceH = NEIGHBOR::GetDistance_H(abs(EndIndex2D.X - inIndex2D.X), abs(EndIndex2D.Y - inIndex2D.Y));
+        MINT32 startDistanceH = NEIGHBOR::GetDistance_H(abs(StartIndex2D.X - inIndex2D.X), abs(StartIndex2D.Y - inIndex2D.Y));
+
+        // 랜드마크 거리는 상하좌우 이동 기준이므로 대각선 이동에는 사용하지 않는다
+        if (MFALSE == NEIGHBOR::IsDiagonal && nullptr != SearchLandmarkMap)
         {
-            // 사용했던 노드는 풀에 반납
-            for (auto pair : UseNodeMap) {
-                NodePool.push(pair.second);
-            }
+            endDistanceH = std::max(endDistanceH, SearchLandmarkMap->GetHeuristic(inIndex, EndIndex));
+            startDistanceH = std::max(startDistanceH, SearchLandmarkMap->GetHeuristic(inIndex, StartIndex));
+        }
+
+        //----------------------------------------------------------------
+        // 열린 지형은 비용이 같은 최단 경로가 많아서 양쪽이 서로 다른 경로로 진행하면 끝 근처에서야 만난다
+        // 양쪽 모두 시작 ~ 종료 직선에 가까운 노드를 먼저 확장하도록 직선에서 떨어진 거리를 더해서
+        // 같은 경로를 따라가다가 가운데에서 만나게 한다 (양쪽이 같은 값을 더한다)
+        //----------------------------------------------------------------
+        const MINT32 lineX = EndIndex2D.X - StartIndex2D.X;
+        const MINT32 lineY = EndIndex2D.Y - StartIndex2D.Y;
+        const MINT32 lineLength = std::max(std::max(abs(lineX), abs(lineY)), 1);
+        const MINT32 lineOffset = std::min(abs(((inIndex2D.X - StartIndex2D.X) * lineY) - ((inIndex2D.Y - StartIndex2D.Y) * lineX)) / lineLength, BidirectionalTieScale - 1);
+
+        const MINT32 distanceH = (MTRUE == inIsBackward) ? (startDistanceH - endDistanceH) : (endDistanceH - startDistanceH);
+        return (BidirectionalTieScale * distanceH) + lineOffset;
+    }
+
+    void MPathFinder::UpdateMeetNode(MBOOL inIsBackward)
+    {
+        const MNodeTable& nodeTable = (MTRUE == inIsBackward) ? BackwardNodeTable : NodeTable;
+        const MNodeTable& otherNodeTable = (MTRUE == inIsBackward) ? NodeTable : BackwardNodeTable;
+        std::vector<MINT32>& touchList = (MTRUE == inIsBackward) ? BackwardTouchList : ForwardTouchList;
 
-            UseNodeMap.clear();
+        for (const MINT32 index : touchList)
+        {
+            if (MFALSE == otherNodeTable.IsVisited(index)) {
+                continue;
+            }
 
-            // 데이터 셋 제거
-            OpenNodeSet.clear();
+            const MINT32 distance = nodeTable.GetNode(index).GetDistance_G() + otherNodeTable.GetNode(index).GetDistance_G();
+            if (distance < MeetDistance)
+            {
+                MeetDistance = distance;
+                MeetIndex = index;
+            }
         }
+
+        touchList.clear();
     }
 
-    void MPathFinder::FindPath(std::vector<MVector2>& inList, const MVector2& inGridPos, float inTileSize, const MGrid* inGrid, const MVector2& inStartPos, const MVector2& inEndPos, MFLOAT inRadius)
+    MBOOL MPathFinder::IsBidirectionalFinish() const
     {
-        inList.clear();
+        if (MTRUE == OpenList.IsEmpty() || MTRUE == BackwardOpenList.IsEmpty()) {
+            return MTRUE;
+        }
 
-        // 시작 / 종료 위치 인덱스를 구한다
-        MIntPoint startIndex2D = GetIndex2DByPosition(inGridPos, inTileSize, inStartPos);
-        MIntPoint endIndex2D = GetIndex2DByPosition(inGridPos, inTileSize, inEndPos);
+        const MINT32 forwardDistance_F = NodeTable.GetNode(OpenList.Top()).GetDistance_F();
+        const MINT32 backwardDistance_F = BackwardNodeTable.GetNode(BackwardOpenList.Top()).GetDistance_F();
 
-        // 동일 위치인경우 그냥 결과 위치로 이동
-        if (startIndex2D == endIndex2D)
+        return MeetDistance - BidirectionalFinishMargin <= forwardDistance_F + backwardDistance_F;
+    }
+
+    void MPathFinder::BackwardWorkerLoop()
+    {
+        MBackwardWorker& worker = *BackwardWorker;
+        MINT32 workRound = 0;
+
+        while (MTRUE)
         {
-            inList.push_back(inEndPos);
+            std::unique_lock<std::mutex> lock(worker.Mutex);
+            worker.Condition.wait(lock, [&]() { return MTRUE == worker.IsStop || workRound != worker.Round; });
+
+            if (MTRUE == worker.IsStop) {
+                return;
+            }
+
+            workRound = worker.Round;
+            const MINT32 bound = worker.Bound;
+            lock.unlock();
+
+            const MINT32 expandCount = worker.Job(bound);
+
+            lock.lock();
+            worker.ExpandCount += expandCount;
+            worker.FinishRound = workRound;
+            worker.Condition.notify_all();
+        }
+    }
+
+    template<typename GRID, typename SINK>
+    void MPathFinder::BuildBidirectionalPath(SINK& outPath, const GRID* inGrid)
+    {
+        // 양쪽 검색이 만나지 못했다
+        if (MeetIndex < 0) {
             return;
         }
 
-        // 인덱스 리스트를 구한다
-        std::vector<MIntPoint> index2DList;
-        FindPath(index2DList, inGrid, startIndex2D, endIndex2D);
+        // 만나는 지점 다음부터 종료 위치까지는 종료 위치쪽 저장소의 이전 노드를 따라간다
+        const MINT32 backwardBeginIndex = (MeetIndex == EndIndex) ? -1 : BackwardNodeTable.GetNode(MeetIndex).GetPrevIndex();
 
-        if (MTRUE == index2DList.empty()) {
-            return;
+        // 양쪽 타일 수를 먼저 구한다
+        MINT32 forwardCount = 0;
+        for (MINT32 index = MeetIndex; 0 <= index; index = NodeTable.GetNode(index).GetPrevIndex()) {
+            ++forwardCount;
         }
 
-        // 리스트를 돌면서 중앙 지점을 구한다
-        const MINT32 count = index2DList.size();
-        std::vector<MVector2> positionList;
-        positionList.resize(count);
+        MINT32 backwardCount = 0;
+        for (MINT32 index = backwardBeginIndex; 0 <= index; index = BackwardNodeTable.GetNode(index).GetPrevIndex()) {
+            ++backwardCount;
+        }
 
-        for (MINT32 i = 0; i < count; ++i) {
-            positionList[i] = GetCenterPosByIndex2D(inGridPos, inTileSize, index2DList[i]);
+        const MINT32 baseCount = outPath.GetCount();
+        outPath.Resize(baseCount + forwardCount + backwardCount);
+
+        // 만나는 지점에서 시작 위치까지는 뒤에서부터 채운다
+        MINT32 writeIndex = baseCount + forwardCount - 1;
+        for (MINT32 index = MeetIndex; 0 <= index; index = NodeTable.GetNode(index).GetPrevIndex()) {
+            outPath.Set(writeIndex--, inGrid->GetTileIndex2D(index));
         }
 
-        // 마지막 위치는 종료 위치
-        if (0 < count) {
-            positionList[count - 1] = inEndPos;
+        writeIndex = baseCount + forwardCount;
+        for (MINT32 index = backwardBeginIndex; 0 <= index; index = BackwardNodeTable.GetNode(index).GetPrevIndex()) {
+            outPath.Set(writeIndex++, inGrid->GetTileIndex2D(index));
         }
-        
+    }
 
-        // OBB 체크
+    //----------------------------------------------------------------
+    // Theta*
+    // 확장하는 노드의 부모에서 대상 노드가 보인다면 부모에 바로 연결해서
+    // 검색이 끝나면 별도의 다듬기 없이 직선 경로가 된다
+    //----------------------------------------------------------------
+    void MPathFinder::UpdateThetaStarNode(const MGrid* inGrid, MINT32 inBaseIndex, const MAnyAngleSearch& inAnyAngle)
+    {
+        const MIntPoint baseIndex2D = inGrid->GetTileIndex2D(inBaseIndex);
+        const MNode& baseNode = NodeTable.GetNode(inBaseIndex);
+        const MINT32 baseDistance_G = baseNode.GetDistance_G();
 
-        // 마지막 인덱스
-        const MINT32 lastIndex = positionList.size() - 1;
+        // 부모 노드 정보 (시작 노드는 부모가 없다)
+        const MINT32 parentIndex = baseNode.GetPrevIndex();
+        MIntPoint parentIndex2D;
+        MVector2 parentPos;
+        MINT32 parentDistance_G = 0;
 
-        // 시작점 추가
-        inList.push_back(inStartPos);
+        if (0 <= parentIndex)
+        {
+            parentIndex2D = inGrid->GetTileIndex2D(parentIndex);
+            parentPos = GetCenterPosByIndex2D(inAnyAngle.GridPos, inAnyAngle.TileSize, parentIndex2D);
+            parentDistance_G = NodeTable.GetNode(parentIndex).GetDistance_G();
+        }
 
-        //
-        MINT32 checkIndex = 0;
-        while (lastIndex != checkIndex)
+        const MIntPoint directionList[4] = { MIntPoint(-1, 0), MIntPoint(1, 0), MIntPoint(0, -1), MIntPoint(0, 1) };
+        for (const MIntPoint& direction : directionList)
         {
-            MBOOL isCollision = MTRUE;
+            const MIntPoint targetIndex2D = baseIndex2D + direction;
+
+            // 대상 타일이 없거나 막힌경우 넘어간다
+            if (MFALSE == IsWalkable(inGrid, targetIndex2D.X, targetIndex2D.Y)) {
+                continue;
+            }
+
+            // 닫힌노드인경우 넘어간다
+            const MINT32 targetIndex = inGrid->GetTileIndex(targetIndex2D);
+            if (MTRUE == NodeTable.IsClose(targetIndex)) {
+                continue;
+            }
 
-            for(MINT32 i = lastIndex; checkIndex < i; --i)
+            // 부모 노드에서 보인다면 부모 노드에 바로 연결
+            if (0 <= parentIndex)
             {
-                if (MFALSE == CheckBlockLine(inGridPos, inTileSize, inGrid, positionList[checkIndex], positionList[i], inRadius))
+                const MVector2 targetPos = GetCenterPosByIndex2D(inAnyAngle.GridPos, inAnyAngle.TileSize, targetIndex2D);
+                if (MFALSE == CheckBlockLine(inAnyAngle.GridPos, inAnyAngle.TileSize, inGrid, parentPos, targetPos, inAnyAngle.Radius))
                 {
-                    checkIndex = i;
-                    inList.push_back(positionList[i]);
-                    isCollision = MFALSE;
-                    break;
+                    UpdateNodeDistance(targetIndex2D, targetIndex, parentIndex, parentDistance_G + GetLineDistance(parentIndex2D, targetIndex2D), MTRUE);
+                    continue;
                 }
             }
 
-            if (MTRUE == isCollision)
-            {
-                ++checkIndex;
-                inList.push_back(positionList[checkIndex]);
-            }
+            UpdateNodeDistance(targetIndex2D, targetIndex, inBaseIndex, baseDistance_G + GetGridDistanceByDirection(direction.X, direction.Y), MTRUE);
         }
     }
 
+    MINT32 MPathFinder::GetLineDistance(const MIntPoint& inIndex2D1, const MIntPoint& inIndex2D2)
+    {
+        const MFLOAT x = static_cast<MFLOAT>(inIndex2D1.X - inIndex2D2.X);
+        const MFLOAT y = static_cast<MFLOAT>(inIndex2D1.Y - inIndex2D2.Y);
+
+        // 다른 거리값과 같이 10배 정수값 (예상 거리로도 쓰이므로 내림)
+        return static_cast<MINT32>(std::sqrt((x * x) + (y * y)) * 10.0f);
+    }
 
-    MNode *MPathFinder::GetNode(const MIntPoint& inIndex2D)
+    void MPathFinder::UpdateNodeDistance(const MIntPoint& inTargetIndex2D, MINT32 inTargetIndex, MINT32 inBaseIndex, MINT32 inDistance_G, MBOOL inIsAnyAngle)
     {
-        // 현재 사용하는 맵에 있는지 체크
-        auto findIter = UseNodeMap.find(inIndex2D);
-        if (UseNodeMap.end() != findIter)
+        // 대상 노드를 얻는다
+        MNode& targetNode = GetNode(inTargetIndex, inTargetIndex2D, inIsAnyAngle);
+
+        // 기존에 설정되어있던 거리보다 적다면 이동 정보를 갱신해준다
+        if (inDistance_G < targetNode.GetDistance_G())
         {
-            // 이미 존재한다면 그거 리턴
-            return findIter->second;
+            targetNode.SetDistance_G(inDistance_G);
+            targetNode.SetPrevIndex(inBaseIndex);
+
+            // 열린 리스트에 추가 / 위치 갱신
+            if (MTRUE == OpenList.IsContain(inTargetIndex)) {
+                OpenList.Update(inTargetIndex);
+                MSearchStatsPolicy::AddUpdate(Stats);
+            }
+            else {
+                OpenList.Push(inTargetIndex);
+                MSearchStatsPolicy::AddPush(Stats, OpenList.GetCount());
+            }
         }
+    }
+
+    //----------------------------------------------------------------
+    // Jump Point Search (4방향)
+    // 세로로 이동하는 중에는 가로 방향을 같이 살펴보고
+    // 가로로 이동하는 중에는 강제 이웃이 생기는 지점에서만 멈춘다
+    // 가로 점프는 이동 가능한 타일 비트 행으로 64칸씩 검사한다
+    //----------------------------------------------------------------
+    void MPathFinder::UpdateJumpPointNode(const MGrid* inGrid, MINT32 inBaseIndex)
+    {
+        const MIntPoint baseIndex2D = inGrid->GetTileIndex2D(inBaseIndex);
+        const MNode& baseNode = NodeTable.GetNode(inBaseIndex);
+        const MINT32 baseDistance_G = baseNode.GetDistance_G();
 
-        // 없다면 풀에서 가져옴
-        MNode *node = nullptr;
-        if (false == NodePool.empty())
+        // 체크할 방향 목록
+        MIntPoint directionList[4];
+        MINT32 directionCount = 0;
+
+        const MINT32 prevIndex = baseNode.GetPrevIndex();
+        if (prevIndex < 0)
         {
-            node = NodePool.top();
-            NodePool.pop();
+            // 시작 노드는 모든 방향
+            directionList[directionCount++] = MIntPoint(1, 0);
+            directionList[directionCount++] = MIntPoint(-1, 0);
+            directionList[directionCount++] = MIntPoint(0, 1);
+            directionList[directionCount++] = MIntPoint(0, -1);
         }
         else
         {
-            // 없다면 새로 추가
-            node = new MNode();
+            const MIntPoint prevIndex2D = inGrid->GetTileIndex2D(prevIndex);
+            const MINT32 dirX = (baseIndex2D.X > prevIndex2D.X) - (baseIndex2D.X < prevIndex2D.X);
+            const MINT32 dirY = (baseIndex2D.Y > prevIndex2D.Y) - (baseIndex2D.Y < prevIndex2D.Y);
+
+            if (0 != dirX)
+            {
+                // 가로 이동중이라면 진행 방향과 위 / 아래
+                directionList[directionCount++] = MIntPoint(dirX, 0);
+                directionList[directionCount++] = MIntPoint(0, 1);
+                directionList[directionCount++] = MIntPoint(0, -1);
+            }
+            else
+            {
+                // 세로 이동중이라면 진행 방향과 좌 / 우
+                directionList[directionCount++] = MIntPoint(0, dirY);
+                directionList[directionCount++] = MIntPoint(1, 0);
+                directionList[directionCount++] = MIntPoint(-1, 0);
+            }
         }
 
-        // 사용 맵에 추가
-        UseNodeMap.emplace(std::make_pair(inIndex2D, node));
+        for (MINT32 i = 0; i < directionCount; ++i)
+        {
+            const MIntPoint& direction = directionList[i];
 
-        // 결과 까지의 거리를 얻는다
-        // 맨허튼 거리 측정
-        MINT32 distanceH = (abs(EndIndex2D.X - inIndex2D.X) * 10) + (abs(EndIndex2D.Y - inIndex2D.Y) * 10);
-        
-        // 초기화
-        node->InitNode(inIndex2D, distanceH);
+            const MINT32 jumpIndex = FindJumpPoint(inGrid, baseIndex2D.X + direction.X, baseIndex2D.Y + direction.Y, direction.X, direction.Y);
+            if (jumpIndex < 0) {
+                continue;
+            }
 
-        return node;
+            if (MTRUE == NodeTable.IsClose(jumpIndex)) {
+                continue;
+            }
+
+            // 점프 포인트까지는 직선이므로 칸수만큼 거리를 더한다
+            const MIntPoint jumpIndex2D = inGrid->GetTileIndex2D(jumpIndex);
+            const MINT32 jumpDistance = (abs(jumpIndex2D.X - baseIndex2D.X) + abs(jumpIndex2D.Y - baseIndex2D.Y)) * GetGridDistanceByDirection(direction.X, direction.Y);
+
+            UpdateNodeDistance(jumpIndex2D, jumpIndex, inBaseIndex, baseDistance_G + jumpDistance, MFALSE);
+        }
     }
 
+    MINT32 MPathFinder::FindJumpPoint(const MGrid* inGrid, MINT32 inX, MINT32 inY, MINT32 inDirX, MINT32 inDirY)
+    {
+        if (0 != inDirX)
+        {
+            const MINT32 jumpX = FindJumpPoint_Horizontal(inGrid, inX, inY, inDirX);
+            return (jumpX < 0) ? -1 : inGrid->GetTileIndex(MIntPoint(jumpX, inY));
+        }
+
+        const MINT32 x = inX;
+        const MINT32 width = inGrid->TileCount.X;
+
+        for (MINT32 y = inY; ; y += inDirY)
+        {
+            const MUINT64* rowBits = GetJumpRowBits(inGrid, y);
+            if (MFALSE == IsJumpRowBit(rowBits, x, width)) {
+                return -1;
+            }
+
+            const MIntPoint index2D(x, y);
+            if (index2D == EndIndex2D) {
+                return inGrid->GetTileIndex(index2D);
+            }
+
+            // 뒤쪽이 막혀있다가 열리는 좌 / 우 타일이 있다면 멈춘다
+            const MUINT64* backBits = GetJumpRowBits(inGrid, y - inDirY);
+            if ((MTRUE == IsJumpRowBit(rowBits, x - 1, width) && MFALSE == IsJumpRowBit(backBits, x - 1, width)) ||
+                (MTRUE == IsJumpRowBit(rowBits, x + 1, width) && MFALSE == IsJumpRowBit(backBits, x + 1, width))) {
+                return inGrid->GetTileIndex(index2D);
+            }
+
+            // 가로 방향에 점프 포인트가 있다면 여기서 꺾어야 한다
+            if (0 <= FindJumpPoint_Horizontal(inGrid, x + 1, y, 1) ||
+                0 <= FindJumpPoint_Horizontal(inGrid, x - 1, y, -1)) {
+                return inGrid->GetTileIndex(index2D);
+            }
+        }
+    }
 
     //----------------------------------------------------------------
-    // 루프를 돌면서 F가 가장 작은걸 찾는다
+    // 가로 점프
+    // 뒤쪽이 막혀있다가 열리는 위 / 아래 타일(강제 이웃)이 있거나 종료 타일이면 멈추므로
+    // 위 / 아래 행을 한칸 밀어서 멈추는 비트를 만들고 막힌 타일과 함께 진행 방향으로 처음 나오는 비트를 찾는다
     //----------------------------------------------------------------
-    MNode* MPathFinder::GetNextCheckNode()
+    MINT32 MPathFinder::FindJumpPoint_Horizontal(const MGrid* inGrid, MINT32 inX, MINT32 inY, MINT32 inDirX)
     {
-        MINT32 minValue = INFINITY_DISTANCE;
-        MNode* nextNode = nullptr;
+        if (inY < 0 || inGrid->TileCount.Y <= inY) {
+            return -1;
+        }
 
-        for (auto targetNode : OpenNodeSet)
+        // 통로에서는 바로 옆이 막혀있는 경우가 많으므로 먼저 체크
+        const MUINT64* rowBits = GetJumpRowBits(inGrid, inY);
+        if (MFALSE == IsJumpRowBit(rowBits, inX, inGrid->TileCount.X)) {
+            return -1;
+        }
+
+        const MUINT64* upBits = GetJumpRowBits(inGrid, inY - 1);
+        const MUINT64* downBits = GetJumpRowBits(inGrid, inY + 1);
+
+        const MINT32 lastWord = JumpRowWordCount - 1;
+        const MINT32 endWord = (inY == EndIndex2D.Y) ? (EndIndex2D.X / 64) : -1;
+
+        // 시작 위치 뒤쪽의 비트는 제외
+        const MINT32 startBit = inX % 64;
+        MUINT64 mask = (0 < inDirX) ? (~static_cast<MUINT64>(0) << startBit) : (~static_cast<MUINT64>(0) >> (63 - startBit));
+
+        for (MINT32 word = inX / 64; 0 <= word && word <= lastWord; word += inDirX)
         {
-           const MINT32 distanceF = targetNode->GetDistance_F();
-            
-            if (distanceF < minValue)
+            // 진행 방향 뒤쪽 칸의 위 / 아래 타일 (행 밖은 막힘)
+            MUINT64 upBackBits = 0;
+            MUINT64 downBackBits = 0;
+
+            if (0 < inDirX)
+            {
+                upBackBits = (upBits[word] << 1) | ((0 < word) ? (upBits[word - 1] >> 63) : 0);
+                downBackBits = (downBits[word] << 1) | ((0 < word) ? (downBits[word - 1] >> 63) : 0);
+            }
+            else
+            {
+                upBackBits = (upBits[word] >> 1) | ((word < lastWord) ? (upBits[word + 1] << 63) : 0);
+                downBackBits = (downBits[word] >> 1) | ((word < lastWord) ? (downBits[word + 1] << 63) : 0);
+            }
+
+            MUINT64 stopBits = (upBits[word] & ~upBackBits) | (downBits[word] & ~downBackBits);
+            if (word == endWord) {
+                stopBits |= static_cast<MUINT64>(1) << (EndIndex2D.X % 64);
+            }
+
+            const MUINT64 bits = (stopBits | ~rowBits[word]) & mask;
+            if (0 != bits)
             {
-                minValue = distanceF;
-                nextNode = targetNode;
+                // 막힌 타일을 먼저 만났다면 점프 포인트가 없다
+                const MINT32 bit = (0 < inDirX) ? MBitGrid::GetLowestBit(bits) : MBitGrid::GetHighestBit(bits);
+                return (0 != ((rowBits[word] >> bit) & 1)) ? ((word * 64) + bit) : -1;
             }
+
+            mask = ~static_cast<MUINT64>(0);
         }
 
-        return nextNode;
+        return -1;
     }
 
-    void MPathFinder::UpdateAroundNode(const MGrid* inGrid, MNode* inBaseNode)
+    void MPathFinder::BeginJumpRowSearch(const MGrid* inGrid)
     {
-        // 기본 인덱스 정보
-        const MIntPoint baseIndex2D = inBaseNode->GetIndex2D();
-        const MINT32 baseDistance_G = inBaseNode->GetDistance_G();
+        JumpRowWordCount = (inGrid->TileCount.X + 63) / 64;
 
-        // 주변 노드 루프
-        for (MINT32 x = -1; x <= 1; ++x)
+        const size_t bitCount = static_cast<size_t>(JumpRowWordCount) * (inGrid->TileCount.Y + 1);
+
+        // 크기가 바뀌었거나 세대값이 한바퀴 돌았다면 초기화 (맨 앞의 빈 행은 항상 0)
+        if (JumpRowBitList.size() != bitCount || JumpRowStampList.size() != static_cast<size_t>(inGrid->TileCount.Y) || 0 == JumpRowStamp + 1)
         {
-            for (MINT32 y = -1; y <= 1; ++y)
-            {
-                // 자신의 노드인경우는 넘어간다
-                if (0 == x && 0 == y) {
-                    continue;
-                }
+            JumpRowBitList.assign(bitCount, 0);
+            JumpRowStampList.assign(inGrid->TileCount.Y, 0);
+            JumpRowStamp = 0;
+        }
 
-                // 대각선을 처리하지 않는다
-                if (0 != x && 0 != y) {
-                    continue;
-                }
+        ++JumpRowStamp;
+    }
 
+    const MUINT64* MPathFinder::GetJumpRowBits(const MGrid* inGrid, MINT32 inY)
+    {
+        if (inY < 0 || inGrid->TileCount.Y <= inY) {
+            return JumpRowBitList.data();
+        }
 
-                // 대상 인덱스 정보
-                const MIntPoint targetIndex2D = baseIndex2D + MIntPoint(x, y);
+        MUINT64* bits = JumpRowBitList.data() + (static_cast<size_t>(inY + 1) * JumpRowWordCount);
 
-                // 대상 노드를 얻는다
-                MNode* targetNode = GetNode(targetIndex2D);
+        if (JumpRowStamp != JumpRowStampList[inY])
+        {
+            JumpRowStampList[inY] = JumpRowStamp;
 
-                // 닫힌노드인경우 넘어간다
-                if (MTRUE == targetNode->GetIsClose()) {
-                    continue;
-                }
+            // 행 끝의 여분 비트는 막힘
+            const MINT32 width = inGrid->TileCount.X;
+            const MTile* tileList = inGrid->TileList.data() + (static_cast<size_t>(inY) * width);
 
-                // 체크할 타일
-                const MTile* checkTile = inGrid->GetTile(targetIndex2D);
-                if (nullptr == checkTile) {
-                    continue;
-                }
+            for (MINT32 word = 0; word < JumpRowWordCount; ++word)
+            {
+                const MINT32 count = std::min(64, width - (word * 64));
 
-                // 대상 타일이 막힌경우 넘어간다
-                if (MTRUE == checkTile->IsBlocked) {
-                    continue;
+                MUINT64 wordBits = 0;
+                for (MINT32 i = 0; i < count; ++i) {
+                    wordBits |= static_cast<MUINT64>(MFALSE == tileList[(word * 64) + i].IsBlocked) << i;
                 }
 
-                // 대상 노드는 열린 노드에 추가
-                OpenNodeSet.insert(targetNode);
-
-                //----------------------------------------------------------------
-                // 거리를 체크해서 가까운경우 이동 정보를 갱신
-                //----------------------------------------------------------------
-                
-                // 거리를 얻는다
-                const MINT32 gridDistance = GetGridDistanceByDirection(x, y);
-
-                // 대상의 현재 시작
-                const MINT32 targetDistance_G = targetNode->GetDistance_G();
-
-                // 기본노드를 거쳐서 대상 노드까지의 거리를 구한다
-                const MINT32 newTargetDistance_G = baseDistance_G + gridDistance;
+                bits[word] = wordBits;
+            }
 
-                // 기존에 설정되어있던 거리보다 적다면 이동 정보를 갱신해준다
-                if (newTargetDistance_G < targetDistance_G)
+            // 여유 공간이 부족한 타일은 막힘 (종료 타일은 제외)
+            if (1 < RequiredClearance)
+            {
+                for (MINT32 x = 0; x < width; ++x)
                 {
-                    targetNode->SetDistance_G(newTargetDistance_G);
-                    targetNode->SetPrevNode(inBaseNode);
+                    if (MFALSE == IsWalkable(inGrid, x, inY)) {
+                        bits[x / 64] &= ~(static_cast<MUINT64>(1) << (x % 64));
+                    }
                 }
             }
         }
-    }
 
-   
+        return bits;
+    }
 
     MINT32 MPathFinder::GetGridDistanceByDirection(MINT32 inX, MINT32 inY)
     {
@@ -395,9 +1614,13 @@ namespace MAstar
     {
         MCollision::MBox2D box1(inStart, inEnd, inRadius);
 
+        MSearchStatsPolicy::AddBlockLine(Stats);
+
+#if !defined(MASTAR_DISABLE_DEBUG_DRAW)
         if (nullptr != OnDrawBlockLine) {
             OnDrawBlockLine(box1);
         }
+#endif
      
         MIntPoint startIndex2D = GetIndex2DByPosition(inGridPos, inTileSize, inStart);
         MIntPoint endIndex2D = GetIndex2DByPosition(inGridPos, inTileSize, inEnd);
@@ -415,38 +1638,136 @@ namespace MAstar
             std::swap(startY, endY);
         }
 
-        for (MINT32 x = startX; x <= endX; ++x)
+        // 박스 외곽선 (시계 방향)
+        const MVector2 cornerList[4] = { box1.LT, box1.RT, box1.RB, box1.LB };
+
+        // 충돌 체크용 박스 정보는 한번만 계산
+        const MCollision::MOBB2D lineBox(box1);
+
+        // 경계에 닿는 경우도 충돌이므로 행 범위를 조금 넓혀서 계산
+        const MFLOAT epsilon = inTileSize * 0.001f;
+
+        // 행마다 박스가 지나가는 열 범위의 타일만 체크
+        for (MINT32 y = startY; y <= endY; ++y)
         {
-            for (MINT32 y = startY; y <= endY; ++y)
+            const MFLOAT rowTop = inGridPos.Y + (inTileSize * y) - epsilon;
+            const MFLOAT rowBottom = rowTop + inTileSize + (epsilon * 2);
+
+            MINT32 rowStartX = startX;
+            MINT32 rowEndX = endX;
+
+            // 두께가 없는 박스는 OBB 체크시 옆 방향으로 분리되지 않으므로 사각형 전체를 체크 (기존 결과 유지)
+            if (0 < inRadius)
+            {
+                MFLOAT minX = 0;
+                MFLOAT maxX = 0;
+                if (MFALSE == GetBoxRangeX(cornerList, rowTop, rowBottom, minX, maxX)) {
+                    continue;
+                }
+
+                // 경계에 걸친 타일을 위해 양쪽으로 한칸씩 여유를 둔다
+                rowStartX = std::max(startX, static_cast<MINT32>(std::floor((minX - inGridPos.X) / inTileSize)) - 1);
+                rowEndX = std::min(endX, static_cast<MINT32>(std::floor((maxX - inGridPos.X) / inTileSize)) + 1);
+            }
+
+            for (MINT32 x = rowStartX; x <= rowEndX; ++x)
             {
 				MVector2 leftTop = GetLeftTopPosByIndex2D(inGridPos, inTileSize, MIntPoint(x, y));
 
-				MCollision::MBox2D box2(
-					leftTop,
-					leftTop + MVector2(inTileSize, 0),
-					leftTop + MVector2(0, inTileSize),
-					leftTop + MVector2(inTileSize, inTileSize)
-				);
+#if !defined(MASTAR_DISABLE_DEBUG_DRAW)
+                if (nullptr != OnDrawCheckBlock)
+                {
+                    OnDrawCheckBlock(MCollision::MBox2D(
+                        leftTop,
+                        leftTop + MVector2(inTileSize, 0),
+                        leftTop + MVector2(0, inTileSize),
+                        leftTop + MVector2(inTileSize, inTileSize)
+                    ));
+                }
+#endif
 
-                if (nullptr != OnDrawCheckBlock) {
-                    OnDrawCheckBlock(box2);
+                // 장애물인 경우만 충돌 체크
+                const MAstar::MTile* tile = inGrid->GetTile(x, y);
+                if (nullptr == tile || MFALSE == tile->IsBlocked) {
+                    continue;
                 }
 
-                if (MTRUE == MCollision::CheckOBB(box1, box2))
-                {
-                    // 충돌한다면 대상 그리드가 장애물인지 체크
-                    if (const MAstar::MTile* tile = inGrid->GetTile(x, y))
-                    {
-                        if (MTRUE == tile->IsBlocked) {
-                            return MTRUE;
-                        }
-                    }
+                // 타일은 축 정렬 박스이므로 바로 만든다 (경계에 닿는 경우의 결과가 같도록 MBox2D와 같은 방식으로 크기를 구한다)
+                const MVector2 tileSize((leftTop.X + inTileSize) - leftTop.X, (leftTop.Y + inTileSize) - leftTop.Y);
+                const MCollision::MOBB2D tileBox(leftTop + (tileSize * 0.5f), MVector2(1, 0), MVector2(0, 1), tileSize.X * 0.5f, tileSize.Y * 0.5f);
+
+                MSearchStatsPolicy::AddCheckOBB(Stats);
+                if (MTRUE == MCollision::CheckOBB(lineBox, tileBox)) {
+                    return MTRUE;
                 }
             }
         }
 
         return MFALSE;
     }
+
+    MBOOL MPathFinder::GetBoxRangeX(const MVector2* inCornerList, MFLOAT inTop, MFLOAT inBottom, MFLOAT& outMinX, MFLOAT& outMaxX)
+    {
+        MBOOL isValid = MFALSE;
+
+        auto AddFunc = [&isValid, &outMinX, &outMaxX](MFLOAT inX)
+        {
+            if (MFALSE == isValid)
+            {
+                outMinX = inX;
+                outMaxX = inX;
+                isValid = MTRUE;
+                return;
+            }
+
+            outMinX = std::min(outMinX, inX);
+            outMaxX = std::max(outMaxX, inX);
+        };
+
+        for (MINT32 i = 0; i < 4; ++i)
+        {
+            const MVector2& p1 = inCornerList[i];
+            const MVector2& p2 = inCornerList[(i + 1) % 4];
+
+            // 범위 안의 꼭지점
+            if (inTop <= p1.Y && p1.Y <= inBottom) {
+                AddFunc(p1.X);
+            }
+
+            // 변이 범위의 위 / 아래 선을 지나는 지점
+            for (const MFLOAT lineY : { inTop, inBottom })
+            {
+                if ((p1.Y < lineY && lineY < p2.Y) || (p2.Y < lineY && lineY < p1.Y)) {
+                    AddFunc(p1.X + ((lineY - p1.Y) * (p2.X - p1.X) / (p2.Y - p1.Y)));
+                }
+            }
+        }
+
+        return isValid;
+    }
+
+    //----------------------------------------------------------------
+    // 검색 루프 인스턴스화 (MBitGrid는 균일 비용만 사용)
+    //----------------------------------------------------------------
+    template void MPathFinder::SearchPath<MGrid, MNeighbor4, MUniformCost>(const MGrid*, MINT32);
+    template void MPathFinder::SearchPath<MGrid, MNeighbor8<2>, MUniformCost>(const MGrid*, MINT32);
+    template void MPathFinder::SearchPath<MGrid, MNeighbor8<1>, MUniformCost>(const MGrid*, MINT32);
+    template void MPathFinder::SearchPath<MGrid, MNeighbor4, MTileCost>(const MGrid*, MINT32);
+    template void MPathFinder::SearchPath<MGrid, MNeighbor8<2>, MTileCost>(const MGrid*, MINT32);
+    template void MPathFinder::SearchPath<MGrid, MNeighbor8<1>, MTileCost>(const MGrid*, MINT32);
+    template void MPathFinder::SearchPath<MBitGrid, MNeighbor4, MUniformCost>(const MBitGrid*, MINT32);
+    template void MPathFinder::SearchPath<MBitGrid, MNeighbor8<2>, MUniformCost>(const MBitGrid*, MINT32);
+    template void MPathFinder::SearchPath<MBitGrid, MNeighbor8<1>, MUniformCost>(const MBitGrid*, MINT32);
+
+    template void MPathFinder::SearchBidirectional<MGrid, MNeighbor4, MUniformCost>(const MGrid*, MINT32, MINT32);
+    template void MPathFinder::SearchBidirectional<MGrid, MNeighbor8<2>, MUniformCost>(const MGrid*, MINT32, MINT32);
+    template void MPathFinder::SearchBidirectional<MGrid, MNeighbor8<1>, MUniformCost>(const MGrid*, MINT32, MINT32);
+    template void MPathFinder::SearchBidirectional<MGrid, MNeighbor4, MTileCost>(const MGrid*, MINT32, MINT32);
+    template void MPathFinder::SearchBidirectional<MGrid, MNeighbor8<2>, MTileCost>(const MGrid*, MINT32, MINT32);
+    template void MPathFinder::SearchBidirectional<MGrid, MNeighbor8<1>, MTileCost>(const MGrid*, MINT32, MINT32);
+    template void MPathFinder::SearchBidirectional<MBitGrid, MNeighbor4, MUniformCost>(const MBitGrid*, MINT32, MINT32);
+    template void MPathFinder::SearchBidirectional<MBitGrid, MNeighbor8<2>, MUniformCost>(const MBitGrid*, MINT32, MINT32);
+    template void MPathFinder::SearchBidirectional<MBitGrid, MNeighbor8<1>, MUniformCost>(const MBitGrid*, MINT32, MINT32);
 };
 
 
@@ -1,7 +1,8 @@
 ﻿#pragma once
 
-#include <set>
 #include <vector>
+#include <chrono>
+#include <memory>
 #include <functional>
 
 #include "MPrerequisites.h"
@@ -26,6 +27,10 @@ namespace MAstar
 
         // 막혀있는지
         MBOOL IsBlocked = MFALSE;
+
+        // 타일로 들어오는 이동 비용 (10이 기본 비용, 대각선은 1.4배)
+        // 남은 거리 계산이 기본 비용 기준이므로 10보다 작으면 최단 경로가 보장되지 않는다
+        MUINT8 MoveCost = 10;
     };
 
     //----------------------------------------------------------------------
@@ -42,6 +47,25 @@ namespace MAstar
         }
 
         const MTile *GetTile(MINT32 inX, MINT32 inY) const;
+
+        //--------------------------------------------------------
+        // 2차원 인덱스 <-> 타일 인덱스 변환 (범위 체크는 하지 않는다)
+        //--------------------------------------------------------
+        MINT32 GetTileIndex(const MIntPoint& inIndex2D) const {
+            return (inIndex2D.Y * TileCount.X) + inIndex2D.X;
+        }
+
+        MIntPoint GetTileIndex2D(MINT32 inIndex) const {
+            return MIntPoint(inIndex % TileCount.X, inIndex / TileCount.X);
+        }
+
+        //--------------------------------------------------------
+        // 이동 가능한 타일인지 (범위 밖은 이동 불가)
+        //--------------------------------------------------------
+        MBOOL IsWalkable(MINT32 inX, MINT32 inY) const {
+            const MTile* tile = GetTile(inX, inY);
+            return nullptr != tile && MFALSE == tile->IsBlocked;
+        }
        
     public:
         // 타일 카운트
@@ -52,58 +76,448 @@ namespace MAstar
     };
 
     //----------------------------------------------------------------------
-    // 경로 검색에 사용하는 노드
+    // 경로 검색에 사용하는 노드 (16바이트)
+    // 타일 인덱스로 접근하므로 인덱스 정보는 가지고 있지 않는다
     //----------------------------------------------------------------------
     class MNode
     {
     public:
         // 초기화
-        void InitNode(const MIntPoint& inIndex2D, const MINT32 inDistance_H);
+        void InitNode(const MINT32 inDistance_H);
         
         // G를 설정
-        void SetDistance_G(MINT32 inDistance);
+        void SetDistance_G(MINT32 inDistance) {
+            Distance_G = inDistance;
+        }
 
         MINT32 GetDistance_F() const {
-            return Distance_F;
+            return Distance_G + Distance_H;
         }
 
         MINT32 GetDistance_G() const {
             return Distance_G;
         }
 
-        const MIntPoint& GetIndex2D() const {
-            return Index2D;
+        MINT32 GetDistance_H() const {
+            return Distance_H;
         }
 
-        void SetIsClose(MBOOL inFlag) {
-            IsClose = inFlag;
+        void SetPrevIndex(MINT32 inIndex) {
+            PrevIndex = inIndex;
         }
 
-        MBOOL GetIsClose() const {
-            return IsClose;
+        MINT32 GetPrevIndex() const {
+            return PrevIndex;
         }
 
-        void SetPrevNode(MNode* inNode) {
-            PrevNode = inNode;
+        void SetHeapIndex(MINT32 inIndex) {
+            HeapIndex = inIndex;
         }
 
-        MNode* GetPrevNode() const {
-            return PrevNode;
+        MINT32 GetHeapIndex() const {
+            return HeapIndex;
         }
 
     public:
-        // 인덱스 정보
-        MIntPoint Index2D;
-
-        // 이전 경로 데이터
-        MNode* PrevNode = nullptr;
-
         // 거리 정보
-        MINT32 Distance_H = 0;  // 노드에서 종료 위치까지 거리
         MINT32 Distance_G = 0;  // 시작 위치에서 해당 노드까지의 거리
-        MINT32 Distance_F = 0;  // G + H
+        MINT32 Distance_H = 0;  // 노드에서 종료 위치까지 거리
+
+        // 이전 경로 타일 인덱스 (-1이면 없음)
+        MINT32 PrevIndex = -1;
+
+        // 열린 리스트(힙)에서의 위치 (-1이면 열린 리스트에 없음)
+        MINT32 HeapIndex = -1;
+    };
+
+
+    //----------------------------------------------------------------------
+    // 타일 인덱스로 접근하는 노드 저장소
+    // 검색마다 세대값을 올려서 이전 검색의 노드는 자동으로 무효화 된다
+    // (세대값 == 현재 : 사용중, 세대값 == 현재 + 1 : 닫힘)
+    //----------------------------------------------------------------------
+    class MNodeTable
+    {
+    public:
+        // 새로운 검색 시작 (크기가 다르다면 재할당)
+        void BeginSearch(MINT32 inNodeCount);
+
+        // 이번 검색에서 사용된 노드인지
+        MBOOL IsVisited(MINT32 inIndex) const {
+            return CurrentStamp <= StampList[inIndex];
+        }
+
+        MBOOL IsClose(MINT32 inIndex) const {
+            return (CurrentStamp + 1) == StampList[inIndex];
+        }
+
+        void SetClose(MINT32 inIndex) {
+            StampList[inIndex] = CurrentStamp + 1;
+        }
+
+        // 노드를 얻는다 (이번 검색에서 처음 사용된다면 초기화)
+        MNode& VisitNode(MINT32 inIndex, MINT32 inDistance_H) {
+            if (MFALSE == IsVisited(inIndex))
+            {
+                StampList[inIndex] = CurrentStamp;
+                NodeList[inIndex].InitNode(inDistance_H);
+            }
+            return NodeList[inIndex];
+        }
+
+        MNode& GetNode(MINT32 inIndex) {
+            return NodeList[inIndex];
+        }
+
+        const MNode& GetNode(MINT32 inIndex) const {
+            return NodeList[inIndex];
+        }
+
+        MNode* GetNodeData() {
+            return NodeList.data();
+        }
+
+    protected:
+        // 노드 데이터
+        std::vector<MNode> NodeList;
+
+        // 노드별 세대값
+        std::vector<MUINT32> StampList;
+
+        // 현재 검색의 세대값 (2씩 증가)
+        MUINT32 CurrentStamp = 0;
+    };
+
+
+    //----------------------------------------------------------------------
+    // 열린 노드 리스트 (인덱스 바이너리 힙)
+    // F가 작은 노드가 우선, F가 같다면 H가 작은 노드(종료 위치에 가까운 노드),
+    // 그래도 같다면 타일 인덱스(Y, X)가 작은 노드가 우선
+    //----------------------------------------------------------------------
+    class MOpenList
+    {
+    public:
+        // 사용할 노드 데이터를 설정하고 리스트를 비운다
+        void Reset(MNode* inNodeList);
+
+        // 노드 추가
+        void Push(MINT32 inIndex);
+
+        // 가장 우선순위가 높은 노드를 제거하고 리턴 (비어있다면 -1)
+        MINT32 Pop();
+
+        // 가장 우선순위가 높은 노드를 얻는다 (비어있다면 -1)
+        MINT32 Top() const {
+            return (MTRUE == HeapList.empty()) ? -1 : HeapList.front();
+        }
+
+        // 노드의 거리가 줄어들었을때 위치 갱신
+        void Update(MINT32 inIndex);
+
+        // 리스트에 포함되어있는지
+        MBOOL IsContain(MINT32 inIndex) const {
+            return 0 <= NodeList[inIndex].GetHeapIndex();
+        }
+
+        MBOOL IsEmpty() const {
+            return HeapList.empty();
+        }
+
+        MINT32 GetCount() const {
+            return static_cast<MINT32>(HeapList.size());
+        }
+
+        // 힙 위치의 노드 인덱스
+        MINT32 GetAt(MINT32 inHeapIndex) const {
+            return HeapList[inHeapIndex];
+        }
+
+        // 노드 거리가 한번에 바뀌었을때 힙을 다시 구성
+        void Rebuild();
+
+    protected:
+        // 우선순위 비교 (inLeft가 먼저 처리되어야 한다면 MTRUE)
+        MBOOL IsHigherPriority(MINT32 inLeft, MINT32 inRight) const;
+
+        void SiftUp(MINT32 inHeapIndex);
+        void SiftDown(MINT32 inHeapIndex);
+
+        // 해당 위치에 노드를 설정
+        void SetAt(MINT32 inHeapIndex, MINT32 inIndex) {
+            HeapList[inHeapIndex] = inIndex;
+            NodeList[inIndex].SetHeapIndex(inHeapIndex);
+        }
+
+    protected:
+        // 노드 데이터
+        MNode* NodeList = nullptr;
+
+        // 힙 (타일 인덱스)
+        std::vector<MINT32> HeapList;
+    };
+
+
+    class MClearanceMap;
+    class MComponentMap;
+    class MLandmarkMap;
+    class MBitGrid;
+    class MPathCache;
+    struct MPathCacheKey;
+
+    //----------------------------------------------------------------------
+    // 경로 검색 방식
+    //----------------------------------------------------------------------
+    enum class MPathEngine
+    {
+        AStar,          // 주변 타일을 모두 확장하는 기본 A*
+        JumpPoint,      // Jump Point Search (막힘 여부만 있는 균일 비용 그리드 전용)
+        ThetaStar,      // 검색중에 부모 노드가 보이면 바로 연결하는 Theta* (2D경로 찾기 전용, 타일 경로는 A*로 처리)
+    };
+
+
+    //----------------------------------------------------------------------
+    // 주변 타일 방식
+    //----------------------------------------------------------------------
+    enum class MNeighborMode
+    {
+        Four,               // 상하좌우
+        Eight,              // 대각선 포함 (대각선 양옆이 모두 열려있어야 이동)
+        EightCornerCut,     // 대각선 포함 (대각선 양옆 중 하나만 열려있어도 모서리를 지나서 이동)
+    };
+
+    //----------------------------------------------------------------------
+    // 검색 루프에 템플릿 인자로 사용하는 주변 타일 / 비용 방식
+    // 방식마다 루프를 따로 만들어서 타일마다 방식을 확인하지 않는다
+    //----------------------------------------------------------------------
+    // 상하좌우 (맨허튼 거리)
+    struct MNeighbor4
+    {
+    public:
+        static const MBOOL IsDiagonal = MFALSE;
+        static const MINT32 RequiredSideCount = 0;
+
+        static MINT32 GetDistance_H(MINT32 inDistanceX, MINT32 inDistanceY) {
+            return (inDistanceX + inDistanceY) * 10;
+        }
+    };
+
+    // 대각선 포함 (옥타일 거리)
+    // SIDE_COUNT는 대각선 이동시 열려있어야 하는 양옆 타일 수
+    template<MINT32 SIDE_COUNT>
+    struct MNeighbor8
+    {
+    public:
+        static const MBOOL IsDiagonal = MTRUE;
+        static const MINT32 RequiredSideCount = SIDE_COUNT;
+
+        static MINT32 GetDistance_H(MINT32 inDistanceX, MINT32 inDistanceY) {
+            return (std::max(inDistanceX, inDistanceY) * 10) + (std::min(inDistanceX, inDistanceY) * 4);
+        }
+    };
+
+    //----------------------------------------------------------------------
+    // 주변 타일 방식에 맞게 이동 가능한 주변 타일을 순회
+    // inIsWalkable(x, y)로 이동 가능 여부를 확인하고 inFunction(대상 인덱스, 이동 거리 10 / 14)을 호출
+    // 순서는 상하좌우 (-X, -Y, +Y, +X) -> 대각선
+    //----------------------------------------------------------------------
+    template<typename NEIGHBOR, typename WALKABLE, typename FUNC>
+    void ForEachNeighbor(const MIntPoint& inBaseIndex2D, const WALKABLE& inIsWalkable, const FUNC& inFunction)
+    {
+        // 대각선은 양옆 상하좌우 방향의 번호를 같이 가진다
+        static const MIntPoint StraightList[4] = { MIntPoint(-1, 0), MIntPoint(0, -1), MIntPoint(0, 1), MIntPoint(1, 0) };
+        static const MIntPoint DiagonalList[4] = { MIntPoint(-1, -1), MIntPoint(-1, 1), MIntPoint(1, -1), MIntPoint(1, 1) };
+        static const MINT32 DiagonalSideList[4][2] = { { 0, 1 }, { 0, 2 }, { 3, 1 }, { 3, 2 } };
+
+        // 상하좌우 이동 가능 여부 (대각선 이동 조건에 사용)
+        MBOOL isWalkableList[4] = {};
+
+        for (MINT32 i = 0; i < 4; ++i)
+        {
+            const MIntPoint targetIndex2D = inBaseIndex2D + StraightList[i];
+
+            isWalkableList[i] = inIsWalkable(targetIndex2D.X, targetIndex2D.Y);
+            if (MTRUE == isWalkableList[i]) {
+                inFunction(targetIndex2D, 10);
+            }
+        }
+
+        if (MFALSE == NEIGHBOR::IsDiagonal) {
+            return;
+        }
+
+        for (MINT32 i = 0; i < 4; ++i)
+        {
+            // 양옆 타일 조건
+            const MINT32 sideCount = (MTRUE == isWalkableList[DiagonalSideList[i][0]] ? 1 : 0) + (MTRUE == isWalkableList[DiagonalSideList[i][1]] ? 1 : 0);
+            if (sideCount < NEIGHBOR::RequiredSideCount) {
+                continue;
+            }
+
+            const MIntPoint targetIndex2D = inBaseIndex2D + DiagonalList[i];
+            if (MTRUE == inIsWalkable(targetIndex2D.X, targetIndex2D.Y)) {
+                inFunction(targetIndex2D, 14);
+            }
+        }
+    }
+
+    // 균일 비용 (직선 10, 대각선 14)
+    struct MUniformCost
+    {
+    public:
+        template<typename GRID>
+        static MINT32 GetMoveCost(const GRID*, MINT32, MINT32 inDistance) {
+            return inDistance;
+        }
+    };
+
+    // 타일별 이동 비용 (MTile::MoveCost, MGrid 전용)
+    struct MTileCost
+    {
+    public:
+        static MINT32 GetMoveCost(const MGrid* inGrid, MINT32 inIndex, MINT32 inDistance) {
+            return (inGrid->TileList[inIndex].MoveCost * inDistance) / 10;
+        }
+    };
+
+
+    //----------------------------------------------------------------------
+    // 검색 통계 (FindPath 한번의 정보)
+    // MASTAR_SEARCH_STATS를 정의한 빌드에서만 채워진다
+    //----------------------------------------------------------------------
+    struct MSearchStats
+    {
+    public:
+        // 확장한 노드 수 / 열린 리스트 최대 크기 (양방향 검색은 한쪽 기준)
+        MINT32 ExpandCount = 0;
+        MINT32 MaxOpenCount = 0;
+
+        // 열린 리스트 추가 / 제거 / 갱신 수
+        MINT32 HeapPushCount = 0;
+        MINT32 HeapPopCount = 0;
+        MINT32 HeapUpdateCount = 0;
+
+        // 직선 체크 수 / 직선 체크에서 CheckOBB를 호출한 수
+        MINT32 BlockLineCount = 0;
+        MINT32 CheckOBBCount = 0;
+
+        // 2D경로 직선 다듬기 반복 수
+        MINT32 SmoothCount = 0;
+
+        // 단계별 시간 (마이크로초)
+        MFLOAT SearchTime = 0;      // 타일 검색 (경로 만들기 포함)
+        MFLOAT SmoothTime = 0;      // 2D경로 변환 / 직선 다듬기
+        MFLOAT TotalTime = 0;       // FindPath 전체
+    };
+
+    // 통계를 모으지 않는 정책 (함수가 모두 비어있어서 호출이 남지 않는다)
+    struct MNoSearchStats
+    {
+    public:
+        static const MBOOL IsEnable = MFALSE;
+
+        // 범위가 끝날때 경과 시간을 기록
+        class MPhaseTimer
+        {
+        public:
+            explicit MPhaseTimer(MFLOAT&) {}
+        };
+
+        static void Reset(MSearchStats&) {}
+        static void AddExpand(MSearchStats&) {}
+        static void AddPush(MSearchStats&, MINT32) {}
+        static void AddPop(MSearchStats&) {}
+        static void AddUpdate(MSearchStats&) {}
+        static void AddBlockLine(MSearchStats&) {}
+        static void AddCheckOBB(MSearchStats&) {}
+        static void AddSmooth(MSearchStats&) {}
+
+        // 다른 스레드에서 모은 통계를 합친다
+        static void Merge(MSearchStats&, const MSearchStats&) {}
+    };
+
+    // 통계를 모으는 정책
+    struct MCollectSearchStats
+    {
+    public:
+        static const MBOOL IsEnable = MTRUE;
+
+        class MPhaseTimer
+        {
+        public:
+            explicit MPhaseTimer(MFLOAT& outTime) : Time(outTime), StartTime(std::chrono::steady_clock::now()) {}
+
+            // 안쪽 범위가 먼저 끝나므로 같은 값을 기록하는 범위가 겹치면 바깥쪽 값이 남는다
+            ~MPhaseTimer() {
+                Time = std::chrono::duration<MFLOAT, std::micro>(std::chrono::steady_clock::now() - StartTime).count();
+            }
+
+        protected:
+            MFLOAT& Time;
+            std::chrono::steady_clock::time_point StartTime;
+        };
+
+        static void Reset(MSearchStats& outStats) {
+            outStats = MSearchStats();
+        }
+
+        static void AddExpand(MSearchStats& outStats) {
+            ++outStats.ExpandCount;
+        }
+
+        static void AddPush(MSearchStats& outStats, MINT32 inOpenCount) {
+            ++outStats.HeapPushCount;
+            outStats.MaxOpenCount = std::max(outStats.MaxOpenCount, inOpenCount);
+        }
+
+        static void AddPop(MSearchStats& outStats) {
+            ++outStats.HeapPopCount;
+        }
+
+        static void AddUpdate(MSearchStats& outStats) {
+            ++outStats.HeapUpdateCount;
+        }
+
+        static void AddBlockLine(MSearchStats& outStats) {
+            ++outStats.BlockLineCount;
+        }
+
+        static void AddCheckOBB(MSearchStats& outStats) {
+            ++outStats.CheckOBBCount;
+        }
+
+        static void AddSmooth(MSearchStats& outStats) {
+            ++outStats.SmoothCount;
+        }
+
+        static void Merge(MSearchStats& outStats, const MSearchStats& inStats)
+        {
+            outStats.ExpandCount += inStats.ExpandCount;
+            outStats.MaxOpenCount = std::max(outStats.MaxOpenCount, inStats.MaxOpenCount);
+            outStats.HeapPushCount += inStats.HeapPushCount;
+            outStats.HeapPopCount += inStats.HeapPopCount;
+            outStats.HeapUpdateCount += inStats.HeapUpdateCount;
+        }
+    };
+
+#if defined(MASTAR_SEARCH_STATS)
+    typedef MCollectSearchStats MSearchStatsPolicy;
+#else
+    typedef MNoSearchStats MSearchStatsPolicy;
+#endif
+
 
-        MBOOL IsClose = false;
+    //----------------------------------------------------------------------
+    // Theta* 검색 정보 (2D경로 찾기에서 만들어서 타일 검색에 넘긴다)
+    // 검색중에 타일 중앙끼리 반지름으로 직선 체크를 하므로 월드 위치 정보가 필요하다
+    //----------------------------------------------------------------------
+    struct MAnyAngleSearch
+    {
+    public:
+        MBOOL IsEnable = MFALSE;
+
+        MVector2 GridPos;
+        MFLOAT TileSize = 0;
+        MFLOAT Radius = 0;
     };
 
 
@@ -117,21 +531,226 @@ namespace MAstar
         ~MPathFinder();
 
     public:
+        // 검색 방식 설정
+        void SetPathEngine(MPathEngine inEngine) {
+            PathEngine = inEngine;
+        }
+
+        MPathEngine GetPathEngine() const {
+            return PathEngine;
+        }
+
+        // 주변 타일 방식 설정 (A*에만 사용, Jump Point Search / Theta*는 상하좌우)
+        void SetNeighborMode(MNeighborMode inMode) {
+            NeighborMode = inMode;
+        }
+
+        MNeighborMode GetNeighborMode() const {
+            return NeighborMode;
+        }
+
+        // 타일별 이동 비용 사용 설정 (A*에만 사용, 2D경로의 직선 다듬기는 비용을 고려하지 않는다)
+        void SetUseTileCost(MBOOL inIsUse) {
+            IsUseTileCost = inIsUse;
+        }
+
+        // 반지름을 고려한 검색에 사용할 여유 공간 정보 (같은 그리드에만 사용)
+        void SetClearanceMap(const MClearanceMap* inClearanceMap) {
+            ClearanceMap = inClearanceMap;
+        }
+
+        // 갈 수 없는 종료 위치를 검색 없이 걸러낼 연결 영역 정보 (같은 그리드에만 사용)
+        void SetComponentMap(const MComponentMap* inComponentMap) {
+            ComponentMap = inComponentMap;
+        }
+
+        // 남은 거리 계산에 사용할 랜드마크 거리 정보 (같은 그리드의 상하좌우 검색에만 사용, Theta*는 제외)
+        void SetLandmarkMap(const MLandmarkMap* inLandmarkMap) {
+            LandmarkMap = inLandmarkMap;
+        }
+
+        // 찾은 타일 경로를 저장해서 다시 사용할 저장소 (같은 그리드에만 사용, 여러 MPathFinder가 함께 사용할 수 있다)
+        // 2D경로 찾기는 저장된 타일 경로로 직선 다듬기만 다시 한다
+        void SetPathCache(MPathCache* inPathCache) {
+            PathCache = inPathCache;
+        }
+
+        // 종료 위치에 갈 수 없다면 시작 위치와 같은 영역의 가장 가까운 타일로 대신 검색
+        // inMaxDistance는 찾을 최대 타일 거리
+        void SetNearestGoalFallback(MBOOL inIsEnable, MINT32 inMaxDistance = 32) {
+            IsNearestGoalFallback = inIsEnable;
+            NearestGoalDistance = inMaxDistance;
+        }
+
+        // 양방향 검색 설정 (A*에만 사용, 기본은 사용하지 않음)
+        // 시작 / 종료 위치에서 동시에 검색해서 만나는 지점으로 경로를 만든다 (경로 비용은 단방향과 같다)
+        // 최적화가 아니다 : 열린 지형은 남은 거리가 정확해서 단방향 A*도 경로 길이만큼만 확장하므로
+        // 확장 수는 비슷하고 (64 / 256 크기 8방향 39 / 270 대 35 / 311) 양쪽 저장소 관리 비용만큼 느리다 (약 1.5배)
+        // 남은 거리가 부정확한 무작위 장애물 지형에서만 조금 빠르다 (128 크기 4방향 528번 / 86us 대 581번 / 110us)
+        // inIsUseThread가 MTRUE면 종료 위치쪽 검색을 별도 스레드에서 진행 (스레드는 처음 사용할때 만들어서 계속 사용)
+        void SetBidirectional(MBOOL inIsEnable, MBOOL inIsUseThread = MFALSE) {
+            IsBidirectional = inIsEnable;
+            IsBidirectionalThread = inIsUseThread;
+        }
+
+        // 마지막 검색에서 확장한 노드 수
+        // 벤치마크 등에서 쓰는 값이라 MASTAR_SEARCH_STATS와 상관없이 항상 센다 (확장마다 정수 하나 증가, Stats.ExpandCount와 별개)
+        MINT32 GetExpandCount() const {
+            return ExpandCount;
+        }
+
+        // 마지막 FindPath의 검색 통계 (MASTAR_SEARCH_STATS를 정의하지 않은 빌드에서는 항상 0)
+        const MSearchStats& GetSearchStats() const {
+            return Stats;
+        }
+
         // 경로 찾기
-        void FindPath(std::vector<MIntPoint>& inList, const MGrid* inGrid, const MIntPoint& inStartIndex2D, const MIntPoint & inEndIndex2D);
+        // inClearance가 2 이상이면 여유 공간이 그 이상인 타일로만 이동 (시작 / 종료 타일 제외)
+        void FindPath(std::vector<MIntPoint>& inList, const MGrid* inGrid, const MIntPoint& inStartIndex2D, const MIntPoint & inEndIndex2D, MINT32 inClearance = 0);
+
+        // 막힘 정보만 있는 그리드에서 경로 찾기 (A*, 균일 비용)
+        void FindPath(std::vector<MIntPoint>& inList, const MBitGrid* inGrid, const MIntPoint& inStartIndex2D, const MIntPoint& inEndIndex2D);
 
         // 2D경로 찾기 
         void FindPath(std::vector<MVector2>& inList, const MVector2& inGridPos, float inTileSize, const MGrid* inGrid, const MVector2& inStartPos, const MVector2& inEndPos, MFLOAT inRadius);
 
+        //--------------------------------------------------------------
+        // 호출자 버퍼에 경로 찾기 (경로의 전체 수를 리턴, 찾지 못했다면 0)
+        // 경로가 inCapacity보다 길다면 앞쪽 inCapacity개만 채우므로 리턴값으로 필요한 크기를 확인한다
+        // 타일 경로는 버퍼에 바로 만들고 2D경로는 타일 경로 / 타일 중앙 위치만 내부 목록을 사용한다
+        // 검색 정보 / 임시 경로는 재사용하므로 같은 크기의 그리드를 반복 검색하면 메모리를 새로 할당하지 않는다
+        // (양방향 검색의 스레드 사용 / 경로 저장소에 추가하는 경우는 제외)
+        //--------------------------------------------------------------
+        MINT32 FindPath(MIntPoint* outBuffer, MINT32 inCapacity, const MGrid* inGrid, const MIntPoint& inStartIndex2D, const MIntPoint& inEndIndex2D, MINT32 inClearance = 0);
+
+        MINT32 FindPath(MIntPoint* outBuffer, MINT32 inCapacity, const MBitGrid* inGrid, const MIntPoint& inStartIndex2D, const MIntPoint& inEndIndex2D);
+
+        MINT32 FindPath(MVector2* outBuffer, MINT32 inCapacity, const MVector2& inGridPos, float inTileSize, const MGrid* inGrid, const MVector2& inStartPos, const MVector2& inEndPos, MFLOAT inRadius);
+
     protected:
-        // 대상 위치의 노드를 얻는다
-        MNode* GetNode(const MIntPoint& inIndex2D);
+        //--------------------------------------------------------------
+        // 경로 찾기 구현
+        // SINK는 경로를 쓸 대상으로 std::vector나 호출자 버퍼에 바로 쓴다 (MAstar.cpp의 MPathListSink / MPathBufferSink)
+        // Clear / GetCount / Resize / Set / Add / Assign / GetData를 제공해야 한다
+        //--------------------------------------------------------------
+        // 타일 경로 찾기 (Theta*는 inAnyAngle로 직선 체크 정보를 받는다)
+        template<typename SINK>
+        void FindTilePath(SINK& outPath, const MGrid* inGrid, const MIntPoint& inStartIndex2D, const MIntPoint& inEndIndex2D, MINT32 inClearance, const MAnyAngleSearch& inAnyAngle);
+
+        // 막힘 정보만 있는 그리드에서 타일 경로 찾기
+        template<typename SINK>
+        void FindTilePath(SINK& outPath, const MBitGrid* inGrid, const MIntPoint& inStartIndex2D, const MIntPoint& inEndIndex2D);
+
+        // 2D경로 찾기
+        template<typename SINK>
+        void FindPositionPath(SINK& outPath, const MVector2& inGridPos, float inTileSize, const MGrid* inGrid, const MVector2& inStartPos, const MVector2& inEndPos, MFLOAT inRadius);
+
+        // 대상 위치의 노드를 얻는다 (Theta*는 직선 거리를 남은 거리로 사용)
+        MNode& GetNode(MINT32 inIndex, const MIntPoint& inIndex2D, MBOOL inIsAnyAngle);
+
+        // 다음 체크 노드를 얻는다 (없다면 -1)
+        MINT32 GetNextCheckNode();
+
+        // 이번 검색 조건의 경로 저장소 키
+        MPathCacheKey GetPathCacheKey(MINT32 inStartIndex, MINT32 inEndIndex, const MAnyAngleSearch& inAnyAngle) const;
+
+        // 찾은 경로를 저장소에 추가 (호출자 버퍼보다 길어서 일부만 저장된 경로는 inList가 nullptr)
+        void AddCachePath(const MPathCacheKey& inKey, MUINT32 inVersion, const MIntPoint* inList, MINT32 inCount, const MAnyAngleSearch& inAnyAngle);
+
+        // 이번 검색에서 이동 가능한 타일인지 (여유 공간 포함)
+        MBOOL IsWalkable(const MGrid* inGrid, MINT32 inX, MINT32 inY) const;
+        MBOOL IsWalkable(const MBitGrid* inGrid, MINT32 inX, MINT32 inY) const;
+
+        //--------------------------------------------------------------
+        // A* (주변 타일 / 비용 방식별로 인스턴스화)
+        //--------------------------------------------------------------
+        // 설정된 주변 타일 방식의 검색을 선택 (경로는 BuildSearchPath로 만든다)
+        template<typename GRID, typename COST>
+        void SearchPath_Neighbor(const GRID* inGrid, MINT32 inStartIndex, MINT32 inEndIndex);
+
+        // 단방향 / 양방향 검색
+        template<typename GRID, typename NEIGHBOR, typename COST>
+        void SearchPath_Direction(const GRID* inGrid, MINT32 inStartIndex, MINT32 inEndIndex);
 
-        // 다음 체크 노드를 얻는다
-        MNode* GetNextCheckNode();
+        // SearchPath_Neighbor 결과로 경로를 만든다 (단방향 / 양방향)
+        template<typename GRID, typename SINK>
+        void BuildSearchPath(SINK& outPath, const GRID* inGrid);
+
+        // 종료 노드에 도달하거나 열린 노드가 없을때까지 검색
+        template<typename GRID, typename NEIGHBOR, typename COST>
+        void SearchPath(const GRID* inGrid, MINT32 inEndIndex);
 
         // 주변 노드 갱신
-        void UpdateAroundNode(const MGrid* inGrid, MNode* inBaseNode);
+        template<typename GRID, typename NEIGHBOR, typename COST>
+        void UpdateAroundNode(const GRID* inGrid, MINT32 inBaseIndex);
+
+        // 대상 위치의 노드를 얻는다 (주변 타일 방식에 맞는 남은 거리)
+        template<typename NEIGHBOR>
+        MNode& GetNode(MINT32 inIndex, const MIntPoint& inIndex2D);
+
+        // 종료 노드에서 역추적해서 경로를 만든다 (outPath 뒤에 시작 위치부터 추가)
+        // inIsAnyAngle이 MTRUE면 노드 사이를 채우지 않는다
+        template<typename GRID, typename SINK>
+        void BuildPath(SINK& outPath, const GRID* inGrid, const MIntPoint& inEndIndex2D, MINT32 inEndIndex, MBOOL inIsAnyAngle);
+
+        //--------------------------------------------------------------
+        // 양방향 A*
+        //--------------------------------------------------------------
+        // 양쪽 검색이 만나서 최단 경로가 확정될때까지 검색
+        template<typename GRID, typename NEIGHBOR, typename COST>
+        void SearchBidirectional(const GRID* inGrid, MINT32 inStartIndex, MINT32 inEndIndex);
+
+        // 한쪽 방향으로 최대 inMaxExpandCount개의 노드를 확장 (F가 inBound 이상이면 중단, 확장한 노드 수를 리턴)
+        // 통계는 outStats에 모은다 (종료 위치쪽 작업 스레드는 별도 통계를 사용)
+        template<typename GRID, typename NEIGHBOR, typename COST>
+        MINT32 ExpandBidirectional(const GRID* inGrid, MBOOL inIsBackward, MINT32 inMaxExpandCount, MINT32 inBound, MSearchStats& outStats);
+
+        // 양방향 검색의 남은 거리 (양쪽 방향 남은 거리 차이 + 시작 ~ 종료 직선에서 떨어진 거리, MAstar.cpp의 BidirectionalTieScale 참고)
+        template<typename NEIGHBOR>
+        MINT32 GetBidirectionalDistance_H(MBOOL inIsBackward, MINT32 inIndex, const MIntPoint& inIndex2D) const;
+
+        // 한쪽 방향에서 갱신된 노드가 반대쪽에서도 사용된 노드라면 만나는 지점 갱신
+        void UpdateMeetNode(MBOOL inIsBackward);
+
+        // 더 짧은 경로가 없다고 확정되었는지 (양쪽의 가장 작은 F의 합이 찾은 경로 비용 이상)
+        MBOOL IsBidirectionalFinish() const;
+
+        // 종료 위치쪽 작업 스레드 루프
+        void BackwardWorkerLoop();
+
+        // 만나는 지점에서 양쪽으로 역추적해서 경로를 만든다 (outPath 뒤에 시작 위치부터 추가)
+        template<typename GRID, typename SINK>
+        void BuildBidirectionalPath(SINK& outPath, const GRID* inGrid);
+
+        //--------------------------------------------------------------
+        // Theta*
+        //--------------------------------------------------------------
+        // 주변 노드 갱신 (부모 노드에서 보인다면 부모 노드에 바로 연결)
+        void UpdateThetaStarNode(const MGrid* inGrid, MINT32 inBaseIndex, const MAnyAngleSearch& inAnyAngle);
+
+        // 두 타일 사이의 직선 거리
+        static MINT32 GetLineDistance(const MIntPoint& inIndex2D1, const MIntPoint& inIndex2D2);
+
+        //--------------------------------------------------------------
+        // Jump Point Search
+        //--------------------------------------------------------------
+        // 점프 포인트 후보 갱신
+        void UpdateJumpPointNode(const MGrid* inGrid, MINT32 inBaseIndex);
+
+        // 대상 방향으로 점프해서 점프 포인트를 찾는다 (없다면 -1)
+        MINT32 FindJumpPoint(const MGrid* inGrid, MINT32 inX, MINT32 inY, MINT32 inDirX, MINT32 inDirY);
+
+        // 가로 방향으로만 점프해서 점프 포인트의 X를 찾는다 (막힌 타일을 먼저 만나면 -1)
+        MINT32 FindJumpPoint_Horizontal(const MGrid* inGrid, MINT32 inX, MINT32 inY, MINT32 inDirX);
+
+        // 이동 가능한 타일 비트 행 준비 (검색 시작시 호출)
+        void BeginJumpRowSearch(const MGrid* inGrid);
+
+        // 이번 검색의 이동 가능한 타일 비트 행 (처음 사용할때 만든다, 범위 밖의 행은 모두 막힘)
+        const MUINT64* GetJumpRowBits(const MGrid* inGrid, MINT32 inY);
+
+        // 부모 노드를 거쳐 대상 노드까지의 경로 정보를 갱신
+        void UpdateNodeDistance(const MIntPoint& inTargetIndex2D, MINT32 inTargetIndex, MINT32 inBaseIndex, MINT32 inDistance_G, MBOOL inIsAnyAngle);
 
         // 방향으로 거리값을 얻는다
         MINT32 GetGridDistanceByDirection(MINT32 inX, MINT32 inY);
@@ -143,24 +762,94 @@ namespace MAstar
 
         // 인자로 들어오는 정보로 사각형 라인을 만들어서 막히는 부분이 있는지 체크
         MBOOL CheckBlockLine(const MVector2& inGridPos, float inTileSize, const MGrid* inGrid, const MVector2& inStart, const MVector2& inEnd, MFLOAT inRadius);
+
+        // 볼록 사각형이 가로 띠(inTop ~ inBottom)와 겹치는 X 범위 (겹치지 않는다면 MFALSE)
+        static MBOOL GetBoxRangeX(const MVector2* inCornerList, MFLOAT inTop, MFLOAT inBottom, MFLOAT& outMinX, MFLOAT& outMaxX);
         
     protected:
-        // 경로 찾기시 사용할 노드 풀
-        std::stack<MNode*> NodePool;
-
-        // 사용하는 노드맵
-        std::map<MIntPoint, MNode*> UseNodeMap;
+        // 경로 찾기시 사용할 노드 저장소
+        MNodeTable NodeTable;
 
         // 열린 노드 리스트
-        std::set<MNode*> OpenNodeSet;
+        MOpenList OpenList;
+
+        // 검색 방식
+        MPathEngine PathEngine = MPathEngine::AStar;
+
+        // 주변 타일 방식
+        MNeighborMode NeighborMode = MNeighborMode::Four;
+
+        // 타일별 이동 비용 사용
+        MBOOL IsUseTileCost = MFALSE;
+
+        // 여유 공간 정보
+        const MClearanceMap* ClearanceMap = nullptr;
+
+        // 연결 영역 정보
+        const MComponentMap* ComponentMap = nullptr;
+
+        // 랜드마크 거리 정보
+        const MLandmarkMap* LandmarkMap = nullptr;
+
+        // 경로 저장소
+        MPathCache* PathCache = nullptr;
+
+        // 갈 수 없는 종료 위치 대신 가까운 타일로 검색할지
+        MBOOL IsNearestGoalFallback = MFALSE;
+        MINT32 NearestGoalDistance = 32;
+
+        // 양방향 검색 / 종료 위치쪽 검색을 별도 스레드에서 진행할지
+        MBOOL IsBidirectional = MFALSE;
+        MBOOL IsBidirectionalThread = MFALSE;
+
+        // 이번 검색에 필요한 여유 공간 (1 이하면 체크하지 않는다)
+        MINT32 RequiredClearance = 0;
 
         // 길찾기에 사용되는 임시 정보
         MIntPoint StartIndex2D;
         MIntPoint EndIndex2D;
+        MINT32 StartIndex = -1;
+        MINT32 EndIndex = -1;
+
+        // 확장한 노드 수 (통계 정책과 상관없이 항상 센다)
+        MINT32 ExpandCount = 0;
+
+        // 검색 통계
+        MSearchStats Stats;
+
+        // 양방향 검색의 종료 위치쪽 노드 저장소 / 열린 노드 리스트
+        MNodeTable BackwardNodeTable;
+        MOpenList BackwardOpenList;
+
+        // 양방향 검색중 거리가 갱신된 노드 (방향별)
+        std::vector<MINT32> ForwardTouchList;
+        std::vector<MINT32> BackwardTouchList;
+
+        // 양방향 검색에서 지금까지 찾은 가장 짧은 경로의 만나는 지점 / 비용 (양방향 G 단위)
+        MINT32 MeetIndex = -1;
+        MINT32 MeetDistance = INFINITY_DISTANCE;
+
+        // 종료 위치쪽 작업 스레드 (스레드 검색을 처음 할때 만든다)
+        struct MBackwardWorker;
+        std::unique_ptr<MBackwardWorker> BackwardWorker;
+
+        // 이번 검색에 사용할 랜드마크 거리 정보 (사용하지 않는다면 nullptr)
+        const MLandmarkMap* SearchLandmarkMap = nullptr;
+
+        // Jump Point Search의 이동 가능한 타일 비트 (1이 이동 가능, 행마다 JumpRowWordCount개, 맨 앞은 범위 밖용 빈 행)
+        // 여유 공간 / 종료 타일에 따라 검색마다 달라지므로 행별 세대값으로 검색중에 처음 사용할때 만든다
+        std::vector<MUINT64> JumpRowBitList;
+        std::vector<MUINT32> JumpRowStampList;
+        MUINT32 JumpRowStamp = 0;
+        MINT32 JumpRowWordCount = 0;
+
+        // 2D경로 찾기에 사용하는 타일 경로 / 타일 중앙 위치 (검색마다 재사용)
+        std::vector<MIntPoint> PathIndex2DList;
+        std::vector<MVector2> PathPositionList;
     
     public:
         //--------------------------------------------------------------
-        // 각 콜백
+        // 각 콜백 (MASTAR_DISABLE_DEBUG_DRAW를 정의한 빌드에서는 호출하지 않는다)
         //--------------------------------------------------------------
         // 블럭 라인 출력
         std::function<void(const MCollision::MBox2D&)> OnDrawBlockLine;
@@ -0,0 +1,270 @@
+﻿#include "MBitGrid.h"
+
+#if defined(_MSC_VER)
+    #include <intrin.h>
+#endif
+
+
+namespace MAstar
+{
+    namespace
+    {
+        // 블럭 한변의 타일 수
+        const MINT32 BlockSize = 8;
+
+        // 음수도 내림으로 블럭 인덱스를 구한다
+        MINT32 GetBlockIndex(MINT32 inValue)
+        {
+            return (inValue < 0) ? ((inValue - (BlockSize - 1)) / BlockSize) : (inValue / BlockSize);
+        }
+
+        // 1비트 수
+        MINT32 GetBitCount(MUINT64 inValue)
+        {
+#if defined(_MSC_VER)
+            return static_cast<MINT32>(__popcnt64(inValue));
+#else
+            return __builtin_popcountll(inValue);
+#endif
+        }
+    }
+
+    MINT32 MBitGrid::GetLowestBit(MUINT64 inValue)
+    {
+#if defined(_MSC_VER)
+        unsigned long index = 0;
+        _BitScanForward64(&index, inValue);
+        return static_cast<MINT32>(index);
+#else
+        return __builtin_ctzll(inValue);
+#endif
+    }
+
+    MINT32 MBitGrid::GetHighestBit(MUINT64 inValue)
+    {
+#if defined(_MSC_VER)
+        unsigned long index = 0;
+        _BitScanReverse64(&index, inValue);
+        return static_cast<MINT32>(index);
+#else
+        return 63 - __builtin_clzll(inValue);
+#endif
+    }
+
+    void MBitGrid::Resize(const MIntSize& inTileCount)
+    {
+        ViewData = nullptr;
+
+        TileCount = inTileCount;
+        BlockCountX = (TileCount.X + (BlockSize - 1)) / BlockSize;
+        BlockCountY = (TileCount.Y + (BlockSize - 1)) / BlockSize;
+
+        BlockList.assign(static_cast<size_t>(BlockCountX) * BlockCountY, 0);
+
+        FillPadding();
+    }
+
+    void MBitGrid::Build(const MGrid* inGrid)
+    {
+        Resize(inGrid->TileCount);
+
+        for (MINT32 y = 0; y < TileCount.Y; ++y)
+        {
+            for (MINT32 x = 0; x < TileCount.X; ++x)
+            {
+                if (MTRUE == inGrid->TileList[(y * TileCount.X) + x].IsBlocked) {
+                    SetBlocked(x, y, MTRUE);
+                }
+            }
+        }
+    }
+
+    void MBitGrid::ToGrid(MGrid& outGrid) const
+    {
+        outGrid.TileCount = TileCount;
+        outGrid.TileList.resize(static_cast<size_t>(TileCount.X) * TileCount.Y);
+
+        for (MINT32 y = 0; y < TileCount.Y; ++y)
+        {
+            for (MINT32 x = 0; x < TileCount.X; ++x)
+            {
+                MTile& tile = outGrid.TileList[(y * TileCount.X) + x];
+                tile.Index2D = MIntPoint(x, y);
+                tile.IsBlocked = IsBlocked(x, y);
+            }
+        }
+    }
+
+    void MBitGrid::SetView(const MIntSize& inTileCount, const MUINT64* inBlockData)
+    {
+        TileCount = inTileCount;
+        BlockCountX = (TileCount.X + (BlockSize - 1)) / BlockSize;
+        BlockCountY = (TileCount.Y + (BlockSize - 1)) / BlockSize;
+
+        BlockList.clear();
+        BlockList.shrink_to_fit();
+        ViewData = inBlockData;
+    }
+
+    MBOOL MBitGrid::GetTile(MINT32 inX, MINT32 inY, MTile& outTile) const
+    {
+        if (MFALSE == IsInside(inX, inY)) {
+            return MFALSE;
+        }
+
+        outTile.Index2D = MIntPoint(inX, inY);
+        outTile.IsBlocked = IsBlocked(inX, inY);
+
+        return MTRUE;
+    }
+
+    MBOOL MBitGrid::IsBlocked(MINT32 inX, MINT32 inY) const
+    {
+        if (MFALSE == IsInside(inX, inY)) {
+            return MTRUE;
+        }
+
+        const MUINT64 block = GetBlockData()[((inY / BlockSize) * BlockCountX) + (inX / BlockSize)];
+        const MINT32 bitIndex = ((inY % BlockSize) * BlockSize) + (inX % BlockSize);
+
+        return 0 != ((block >> bitIndex) & 1);
+    }
+
+    void MBitGrid::SetBlocked(MINT32 inX, MINT32 inY, MBOOL inIsBlocked)
+    {
+        MASSERT(MFALSE == IsView());
+
+        if (MFALSE == IsInside(inX, inY)) {
+            return;
+        }
+
+        MUINT64& block = BlockList[((inY / BlockSize) * BlockCountX) + (inX / BlockSize)];
+        const MUINT64 bit = static_cast<MUINT64>(1) << (((inY % BlockSize) * BlockSize) + (inX % BlockSize));
+
+        if (MTRUE == inIsBlocked) {
+            block |= bit;
+        }
+        else {
+            block &= ~bit;
+        }
+    }
+
+    MUINT64 MBitGrid::GetBlockedBits(MINT32 inX, MINT32 inY) const
+    {
+        // 범위 밖의 행은 모두 막힘
+        if (inY < 0 || TileCount.Y <= inY) {
+            return ~static_cast<MUINT64>(0);
+        }
+
+        // 시작 위치가 블럭 경계에 맞지 않으면 블럭 9개에 걸친다
+        const MINT32 blockX = GetBlockIndex(inX);
+        const MINT32 shift = inX - (blockX * BlockSize);
+
+        MUINT64 bits = 0;
+        for (MINT32 i = 0; i <= BlockSize; ++i)
+        {
+            const MUINT64 row = GetBlockRow(blockX + i, inY);
+            const MINT32 offset = (i * BlockSize) - shift;
+
+            if (offset < 0) {
+                bits |= row >> -offset;
+            }
+            else if (offset < 64) {
+                bits |= row << offset;
+            }
+        }
+
+        return bits;
+    }
+
+    MINT32 MBitGrid::FindBlockedInRow(MINT32 inX, MINT32 inY, MINT32 inDirX) const
+    {
+        // 범위 밖은 막혀있으므로 항상 찾을 수 있다
+        if (0 < inDirX)
+        {
+            for (MINT32 x = inX; ; x += 64)
+            {
+                const MUINT64 bits = GetBlockedBits(x, inY);
+                if (0 != bits) {
+                    return x + GetLowestBit(bits);
+                }
+            }
+        }
+
+        for (MINT32 x = inX; ; x -= 64)
+        {
+            const MUINT64 bits = GetBlockedBits(x - 63, inY);
+            if (0 != bits) {
+                return (x - 63) + GetHighestBit(bits);
+            }
+        }
+    }
+
+    MUINT32 MBitGrid::GetNeighborBits(MINT32 inX, MINT32 inY) const
+    {
+        MUINT32 bits = 0;
+        for (MINT32 y = -1; y <= 1; ++y) {
+            bits |= static_cast<MUINT32>(GetBlockedBits(inX - 1, inY + y) & 0x7) << ((y + 1) * 3);
+        }
+
+        return bits;
+    }
+
+    MINT32 MBitGrid::CountBlocked(const MIntPoint& inMin, const MIntPoint& inMax) const
+    {
+        const MINT32 minX = std::max(inMin.X, 0);
+        const MINT32 minY = std::max(inMin.Y, 0);
+        const MINT32 maxX = std::min(inMax.X, TileCount.X - 1);
+        const MINT32 maxY = std::min(inMax.Y, TileCount.Y - 1);
+
+        MINT32 count = 0;
+        for (MINT32 y = minY; y <= maxY; ++y)
+        {
+            for (MINT32 x = minX; x <= maxX; x += 64)
+            {
+                const MINT32 width = std::min(64, (maxX - x) + 1);
+                const MUINT64 mask = (64 == width) ? ~static_cast<MUINT64>(0) : ((static_cast<MUINT64>(1) << width) - 1);
+
+                count += GetBitCount(GetBlockedBits(x, y) & mask);
+            }
+        }
+
+        return count;
+    }
+
+    MUINT32 MBitGrid::GetBlockRow(MINT32 inBlockX, MINT32 inY) const
+    {
+        if (inBlockX < 0 || BlockCountX <= inBlockX) {
+            return 0xFF;
+        }
+
+        const MUINT64 block = GetBlockData()[((inY / BlockSize) * BlockCountX) + inBlockX];
+        return static_cast<MUINT32>(block >> ((inY % BlockSize) * BlockSize)) & 0xFF;
+    }
+
+    void MBitGrid::FillPadding()
+    {
+        // 오른쪽 끝 블럭의 남는 열
+        const MINT32 paddingX = (BlockCountX * BlockSize) - TileCount.X;
+        if (0 < paddingX && 0 < BlockCountY)
+        {
+            const MUINT64 rowMask = (0xFF << (BlockSize - paddingX)) & 0xFF;
+            const MUINT64 blockMask = rowMask * 0x0101010101010101ull;
+
+            for (MINT32 blockY = 0; blockY < BlockCountY; ++blockY) {
+                BlockList[(blockY * BlockCountX) + (BlockCountX - 1)] |= blockMask;
+            }
+        }
+
+        // 아래쪽 끝 블럭의 남는 행
+        const MINT32 paddingY = (BlockCountY * BlockSize) - TileCount.Y;
+        if (0 < paddingY && 0 < BlockCountX)
+        {
+            const MUINT64 blockMask = ~static_cast<MUINT64>(0) << ((BlockSize - paddingY) * BlockSize);
+
+            for (MINT32 blockX = 0; blockX < BlockCountX; ++blockX) {
+                BlockList[((BlockCountY - 1) * BlockCountX) + blockX] |= blockMask;
+            }
+        }
+    }
+};
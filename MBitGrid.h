@@ -0,0 +1,133 @@
+﻿#pragma once
+
+#include <vector>
+
+#include "MPrerequisites.h"
+#include "MType.h"
+#include "MAstar.h"
+
+
+namespace MAstar
+{
+    //----------------------------------------------------------------------
+    // 막힘 정보만 비트로 저장하는 그리드
+    // 8x8 타일을 64비트 블럭 하나에 저장 (블럭 안에서 한 행이 1바이트, 아래 비트가 왼쪽)
+    // 그리드 밖의 여분 비트는 막힘으로 채워두므로 행 단위 검색시 범위 체크가 필요 없다
+    // 인덱스 규칙은 MGrid와 같다
+    // 외부 블럭 데이터를 복사 없이 연결해서 읽기 전용으로 사용할 수 있다 (SetView)
+    //----------------------------------------------------------------------
+    class MBitGrid
+    {
+    public:
+        // 크기 설정 (모든 타일은 이동 가능)
+        void Resize(const MIntSize& inTileCount);
+
+        // MGrid 정보로 만든다
+        void Build(const MGrid* inGrid);
+
+        // MGrid로 변환
+        void ToGrid(MGrid& outGrid) const;
+
+        // 외부 블럭 데이터에 연결 (데이터는 연결되어 있는 동안 유지되어야 한다, 블럭 수는 크기와 맞아야 한다)
+        void SetView(const MIntSize& inTileCount, const MUINT64* inBlockData);
+
+        // 외부 데이터에 연결되어 있는지 (연결된 상태에서는 막힘 정보를 바꿀 수 없다)
+        MBOOL IsView() const {
+            return nullptr != ViewData;
+        }
+
+        //--------------------------------------------------------
+        // 타일 정보를 얻는다 (범위 밖이면 MFALSE)
+        //--------------------------------------------------------
+        MBOOL GetTile(const MIntPoint& inIndex2D, MTile& outTile) const {
+            return GetTile(inIndex2D.X, inIndex2D.Y, outTile);
+        }
+
+        MBOOL GetTile(MINT32 inX, MINT32 inY, MTile& outTile) const;
+
+        //--------------------------------------------------------
+        // 2차원 인덱스 <-> 타일 인덱스 변환 (범위 체크는 하지 않는다)
+        //--------------------------------------------------------
+        MINT32 GetTileIndex(const MIntPoint& inIndex2D) const {
+            return (inIndex2D.Y * TileCount.X) + inIndex2D.X;
+        }
+
+        MIntPoint GetTileIndex2D(MINT32 inIndex) const {
+            return MIntPoint(inIndex % TileCount.X, inIndex / TileCount.X);
+        }
+
+        //--------------------------------------------------------
+        // 막힘 정보 (범위 밖은 막힘)
+        //--------------------------------------------------------
+        MBOOL IsInside(MINT32 inX, MINT32 inY) const {
+            return 0 <= inX && inX < TileCount.X && 0 <= inY && inY < TileCount.Y;
+        }
+
+        MBOOL IsBlocked(MINT32 inX, MINT32 inY) const;
+
+        MBOOL IsWalkable(MINT32 inX, MINT32 inY) const {
+            return MFALSE == IsBlocked(inX, inY);
+        }
+
+        void SetBlocked(MINT32 inX, MINT32 inY, MBOOL inIsBlocked);
+
+        //--------------------------------------------------------
+        // 행 / 주변 검색
+        //--------------------------------------------------------
+        // inX부터 오른쪽으로 64칸의 막힘 비트 (i번째 비트가 (inX + i, inY))
+        MUINT64 GetBlockedBits(MINT32 inX, MINT32 inY) const;
+
+        // 행에서 inDirX 방향(1 / -1)으로 처음 나오는 막힌 타일의 X (자신 포함, 없다면 -1 또는 TileCount.X)
+        MINT32 FindBlockedInRow(MINT32 inX, MINT32 inY, MINT32 inDirX) const;
+
+        // 주변 3x3 막힘 비트 ((dy + 1) * 3 + (dx + 1)번째 비트)
+        MUINT32 GetNeighborBits(MINT32 inX, MINT32 inY) const;
+
+        // 영역(최소 ~ 최대 포함) 안의 막힌 타일 수 (범위 밖은 세지 않는다)
+        MINT32 CountBlocked(const MIntPoint& inMin, const MIntPoint& inMax) const;
+
+        //--------------------------------------------------------
+        // 블럭 데이터
+        //--------------------------------------------------------
+        const MUINT64* GetBlockData() const {
+            return (nullptr != ViewData) ? ViewData : BlockList.data();
+        }
+
+        size_t GetBlockCount() const {
+            return static_cast<size_t>(BlockCountX) * BlockCountY;
+        }
+
+        // 사용 메모리 (연결된 외부 데이터는 제외)
+        size_t GetMemorySize() const {
+            return BlockList.size() * sizeof(MUINT64);
+        }
+
+        //--------------------------------------------------------
+        // 가장 낮은 / 높은 1비트 위치 (0이 아닌 값만)
+        //--------------------------------------------------------
+        static MINT32 GetLowestBit(MUINT64 inValue);
+        static MINT32 GetHighestBit(MUINT64 inValue);
+
+    protected:
+        // 블럭에서 한 행(8칸)의 막힘 비트
+        MUINT32 GetBlockRow(MINT32 inBlockX, MINT32 inY) const;
+
+        // 여분 비트를 막힘으로 채운다
+        void FillPadding();
+
+    public:
+        // 타일 카운트
+        MIntSize TileCount;
+
+    protected:
+        // 블럭 카운트
+        MINT32 BlockCountX = 0;
+        MINT32 BlockCountY = 0;
+
+        // 블럭 데이터 (블럭 행 순서)
+        std::vector<MUINT64> BlockList;
+
+        // 연결된 외부 블럭 데이터
+        const MUINT64* ViewData = nullptr;
+    };
+};
@@ -0,0 +1,299 @@
+﻿#include "MBroadPhase.h"
+
+
+namespace MCollision
+{
+	namespace
+	{
+		// 빈 셀을 정리하기 시작하는 최소 빈 셀 수
+		const size_t MinCompactCellCount = 1024;
+
+		// 셀 범위에 들어있는지 (최소가 최대보다 크면 빈 범위)
+		MBOOL IsInsideCellRange(MINT32 inX, MINT32 inY, const MIntPoint& inCellMin, const MIntPoint& inCellMax)
+		{
+			return inCellMin.X <= inX && inX <= inCellMax.X && inCellMin.Y <= inY && inY <= inCellMax.Y;
+		}
+
+		// 빈 셀 범위
+		const MIntPoint EmptyCellMin(1, 1);
+		const MIntPoint EmptyCellMax(0, 0);
+	}
+
+	void MBroadPhase::Setup(const MVector2& inOrigin, MFLOAT inCellSize)
+	{
+		MASSERT(0 < inCellSize);
+
+		Origin = inOrigin;
+		CellSize = inCellSize;
+
+		Clear();
+	}
+
+	void MBroadPhase::Clear()
+	{
+		CellMap.clear();
+		EmptyCellCount = 0;
+		ObjectList.clear();
+		FreeObjectList.clear();
+		ObjectCount = 0;
+
+		VisitStampList.clear();
+		VisitStamp = 0;
+	}
+
+	MINT32 MBroadPhase::Insert(const MBox2D& inBox, MINT32 inUserData)
+	{
+		// 제거된 아이디가 있다면 재사용
+		MINT32 objectID = -1;
+		if (MFALSE == FreeObjectList.empty())
+		{
+			objectID = FreeObjectList.back();
+			FreeObjectList.pop_back();
+		}
+		else
+		{
+			objectID = static_cast<MINT32>(ObjectList.size());
+			ObjectList.emplace_back();
+			VisitStampList.push_back(0);
+		}
+
+		MBroadPhaseObject& object = ObjectList[objectID];
+		object.Box.Set(inBox);
+		object.UserData = inUserData;
+		object.IsUsed = MTRUE;
+
+		GetCellRange(inBox, object.CellMin, object.CellMax);
+		AddToCell(objectID, object.CellMin, object.CellMax, EmptyCellMin, EmptyCellMax);
+
+		++ObjectCount;
+
+		return objectID;
+	}
+
+	void MBroadPhase::Move(MINT32 inObjectID, const MBox2D& inBox)
+	{
+		MASSERT(nullptr != GetObjectInfo(inObjectID));
+
+		MBroadPhaseObject& object = ObjectList[inObjectID];
+		object.Box.Set(inBox);
+
+		MIntPoint cellMin;
+		MIntPoint cellMax;
+		GetCellRange(inBox, cellMin, cellMax);
+
+		// 같은 셀 범위 안에서 움직였다면 셀 정보는 그대로 둔다
+		if (cellMin == object.CellMin && cellMax == object.CellMax) {
+			return;
+		}
+
+		// 이전 / 새 범위에 모두 들어있는 셀은 그대로 둔다
+		RemoveFromCell(inObjectID, object.CellMin, object.CellMax, cellMin, cellMax);
+		AddToCell(inObjectID, cellMin, cellMax, object.CellMin, object.CellMax);
+
+		object.CellMin = cellMin;
+		object.CellMax = cellMax;
+
+		CompactCell();
+	}
+
+	void MBroadPhase::Remove(MINT32 inObjectID)
+	{
+		MASSERT(nullptr != GetObjectInfo(inObjectID));
+
+		MBroadPhaseObject& object = ObjectList[inObjectID];
+		RemoveFromCell(inObjectID, object.CellMin, object.CellMax, EmptyCellMin, EmptyCellMax);
+
+		object.IsUsed = MFALSE;
+		object.UserData = -1;
+
+		FreeObjectList.push_back(inObjectID);
+		--ObjectCount;
+
+		CompactCell();
+	}
+
+	void MBroadPhase::QueryBox(const MBox2D& inBox, std::vector<MINT32>& outObjectList)
+	{
+		outObjectList.clear();
+
+		MIntPoint cellMin;
+		MIntPoint cellMax;
+		GetCellRange(inBox, cellMin, cellMax);
+
+		CollectCandidate(cellMin, cellMax, -1);
+
+		// 후보를 한번에 체크
+		CheckOBB_BatchList(MOBB2D(inBox), CandidateBatch, HitList);
+
+		for (const MINT32 hitIndex : HitList) {
+			outObjectList.push_back(CandidateList[hitIndex]);
+		}
+	}
+
+	void MBroadPhase::FindOverlapPairs(std::vector<std::pair<MINT32, MINT32>>& outPairList)
+	{
+		outPairList.clear();
+
+		const MINT32 objectCount = static_cast<MINT32>(ObjectList.size());
+		for (MINT32 objectID = 0; objectID < objectCount; ++objectID)
+		{
+			const MBroadPhaseObject& object = ObjectList[objectID];
+			if (MFALSE == object.IsUsed) {
+				continue;
+			}
+
+			// 자신보다 아이디가 큰 오브젝트만 모아서 쌍이 한번만 나오도록 한다
+			CollectCandidate(object.CellMin, object.CellMax, objectID);
+			if (MTRUE == CandidateList.empty()) {
+				continue;
+			}
+
+			CheckOBB_BatchList(object.Box, CandidateBatch, HitList);
+
+			for (const MINT32 hitIndex : HitList) {
+				outPairList.emplace_back(objectID, CandidateList[hitIndex]);
+			}
+		}
+	}
+
+	const MBroadPhaseObject* MBroadPhase::GetObjectInfo(MINT32 inObjectID) const
+	{
+		if (inObjectID < 0 || static_cast<MINT32>(ObjectList.size()) <= inObjectID) {
+			return nullptr;
+		}
+
+		const MBroadPhaseObject& object = ObjectList[inObjectID];
+		if (MFALSE == object.IsUsed) {
+			return nullptr;
+		}
+
+		return &object;
+	}
+
+	void MBroadPhase::GetCellRange(const MBox2D& inBox, MIntPoint& outCellMin, MIntPoint& outCellMax) const
+	{
+		const MFLOAT minX = std::min(std::min(inBox.LT.X, inBox.RT.X), std::min(inBox.LB.X, inBox.RB.X));
+		const MFLOAT maxX = std::max(std::max(inBox.LT.X, inBox.RT.X), std::max(inBox.LB.X, inBox.RB.X));
+		const MFLOAT minY = std::min(std::min(inBox.LT.Y, inBox.RT.Y), std::min(inBox.LB.Y, inBox.RB.Y));
+		const MFLOAT maxY = std::max(std::max(inBox.LT.Y, inBox.RT.Y), std::max(inBox.LB.Y, inBox.RB.Y));
+
+		// 경계에 닿는 경우도 충돌이므로 경계가 셀 경계와 같다면 옆 셀까지 포함된다
+		outCellMin.X = static_cast<MINT32>(std::floor((minX - Origin.X) / CellSize));
+		outCellMin.Y = static_cast<MINT32>(std::floor((minY - Origin.Y) / CellSize));
+		outCellMax.X = static_cast<MINT32>(std::floor((maxX - Origin.X) / CellSize));
+		outCellMax.Y = static_cast<MINT32>(std::floor((maxY - Origin.Y) / CellSize));
+	}
+
+	void MBroadPhase::AddToCell(MINT32 inObjectID, const MIntPoint& inCellMin, const MIntPoint& inCellMax, const MIntPoint& inSkipMin, const MIntPoint& inSkipMax)
+	{
+		for (MINT32 y = inCellMin.Y; y <= inCellMax.Y; ++y)
+		{
+			for (MINT32 x = inCellMin.X; x <= inCellMax.X; ++x)
+			{
+				if (MTRUE == IsInsideCellRange(x, y, inSkipMin, inSkipMax)) {
+					continue;
+				}
+
+				// 남겨둔 빈 셀을 다시 사용
+				auto result = CellMap.try_emplace(GetCellKey(x, y));
+				if (MFALSE == result.second && MTRUE == result.first->second.empty()) {
+					--EmptyCellCount;
+				}
+
+				result.first->second.push_back(inObjectID);
+			}
+		}
+	}
+
+	void MBroadPhase::RemoveFromCell(MINT32 inObjectID, const MIntPoint& inCellMin, const MIntPoint& inCellMax, const MIntPoint& inSkipMin, const MIntPoint& inSkipMax)
+	{
+		for (MINT32 y = inCellMin.Y; y <= inCellMax.Y; ++y)
+		{
+			for (MINT32 x = inCellMin.X; x <= inCellMax.X; ++x)
+			{
+				if (MTRUE == IsInsideCellRange(x, y, inSkipMin, inSkipMax)) {
+					continue;
+				}
+
+				auto iter = CellMap.find(GetCellKey(x, y));
+				if (CellMap.end() == iter) {
+					continue;
+				}
+
+				// 순서는 상관없으므로 마지막 값과 바꿔서 제거
+				std::vector<MINT32>& objectList = iter->second;
+				for (size_t i = 0; i < objectList.size(); ++i)
+				{
+					if (inObjectID == objectList[i])
+					{
+						objectList[i] = objectList.back();
+						objectList.pop_back();
+						break;
+					}
+				}
+
+				// 빈 셀은 다시 사용할 수 있도록 남겨두고 CompactCell에서 정리
+				if (MTRUE == objectList.empty()) {
+					++EmptyCellCount;
+				}
+			}
+		}
+	}
+
+	void MBroadPhase::CompactCell()
+	{
+		// 빈 셀이 오브젝트가 있는 셀보다 많아졌을때만 한번에 정리 (이동마다 셀을 할당 / 해제하지 않도록)
+		if (EmptyCellCount < MinCompactCellCount || EmptyCellCount < CellMap.size() - EmptyCellCount) {
+			return;
+		}
+
+		for (auto iter = CellMap.begin(); CellMap.end() != iter; )
+		{
+			if (MTRUE == iter->second.empty()) {
+				iter = CellMap.erase(iter);
+			}
+			else {
+				++iter;
+			}
+		}
+
+		EmptyCellCount = 0;
+	}
+
+	void MBroadPhase::CollectCandidate(const MIntPoint& inCellMin, const MIntPoint& inCellMax, MINT32 inMinObjectID)
+	{
+		CandidateList.clear();
+		CandidateBatch.Clear();
+
+		// 값이 한바퀴 돌면 초기화
+		++VisitStamp;
+		if (0 == VisitStamp)
+		{
+			std::fill(VisitStampList.begin(), VisitStampList.end(), 0);
+			VisitStamp = 1;
+		}
+
+		for (MINT32 y = inCellMin.Y; y <= inCellMax.Y; ++y)
+		{
+			for (MINT32 x = inCellMin.X; x <= inCellMax.X; ++x)
+			{
+				auto iter = CellMap.find(GetCellKey(x, y));
+				if (CellMap.end() == iter) {
+					continue;
+				}
+
+				for (const MINT32 objectID : iter->second)
+				{
+					if (objectID <= inMinObjectID || VisitStamp == VisitStampList[objectID]) {
+						continue;
+					}
+
+					VisitStampList[objectID] = VisitStamp;
+
+					CandidateList.push_back(objectID);
+					CandidateBatch.Add(ObjectList[objectID].Box);
+				}
+			}
+		}
+	}
+};
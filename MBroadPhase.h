@@ -0,0 +1,121 @@
+﻿#pragma once
+
+#include <vector>
+#include <utility>
+#include <unordered_map>
+
+#include "MPrerequisites.h"
+#include "MType.h"
+#include "MVector.h"
+#include "MCollision.h"
+
+
+namespace MCollision
+{
+	//---------------------------------------------------------------
+	// 브로드페이즈에 등록된 오브젝트
+	//---------------------------------------------------------------
+	struct MBroadPhaseObject
+	{
+	public:
+		// 충돌 체크용 박스
+		MOBB2D Box;
+
+		// 박스가 걸쳐있는 셀 범위
+		MIntPoint CellMin;
+		MIntPoint CellMax;
+
+		// 사용자 정보
+		MINT32 UserData = -1;
+
+		// 사용중인지
+		MBOOL IsUsed = MFALSE;
+	};
+
+
+	//---------------------------------------------------------------
+	// 균일 그리드 공간 해시 브로드페이즈
+	// 셀 크기를 MGrid의 타일 크기(또는 배수)에 맞추면 타일과 셀이 일치한다
+	// 주변 셀의 오브젝트만 후보로 모아서 OBB 일괄 체크로 넘긴다
+	//---------------------------------------------------------------
+	class MBroadPhase
+	{
+	public:
+		MBroadPhase(){}
+
+	public:
+		// 셀 정보 설정 (등록된 오브젝트는 모두 제거)
+		void Setup(const MVector2& inOrigin, MFLOAT inCellSize);
+
+		// 모든 오브젝트 제거
+		void Clear();
+
+		// 오브젝트 추가 (오브젝트 아이디를 반환)
+		MINT32 Insert(const MBox2D& inBox, MINT32 inUserData = -1);
+
+		// 오브젝트 이동
+		void Move(MINT32 inObjectID, const MBox2D& inBox);
+
+		// 오브젝트 제거
+		void Remove(MINT32 inObjectID);
+
+		// 영역 안의 박스와 충돌하는 오브젝트 아이디
+		void QueryBox(const MBox2D& inBox, std::vector<MINT32>& outObjectList);
+
+		// 서로 충돌하는 오브젝트 쌍 (앞의 아이디가 작다)
+		void FindOverlapPairs(std::vector<std::pair<MINT32, MINT32>>& outPairList);
+
+	public:
+		const MBroadPhaseObject* GetObjectInfo(MINT32 inObjectID) const;
+
+		MINT32 GetObjectCount() const {
+			return ObjectCount;
+		}
+
+		MFLOAT GetCellSize() const {
+			return CellSize;
+		}
+
+	protected:
+		// 박스가 걸쳐있는 셀 범위를 구한다
+		void GetCellRange(const MBox2D& inBox, MIntPoint& outCellMin, MIntPoint& outCellMax) const;
+
+		// 셀 범위에 오브젝트 추가 / 제거 (inSkipMin ~ inSkipMax 범위의 셀은 제외)
+		void AddToCell(MINT32 inObjectID, const MIntPoint& inCellMin, const MIntPoint& inCellMax, const MIntPoint& inSkipMin, const MIntPoint& inSkipMax);
+		void RemoveFromCell(MINT32 inObjectID, const MIntPoint& inCellMin, const MIntPoint& inCellMax, const MIntPoint& inSkipMin, const MIntPoint& inSkipMax);
+
+		// 빈 셀이 많아졌다면 제거
+		void CompactCell();
+
+		// 셀 범위의 오브젝트를 후보 목록에 모은다 (중복 제외, inMinObjectID보다 큰 아이디만)
+		void CollectCandidate(const MIntPoint& inCellMin, const MIntPoint& inCellMax, MINT32 inMinObjectID);
+
+		// 셀 키
+		static MUINT64 GetCellKey(MINT32 inX, MINT32 inY) {
+			return (static_cast<MUINT64>(static_cast<MUINT32>(inX)) << 32) | static_cast<MUINT32>(inY);
+		}
+
+	protected:
+		// 셀 정보
+		MVector2 Origin;
+		MFLOAT CellSize = 1.0f;
+
+		// 셀별 오브젝트 목록 (오브젝트가 빠진 셀도 남겨두고 빈 셀 수가 많아지면 정리)
+		std::unordered_map<MUINT64, std::vector<MINT32>> CellMap;
+		size_t EmptyCellCount = 0;
+
+		// 오브젝트 목록 (제거된 아이디는 재사용)
+		std::vector<MBroadPhaseObject> ObjectList;
+		std::vector<MINT32> FreeObjectList;
+		MINT32 ObjectCount = 0;
+
+		// 후보를 모을때 중복 체크용 (검색마다 값을 올려서 초기화 없이 사용)
+		std::vector<MUINT32> VisitStampList;
+		MUINT32 VisitStamp = 0;
+
+		// 후보 목록 / 일괄 체크용 임시 정보
+		std::vector<MINT32> CandidateList;
+		MBoxBatch CandidateBatch;
+		std::vector<MINT32> HitList;
+	};
+};
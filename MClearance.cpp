@@ -0,0 +1,161 @@
+﻿#include "MClearance.h"
+
+
+namespace MAstar
+{
+    void MClearanceMap::Build(const MGrid* inGrid, MINT32 inMaxClearance)
+    {
+        Grid = inGrid;
+        MaxClearance = std::max(1, std::min(inMaxClearance, 255));
+        ViewData = nullptr;
+
+        // 막힌 타일은 0, 나머지는 최대값에서 시작
+        const MINT32 tileCount = Grid->TileCount.X * Grid->TileCount.Y;
+        ClearanceList.resize(tileCount);
+
+        for (MINT32 i = 0; i < tileCount; ++i) {
+            ClearanceList[i] = (MTRUE == Grid->TileList[i].IsBlocked) ? 0 : static_cast<MUINT8>(MaxClearance);
+        }
+
+        Propagate(0, 0, Grid->TileCount.X - 1, Grid->TileCount.Y - 1);
+    }
+
+    void MClearanceMap::UpdateTiles(const std::vector<MIntPoint>& inChangedList)
+    {
+        const MINT32 countX = Grid->TileCount.X;
+        const MINT32 countY = Grid->TileCount.Y;
+
+        // 외부 데이터는 읽기 전용이므로 복사해서 갱신
+        if (nullptr != ViewData)
+        {
+            ClearanceList.assign(ViewData, ViewData + (countX * countY));
+            ViewData = nullptr;
+        }
+
+        for (const MIntPoint& index2D : inChangedList)
+        {
+            if (nullptr == Grid->GetTile(index2D)) {
+                continue;
+            }
+
+            // 값이 바뀔 수 있는 범위는 최대값 거리까지
+            // 범위 바로 바깥의 값은 바뀌지 않으므로 전파의 기준값으로 사용한다
+            const MINT32 minX = std::max(0, index2D.X - MaxClearance);
+            const MINT32 minY = std::max(0, index2D.Y - MaxClearance);
+            const MINT32 maxX = std::min(countX - 1, index2D.X + MaxClearance);
+            const MINT32 maxY = std::min(countY - 1, index2D.Y + MaxClearance);
+
+            for (MINT32 y = minY; y <= maxY; ++y)
+            {
+                for (MINT32 x = minX; x <= maxX; ++x)
+                {
+                    const MINT32 index = (y * countX) + x;
+                    ClearanceList[index] = (MTRUE == Grid->TileList[index].IsBlocked) ? 0 : static_cast<MUINT8>(MaxClearance);
+                }
+            }
+
+            Propagate(minX, minY, maxX, maxY);
+        }
+    }
+
+    void MClearanceMap::Load(const MGrid* inGrid, MINT32 inMaxClearance, const MUINT8* inClearanceData)
+    {
+        Grid = inGrid;
+        MaxClearance = std::max(1, std::min(inMaxClearance, 255));
+
+        ViewData = nullptr;
+
+        const MINT32 tileCount = Grid->TileCount.X * Grid->TileCount.Y;
+        ClearanceList.assign(inClearanceData, inClearanceData + tileCount);
+    }
+
+    void MClearanceMap::SetView(const MGrid* inGrid, MINT32 inMaxClearance, const MUINT8* inClearanceData)
+    {
+        Grid = inGrid;
+        MaxClearance = std::max(1, std::min(inMaxClearance, 255));
+
+        ClearanceList.clear();
+        ClearanceList.shrink_to_fit();
+        ViewData = inClearanceData;
+    }
+
+    MINT32 MClearanceMap::GetRequiredClearance(MFLOAT inRadius, MFLOAT inTileSize)
+    {
+        // 원이 걸치는 타일은 중앙에서 체비셰프 거리 ceil(반지름 - 0.5)까지
+        const MFLOAT radius = inRadius / inTileSize;
+        const MINT32 reach = std::max(0, static_cast<MINT32>(std::ceil(radius - 0.5f)));
+
+        return reach + 1;
+    }
+
+    void MClearanceMap::Propagate(MINT32 inMinX, MINT32 inMinY, MINT32 inMaxX, MINT32 inMaxY)
+    {
+        const MINT32 countX = Grid->TileCount.X;
+        const MINT32 countY = Grid->TileCount.Y;
+        MUINT8* clearanceList = ClearanceList.data();
+
+        auto UpdateFunc = [clearanceList](MINT32 inIndex, MINT32 inAroundIndex)
+        {
+            const MINT32 value = clearanceList[inAroundIndex] + 1;
+            if (value < clearanceList[inIndex]) {
+                clearanceList[inIndex] = static_cast<MUINT8>(value);
+            }
+        };
+
+        // 정방향 (위쪽 / 왼쪽에서 전파)
+        for (MINT32 y = inMinY; y <= inMaxY; ++y)
+        {
+            for (MINT32 x = inMinX; x <= inMaxX; ++x)
+            {
+                const MINT32 index = (y * countX) + x;
+                if (0 == clearanceList[index]) {
+                    continue;
+                }
+
+                if (0 < x) {
+                    UpdateFunc(index, index - 1);
+                }
+
+                if (0 < y)
+                {
+                    UpdateFunc(index, index - countX);
+
+                    if (0 < x) {
+                        UpdateFunc(index, index - countX - 1);
+                    }
+                    if (x + 1 < countX) {
+                        UpdateFunc(index, index - countX + 1);
+                    }
+                }
+            }
+        }
+
+        // 역방향 (아래쪽 / 오른쪽에서 전파)
+        for (MINT32 y = inMaxY; inMinY <= y; --y)
+        {
+            for (MINT32 x = inMaxX; inMinX <= x; --x)
+            {
+                const MINT32 index = (y * countX) + x;
+                if (0 == clearanceList[index]) {
+                    continue;
+                }
+
+                if (x + 1 < countX) {
+                    UpdateFunc(index, index + 1);
+                }
+
+                if (y + 1 < countY)
+                {
+                    UpdateFunc(index, index + countX);
+
+                    if (0 < x) {
+                        UpdateFunc(index, index + countX - 1);
+                    }
+                    if (x + 1 < countX) {
+                        UpdateFunc(index, index + countX + 1);
+                    }
+                }
+            }
+        }
+    }
+};
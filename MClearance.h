@@ -0,0 +1,74 @@
+﻿#pragma once
+
+#include <vector>
+
+#include "MPrerequisites.h"
+#include "MType.h"
+#include "MAstar.h"
+
+
+namespace MAstar
+{
+    //----------------------------------------------------------------------
+    // 타일별 장애물까지의 여유 공간
+    // 가장 가까운 막힌 타일까지의 체비셰프 거리 (막힌 타일은 0, 바로 옆은 1)
+    // 그리드 밖은 장애물로 보지 않는다 (CheckBlockLine과 동일)
+    // 외부 데이터를 복사 없이 연결해서 사용할 수 있다 (SetView, 갱신시에는 복사해서 사용)
+    //----------------------------------------------------------------------
+    class MClearanceMap
+    {
+    public:
+        // 전체 계산 (inMaxClearance 이상은 inMaxClearance로 저장)
+        void Build(const MGrid* inGrid, MINT32 inMaxClearance = 32);
+
+        // 막힘 정보가 바뀐 타일 주변만 다시 계산 (그리드는 이미 변경된 상태여야 한다)
+        void UpdateTiles(const std::vector<MIntPoint>& inChangedList);
+
+        // 저장해둔 값으로 설정 (계산하지 않고 복사, 값의 수는 그리드 타일 수와 같아야 한다)
+        void Load(const MGrid* inGrid, MINT32 inMaxClearance, const MUINT8* inClearanceData);
+
+        // 외부 데이터에 연결 (데이터는 연결되어 있는 동안 유지되어야 한다, 값의 수는 그리드 타일 수와 같아야 한다)
+        void SetView(const MGrid* inGrid, MINT32 inMaxClearance, const MUINT8* inClearanceData);
+
+        // 외부 데이터에 연결되어 있는지
+        MBOOL IsView() const {
+            return nullptr != ViewData;
+        }
+
+        MINT32 GetClearance(MINT32 inX, MINT32 inY) const {
+            return GetClearanceData()[(inY * Grid->TileCount.X) + inX];
+        }
+
+        const MGrid* GetGrid() const {
+            return Grid;
+        }
+
+        MINT32 GetMaxClearance() const {
+            return MaxClearance;
+        }
+
+        const MUINT8* GetClearanceData() const {
+            return (nullptr != ViewData) ? ViewData : ClearanceList.data();
+        }
+
+        // 반지름이 inRadius인 에이전트가 타일 중앙에 서기 위해 필요한 여유 공간
+        static MINT32 GetRequiredClearance(MFLOAT inRadius, MFLOAT inTileSize);
+
+    protected:
+        // 범위 안의 값을 주변 값으로 전파 (정방향 / 역방향 두번)
+        void Propagate(MINT32 inMinX, MINT32 inMinY, MINT32 inMaxX, MINT32 inMaxY);
+
+    protected:
+        // 대상 그리드
+        const MGrid* Grid = nullptr;
+
+        // 최대값
+        MINT32 MaxClearance = 0;
+
+        // 타일별 여유 공간
+        std::vector<MUINT8> ClearanceList;
+
+        // 연결된 외부 데이터
+        const MUINT8* ViewData = nullptr;
+    };
+};
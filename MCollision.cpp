@@ -1,8 +1,169 @@
 ﻿#include "MCollision.h"
 
+#if !defined(MCOLLISION_DISABLE_SIMD)
+	#if defined(__AVX__)
+		#define MCOLLISION_USE_AVX
+		#include <immintrin.h>
+	#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && 2 <= _M_IX86_FP)
+		#define MCOLLISION_USE_SSE
+		#include <emmintrin.h>
+	#endif
+#endif
+
 
 namespace MCollision
 {
+	namespace
+	{
+		// 박스 목록의 한 박스와 OBB 체크
+		MBOOL CheckOBB_Single(const MOBB2D& inQuery, const MBoxBatch& inBatch, MINT32 inIndex)
+		{
+			const MOBB2D box(
+				MVector2(inBatch.CenterX[inIndex], inBatch.CenterY[inIndex]),
+				MVector2(inBatch.AxisRightX[inIndex], inBatch.AxisRightY[inIndex]),
+				MVector2(inBatch.AxisUpX[inIndex], inBatch.AxisUpY[inIndex]),
+				inBatch.ExtentRight[inIndex],
+				inBatch.ExtentUp[inIndex]
+			);
+
+			return CheckOBB(inQuery, box);
+		}
+
+#if defined(MCOLLISION_USE_AVX)
+		// 박스 8개를 한번에 체크해서 충돌하는 박스의 비트를 얻는다
+		const MINT32 SimdWidth = 8;
+
+		MUINT32 CheckOBB_Simd(const MOBB2D& inQuery, const MBoxBatch& inBatch, MINT32 inIndex)
+		{
+			const __m256 signMask = _mm256_set1_ps(-0.0f);
+			auto Abs = [&signMask](__m256 inValue) { return _mm256_andnot_ps(signMask, inValue); };
+			auto Dot = [](__m256 inAX, __m256 inAY, __m256 inBX, __m256 inBY) { return _mm256_add_ps(_mm256_mul_ps(inAX, inBX), _mm256_mul_ps(inAY, inBY)); };
+			auto Sum = [](__m256 inExtent, __m256 inSkewExtent, __m256 inSkew, __m256 inExtent1, __m256 inProject1, __m256 inExtent2, __m256 inProject2) {
+				const __m256 sum = _mm256_add_ps(inExtent, _mm256_mul_ps(inSkewExtent, inSkew));
+				return _mm256_add_ps(_mm256_add_ps(sum, _mm256_mul_ps(inExtent1, inProject1)), _mm256_mul_ps(inExtent2, inProject2));
+			};
+
+			// 체크할 박스 정보
+			const __m256 rightX = _mm256_set1_ps(inQuery.AxisRight.X);
+			const __m256 rightY = _mm256_set1_ps(inQuery.AxisRight.Y);
+			const __m256 upX = _mm256_set1_ps(inQuery.AxisUp.X);
+			const __m256 upY = _mm256_set1_ps(inQuery.AxisUp.Y);
+			const __m256 extentRight = _mm256_set1_ps(inQuery.ExtentRight);
+			const __m256 extentUp = _mm256_set1_ps(inQuery.ExtentUp);
+
+			// 대상 박스 정보
+			const __m256 targetRightX = _mm256_loadu_ps(&inBatch.AxisRightX[inIndex]);
+			const __m256 targetRightY = _mm256_loadu_ps(&inBatch.AxisRightY[inIndex]);
+			const __m256 targetUpX = _mm256_loadu_ps(&inBatch.AxisUpX[inIndex]);
+			const __m256 targetUpY = _mm256_loadu_ps(&inBatch.AxisUpY[inIndex]);
+			const __m256 targetExtentRight = _mm256_loadu_ps(&inBatch.ExtentRight[inIndex]);
+			const __m256 targetExtentUp = _mm256_loadu_ps(&inBatch.ExtentUp[inIndex]);
+
+			// 중앙 위치의 거리 벡터
+			const __m256 distX = _mm256_sub_ps(_mm256_loadu_ps(&inBatch.CenterX[inIndex]), _mm256_set1_ps(inQuery.Center.X));
+			const __m256 distY = _mm256_sub_ps(_mm256_loadu_ps(&inBatch.CenterY[inIndex]), _mm256_set1_ps(inQuery.Center.Y));
+
+			// 두 박스 축 사이의 투영값
+			const __m256 rightRight = Abs(Dot(rightX, rightY, targetRightX, targetRightY));
+			const __m256 rightUp = Abs(Dot(rightX, rightY, targetUpX, targetUpY));
+			const __m256 upRight = Abs(Dot(upX, upY, targetRightX, targetRightY));
+			const __m256 upUp = Abs(Dot(upX, upY, targetUpX, targetUpY));
+
+			// 자기 축끼리의 투영값 (CheckOBB 참고)
+			const __m256 skew = Abs(Dot(rightX, rightY, upX, upY));
+			const __m256 targetSkew = Abs(Dot(targetRightX, targetRightY, targetUpX, targetUpY));
+
+			// 한 축이라도 분리되면 충돌하지 않는다
+			__m256 separate = _mm256_cmp_ps(Sum(extentRight, extentUp, skew, targetExtentRight, rightRight, targetExtentUp, rightUp), Abs(Dot(rightX, rightY, distX, distY)), _CMP_LT_OQ);
+			separate = _mm256_or_ps(separate, _mm256_cmp_ps(Sum(extentUp, extentRight, skew, targetExtentRight, upRight, targetExtentUp, upUp), Abs(Dot(upX, upY, distX, distY)), _CMP_LT_OQ));
+			separate = _mm256_or_ps(separate, _mm256_cmp_ps(Sum(targetExtentRight, targetExtentUp, targetSkew, extentRight, rightRight, extentUp, upRight), Abs(Dot(targetRightX, targetRightY, distX, distY)), _CMP_LT_OQ));
+			separate = _mm256_or_ps(separate, _mm256_cmp_ps(Sum(targetExtentUp, targetExtentRight, targetSkew, extentRight, rightUp, extentUp, upUp), Abs(Dot(targetUpX, targetUpY, distX, distY)), _CMP_LT_OQ));
+
+			return static_cast<MUINT32>(~_mm256_movemask_ps(separate)) & 0xFF;
+		}
+#elif defined(MCOLLISION_USE_SSE)
+		// 박스 4개를 한번에 체크해서 충돌하는 박스의 비트를 얻는다
+		const MINT32 SimdWidth = 4;
+
+		MUINT32 CheckOBB_Simd(const MOBB2D& inQuery, const MBoxBatch& inBatch, MINT32 inIndex)
+		{
+			const __m128 signMask = _mm_set1_ps(-0.0f);
+			auto Abs = [&signMask](__m128 inValue) { return _mm_andnot_ps(signMask, inValue); };
+			auto Dot = [](__m128 inAX, __m128 inAY, __m128 inBX, __m128 inBY) { return _mm_add_ps(_mm_mul_ps(inAX, inBX), _mm_mul_ps(inAY, inBY)); };
+			auto Sum = [](__m128 inExtent, __m128 inSkewExtent, __m128 inSkew, __m128 inExtent1, __m128 inProject1, __m128 inExtent2, __m128 inProject2) {
+				const __m128 sum = _mm_add_ps(inExtent, _mm_mul_ps(inSkewExtent, inSkew));
+				return _mm_add_ps(_mm_add_ps(sum, _mm_mul_ps(inExtent1, inProject1)), _mm_mul_ps(inExtent2, inProject2));
+			};
+
+			// 체크할 박스 정보
+			const __m128 rightX = _mm_set1_ps(inQuery.AxisRight.X);
+			const __m128 rightY = _mm_set1_ps(inQuery.AxisRight.Y);
+			const __m128 upX = _mm_set1_ps(inQuery.AxisUp.X);
+			const __m128 upY = _mm_set1_ps(inQuery.AxisUp.Y);
+			const __m128 extentRight = _mm_set1_ps(inQuery.ExtentRight);
+			const __m128 extentUp = _mm_set1_ps(inQuery.ExtentUp);
+
+			// 대상 박스 정보
+			const __m128 targetRightX = _mm_loadu_ps(&inBatch.AxisRightX[inIndex]);
+			const __m128 targetRightY = _mm_loadu_ps(&inBatch.AxisRightY[inIndex]);
+			const __m128 targetUpX = _mm_loadu_ps(&inBatch.AxisUpX[inIndex]);
+			const __m128 targetUpY = _mm_loadu_ps(&inBatch.AxisUpY[inIndex]);
+			const __m128 targetExtentRight = _mm_loadu_ps(&inBatch.ExtentRight[inIndex]);
+			const __m128 targetExtentUp = _mm_loadu_ps(&inBatch.ExtentUp[inIndex]);
+
+			// 중앙 위치의 거리 벡터
+			const __m128 distX = _mm_sub_ps(_mm_loadu_ps(&inBatch.CenterX[inIndex]), _mm_set1_ps(inQuery.Center.X));
+			const __m128 distY = _mm_sub_ps(_mm_loadu_ps(&inBatch.CenterY[inIndex]), _mm_set1_ps(inQuery.Center.Y));
+
+			// 두 박스 축 사이의 투영값
+			const __m128 rightRight = Abs(Dot(rightX, rightY, targetRightX, targetRightY));
+			const __m128 rightUp = Abs(Dot(rightX, rightY, targetUpX, targetUpY));
+			const __m128 upRight = Abs(Dot(upX, upY, targetRightX, targetRightY));
+			const __m128 upUp = Abs(Dot(upX, upY, targetUpX, targetUpY));
+
+			// 자기 축끼리의 투영값 (CheckOBB 참고)
+			const __m128 skew = Abs(Dot(rightX, rightY, upX, upY));
+			const __m128 targetSkew = Abs(Dot(targetRightX, targetRightY, targetUpX, targetUpY));
+
+			// 한 축이라도 분리되면 충돌하지 않는다
+			__m128 separate = _mm_cmplt_ps(Sum(extentRight, extentUp, skew, targetExtentRight, rightRight, targetExtentUp, rightUp), Abs(Dot(rightX, rightY, distX, distY)));
+			separate = _mm_or_ps(separate, _mm_cmplt_ps(Sum(extentUp, extentRight, skew, targetExtentRight, upRight, targetExtentUp, upUp), Abs(Dot(upX, upY, distX, distY))));
+			separate = _mm_or_ps(separate, _mm_cmplt_ps(Sum(targetExtentRight, targetExtentUp, targetSkew, extentRight, rightRight, extentUp, upRight), Abs(Dot(targetRightX, targetRightY, distX, distY))));
+			separate = _mm_or_ps(separate, _mm_cmplt_ps(Sum(targetExtentUp, targetExtentRight, targetSkew, extentRight, rightUp, extentUp, upUp), Abs(Dot(targetUpX, targetUpY, distX, distY))));
+
+			return static_cast<MUINT32>(~_mm_movemask_ps(separate)) & 0xF;
+		}
+#endif
+
+		// 박스 목록을 SIMD 폭 단위로 체크해서 충돌 비트를 넘겨준다
+		// inFunc(시작 인덱스, 충돌 비트)
+		template<typename FUNC>
+		void CheckOBB_Batch(const MOBB2D& inQuery, const MBoxBatch& inBatch, FUNC inFunc)
+		{
+			const MINT32 count = inBatch.GetCount();
+
+			MINT32 index = 0;
+
+#if defined(MCOLLISION_USE_AVX) || defined(MCOLLISION_USE_SSE)
+			for (; index + SimdWidth <= count; index += SimdWidth)
+			{
+				const MUINT32 bitList = CheckOBB_Simd(inQuery, inBatch, index);
+				if (0 != bitList) {
+					inFunc(index, bitList);
+				}
+			}
+#endif
+
+			// 남은 박스는 하나씩 체크
+			for (; index < count; ++index)
+			{
+				if (MTRUE == CheckOBB_Single(inQuery, inBatch, index)) {
+					inFunc(index, 1u);
+				}
+			}
+		}
+	}
+
 	//---------------------------------------------------------
 	// Box2D
 	//---------------------------------------------------------
@@ -63,61 +224,161 @@ namespace MCollision
 	}
 
 
+	//---------------------------------------------------------
+	// OBB2D
+	//---------------------------------------------------------
+	MOBB2D::MOBB2D(const MVector2& inCenter, const MVector2& inAxisRight, const MVector2& inAxisUp, MFLOAT inExtentRight, MFLOAT inExtentUp)
+	{
+		Center = inCenter;
+		AxisRight = inAxisRight;
+		AxisUp = inAxisUp;
+		ExtentRight = inExtentRight;
+		ExtentUp = inExtentUp;
+	}
+
+	MOBB2D::MOBB2D(const MBox2D& inBox)
+	{
+		Set(inBox);
+	}
+
+	void MOBB2D::Set(const MBox2D& inBox)
+	{
+		const MVector2 right = inBox.GetRightVector();
+		const MVector2 up = inBox.GetUpVector();
+
+		Center = inBox.GetCenterPos();
+		AxisRight = right.GetNormal();
+		AxisUp = up.GetNormal();
+		ExtentRight = MVector2::DotProduct(right, AxisRight);
+		ExtentUp = MVector2::DotProduct(up, AxisUp);
+	}
+
+	MBox2D MOBB2D::GetBox() const
+	{
+		const MVector2 right = AxisRight * ExtentRight;
+		const MVector2 up = AxisUp * ExtentUp;
+
+		return MBox2D(
+			Center - right + up,
+			Center + right + up,
+			Center - right - up,
+			Center + right - up
+		);
+	}
+
+
+	//---------------------------------------------------------
+	// BoxBatch
+	//---------------------------------------------------------
+	void MBoxBatch::Clear()
+	{
+		for (std::vector<MFLOAT>* list : { &CenterX, &CenterY, &AxisRightX, &AxisRightY, &AxisUpX, &AxisUpY, &ExtentRight, &ExtentUp }) {
+			list->clear();
+		}
+	}
+
+	void MBoxBatch::Reserve(MINT32 inCount)
+	{
+		for (std::vector<MFLOAT>* list : { &CenterX, &CenterY, &AxisRightX, &AxisRightY, &AxisUpX, &AxisUpY, &ExtentRight, &ExtentUp }) {
+			list->reserve(inCount);
+		}
+	}
+
+	void MBoxBatch::Add(const MBox2D& inBox)
+	{
+		Add(MOBB2D(inBox));
+	}
+
+	void MBoxBatch::Add(const MOBB2D& inBox)
+	{
+		CenterX.push_back(inBox.Center.X);
+		CenterY.push_back(inBox.Center.Y);
+		AxisRightX.push_back(inBox.AxisRight.X);
+		AxisRightY.push_back(inBox.AxisRight.Y);
+		AxisUpX.push_back(inBox.AxisUp.X);
+		AxisUpY.push_back(inBox.AxisUp.Y);
+		ExtentRight.push_back(inBox.ExtentRight);
+		ExtentUp.push_back(inBox.ExtentUp);
+	}
+
+
 	//---------------------------------------------------------
 	// Logic
 	//---------------------------------------------------------
 	MBOOL CheckOBB(const MBox2D& inBox1, const MBox2D& inBox2)
 	{
-		// 사용할 벡터 정보
-		std::array<MVector2, 4> valueList;		// 벡터 정보
-		std::array<MVector2, 4> axisList;		// 축 정보(정규화)
+		return CheckOBB(MOBB2D(inBox1), MOBB2D(inBox2));
+	}
 
-		// 추가 함수
-		auto AddFunc = [&axisList, &valueList](MINT32 inIndex, const MVector2& inVector)
-		{
-			valueList[inIndex] = inVector;
-			axisList[inIndex] = inVector.GetNormal();
-		};
+	MBOOL CheckOBB(const MOBB2D& inBox1, const MBox2D& inBox2)
+	{
+		return CheckOBB(inBox1, MOBB2D(inBox2));
+	}
 
-		// 박스1의 위 / 오른쪽 벡터 추가
-		AddFunc(0, inBox1.GetUpVector());
-		AddFunc(1, inBox1.GetRightVector());
+	MBOOL CheckOBB(const MOBB2D& inBox1, const MOBB2D& inBox2)
+	{
+		// 두 박스 축 사이의 투영값
+		const MFLOAT rightRight = abs(MVector2::DotProduct(inBox1.AxisRight, inBox2.AxisRight));
+		const MFLOAT rightUp = abs(MVector2::DotProduct(inBox1.AxisRight, inBox2.AxisUp));
+		const MFLOAT upRight = abs(MVector2::DotProduct(inBox1.AxisUp, inBox2.AxisRight));
+		const MFLOAT upUp = abs(MVector2::DotProduct(inBox1.AxisUp, inBox2.AxisUp));
 
-		// 박스2의 위 / 오른쪽 벡터 추가
-		AddFunc(2, inBox2.GetUpVector());
-		AddFunc(3, inBox2.GetRightVector());
-		
+		// MakeBox로 만든 박스는 두 축이 정확히 수직이 아닐 수 있으므로 자기 축끼리의 투영값도 사용
+		const MFLOAT skew1 = abs(MVector2::DotProduct(inBox1.AxisRight, inBox1.AxisUp));
+		const MFLOAT skew2 = abs(MVector2::DotProduct(inBox2.AxisRight, inBox2.AxisUp));
 
 		// 중앙 위치의 거리 벡터
-		MVector2 distVector = inBox2.GetCenterPos() - inBox1.GetCenterPos();
+		const MVector2 distVector = inBox2.Center - inBox1.Center;
+
+		// 각 축에 두 박스를 투영한 크기의 합이 거리보다 작다면 분리되어 있다
+		// 박스1의 오른쪽 축
+		if (inBox1.ExtentRight + (inBox1.ExtentUp * skew1) + (inBox2.ExtentRight * rightRight) + (inBox2.ExtentUp * rightUp) < abs(MVector2::DotProduct(inBox1.AxisRight, distVector))) {
+			return MFALSE;
+		}
+
+		// 박스1의 위쪽 축
+		if (inBox1.ExtentUp + (inBox1.ExtentRight * skew1) + (inBox2.ExtentRight * upRight) + (inBox2.ExtentUp * upUp) < abs(MVector2::DotProduct(inBox1.AxisUp, distVector))) {
+			return MFALSE;
+		}
+
+		// 박스2의 오른쪽 축
+		if (inBox2.ExtentRight + (inBox2.ExtentUp * skew2) + (inBox1.ExtentRight * rightRight) + (inBox1.ExtentUp * upRight) < abs(MVector2::DotProduct(inBox2.AxisRight, distVector))) {
+			return MFALSE;
+		}
+
+		// 박스2의 위쪽 축
+		if (inBox2.ExtentUp + (inBox2.ExtentRight * skew2) + (inBox1.ExtentRight * rightUp) + (inBox1.ExtentUp * upUp) < abs(MVector2::DotProduct(inBox2.AxisUp, distVector))) {
+			return MFALSE;
+		}
 
-		
-		// 각 축 벡터에 정보를 투영하여 
-		for (MINT32 i = 0; i < 4; ++i)
+		return MTRUE;
+	}
+
+	void CheckOBB_BatchMask(const MOBB2D& inQuery, const MBoxBatch& inBatch, std::vector<MUINT32>& outMaskList)
+	{
+		outMaskList.assign((inBatch.GetCount() + 31) / 32, 0);
+
+		CheckOBB_Batch(inQuery, inBatch, [&outMaskList](MINT32 inIndex, MUINT32 inBitList)
 		{
-			MFLOAT sum = 0;
+			// 시작 인덱스가 SIMD 폭의 배수이므로 값 하나에 모두 들어간다
+			outMaskList[inIndex / 32] |= (inBitList << (inIndex % 32));
+		});
+	}
 
-			// 사용할 축을 얻는다
-			const MVector2& axis = axisList[i];
+	MINT32 CheckOBB_BatchList(const MOBB2D& inQuery, const MBoxBatch& inBatch, std::vector<MINT32>& outHitList)
+	{
+		outHitList.clear();
 
-			// 벡터를 축에 투영
-			for (MINT32 c = 0; c < 4; ++c)
+		CheckOBB_Batch(inQuery, inBatch, [&outHitList](MINT32 inIndex, MUINT32 inBitList)
+		{
+			for (MINT32 i = 0; 0 != inBitList; ++i, inBitList >>= 1)
 			{
-				MFLOAT temp = MVector2::DotProduct(axis, valueList[c]);
-				sum += abs(temp);
+				if (0 != (inBitList & 1)) {
+					outHitList.push_back(inIndex + i);
+				}
 			}
+		});
 
-			// 거리를 투영
-			MFLOAT distance = MVector2::DotProduct(axis, distVector);
-			distance = abs(distance);
-
-			// 한 축이라도 
-			// 합이 거리보다 작다면 충돌
-			if (sum < distance) {
-				return MFALSE;
-			}
-		}
-		
-		return MTRUE;
+		return static_cast<MINT32>(outHitList.size());
 	}
 };
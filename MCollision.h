@@ -1,5 +1,7 @@
 ﻿#pragma once
 
+#include <vector>
+
 #include "MPrerequisites.h"
 #include "MVector.h"
 
@@ -37,9 +39,75 @@ namespace MCollision
 	};
 
 
+	//---------------------------------------------------------------
+	// 중앙 / 축 / 크기로 표현한 박스
+	// 축 정규화를 미리 해두므로 고정된 박스는 한번만 만들어두고 체크에 사용
+	//---------------------------------------------------------------
+	class MOBB2D
+	{
+	public:
+		MOBB2D(){}
+		MOBB2D(const MVector2& inCenter, const MVector2& inAxisRight, const MVector2& inAxisUp, MFLOAT inExtentRight, MFLOAT inExtentUp);
+		explicit MOBB2D(const MBox2D& inBox);
+
+	public:
+		// 박스 정보로 설정
+		void Set(const MBox2D& inBox);
+
+		// 네 꼭지점 박스로 변환
+		MBox2D GetBox() const;
+
+	public:
+		MVector2 Center;
+		MVector2 AxisRight;			// 정규화된 오른쪽 축
+		MVector2 AxisUp;			// 정규화된 위쪽 축
+		MFLOAT ExtentRight = 0;		// 중앙에서 오른쪽 끝까지의 거리
+		MFLOAT ExtentUp = 0;		// 중앙에서 위쪽 끝까지의 거리
+	};
+
+
+	//---------------------------------------------------------------
+	// 체크 대상 박스 목록 (SoA)
+	// SIMD로 4 / 8개씩 체크할 수 있도록 성분별로 저장
+	//---------------------------------------------------------------
+	class MBoxBatch
+	{
+	public:
+		void Clear();
+		void Reserve(MINT32 inCount);
+
+		// 박스 추가
+		void Add(const MBox2D& inBox);
+		void Add(const MOBB2D& inBox);
+
+		MINT32 GetCount() const {
+			return static_cast<MINT32>(CenterX.size());
+		}
+
+	public:
+		std::vector<MFLOAT> CenterX;
+		std::vector<MFLOAT> CenterY;
+		std::vector<MFLOAT> AxisRightX;
+		std::vector<MFLOAT> AxisRightY;
+		std::vector<MFLOAT> AxisUpX;
+		std::vector<MFLOAT> AxisUpY;
+		std::vector<MFLOAT> ExtentRight;
+		std::vector<MFLOAT> ExtentUp;
+	};
+
+
 	//---------------------------------------------------------------
 	// 로직
 	//---------------------------------------------------------------
 	// OBB 체크
 	MBOOL CheckOBB(const MBox2D& inBox1, const MBox2D& inBox2);
+	MBOOL CheckOBB(const MOBB2D& inBox1, const MOBB2D& inBox2);
+	MBOOL CheckOBB(const MOBB2D& inBox1, const MBox2D& inBox2);
+
+	// 한 박스를 여러 박스와 OBB 체크 (MCOLLISION_DISABLE_SIMD가 정의되어 있다면 SIMD를 사용하지 않는다)
+	// outMaskList : 충돌하는 박스의 비트 (i번째 박스는 (i / 32)번째 값의 (i % 32)번째 비트)
+	void CheckOBB_BatchMask(const MOBB2D& inQuery, const MBoxBatch& inBatch, std::vector<MUINT32>& outMaskList);
+
+	// outHitList : 충돌하는 박스의 인덱스 (순서대로), 충돌하는 박스 개수를 반환
+	MINT32 CheckOBB_BatchList(const MOBB2D& inQuery, const MBoxBatch& inBatch, std::vector<MINT32>& outHitList);
 };
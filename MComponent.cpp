@@ -0,0 +1,442 @@
+﻿#include "MComponent.h"
+#include "MGridCommon.h"
+
+#include <thread>
+
+
+namespace MAstar
+{
+    void MComponentMap::Build(const MGrid* inGrid)
+    {
+        Grid = inGrid;
+
+        const MINT32 countX = Grid->TileCount.X;
+        const MINT32 rowCount = Grid->TileCount.Y;
+        const MINT32 tileCount = countX * rowCount;
+
+        // 이동 가능한 타일은 자신이 대표
+        TileParentList.resize(tileCount);
+        for (MINT32 i = 0; i < tileCount; ++i) {
+            TileParentList[i] = (MTRUE == Grid->TileList[i].IsBlocked) ? -1 : i;
+        }
+
+        // 행 묶음 안에서만 연결하면 스레드끼리 같은 타일을 건드리지 않는다
+        const MINT32 threadCount = std::max(1, std::min(ThreadCount, rowCount / MinRowCountPerThread));
+
+        std::vector<std::thread> threadList;
+        for (MINT32 i = 1; i < threadCount; ++i) {
+            threadList.emplace_back(&MComponentMap::UnionRows, this, (rowCount * i) / threadCount, (rowCount * (i + 1)) / threadCount);
+        }
+
+        UnionRows(0, rowCount / threadCount);
+
+        for (std::thread& thread : threadList) {
+            thread.join();
+        }
+
+        // 묶음 경계의 행을 위쪽 행과 연결
+        for (MINT32 i = 1; i < threadCount; ++i)
+        {
+            const MINT32 y = (rowCount * i) / threadCount;
+            for (MINT32 x = 0; x < countX; ++x)
+            {
+                const MINT32 index = (y * countX) + x;
+                if (0 <= TileParentList[index] && 0 <= TileParentList[index - countX]) {
+                    UnionTile(index, index - countX);
+                }
+            }
+        }
+
+        // 대표 타일은 영역에서 인덱스가 가장 작은 타일이므로 순서대로 번호를 준다
+        TileLabelList.assign(tileCount, -1);
+        LabelParentList.clear();
+        LabelRankList.clear();
+
+        for (MINT32 i = 0; i < tileCount; ++i)
+        {
+            if (TileParentList[i] < 0) {
+                continue;
+            }
+
+            const MINT32 root = FindTileRoot(i);
+            TileLabelList[i] = (root == i) ? AddLabel() : TileLabelList[root];
+        }
+
+        TileParentList.clear();
+        TileParentList.shrink_to_fit();
+
+        VisitStampList.assign(tileCount, 0);
+        VisitSeedList.assign(tileCount, 0);
+        VisitStamp = 0;
+    }
+
+    void MComponentMap::UpdateTiles(const std::vector<MIntPoint>& inChangedList)
+    {
+        std::vector<MIntPoint> blockedList;
+        std::vector<MIntPoint> openedList;
+
+        for (const MIntPoint& index2D : inChangedList)
+        {
+            const MTile* tile = Grid->GetTile(index2D);
+            if (nullptr == tile) {
+                continue;
+            }
+
+            const MINT32 index = Grid->GetTileIndex(index2D);
+
+            if (MTRUE == tile->IsBlocked && 0 <= TileLabelList[index])
+            {
+                TileLabelList[index] = -1;
+                blockedList.push_back(index2D);
+            }
+            else if (MFALSE == tile->IsBlocked && TileLabelList[index] < 0)
+            {
+                openedList.push_back(index2D);
+            }
+        }
+
+        // 막힌 타일이 여러개면 서로 이어서 영역을 나눌 수 있으므로 한번에 처리
+        if (MFALSE == blockedList.empty()) {
+            SplitComponent(blockedList);
+        }
+
+        // 나누기 검색에서 이미 번호를 받은 열린 타일은 넘어간다
+        for (const MIntPoint& index2D : openedList)
+        {
+            if (TileLabelList[Grid->GetTileIndex(index2D)] < 0) {
+                MergeComponent(index2D);
+            }
+        }
+    }
+
+    MINT32 MComponentMap::GetComponent(MINT32 inX, MINT32 inY) const
+    {
+        if (nullptr == Grid->GetTile(inX, inY)) {
+            return -1;
+        }
+
+        const MINT32 label = TileLabelList[(inY * Grid->TileCount.X) + inX];
+        if (label < 0) {
+            return -1;
+        }
+
+        return FindLabel(label);
+    }
+
+    MBOOL MComponentMap::IsReachable(const MIntPoint& inStartIndex2D, const MIntPoint& inEndIndex2D) const
+    {
+        const MINT32 endComponent = GetComponent(inEndIndex2D);
+        if (endComponent < 0) {
+            return MFALSE;
+        }
+
+        const MINT32 startComponent = GetComponent(inStartIndex2D);
+        if (startComponent < 0) {
+            return MTRUE;
+        }
+
+        return startComponent == endComponent;
+    }
+
+    MBOOL MComponentMap::FindNearestTile(const MIntPoint& inIndex2D, MINT32 inComponent, MINT32 inMaxDistance, MIntPoint& outIndex2D) const
+    {
+        MINT32 bestDistance = -1;
+
+        // 가까운 링부터 검사 (링 안쪽 거리가 찾은 거리보다 멀어지면 종료)
+        for (MINT32 ring = 0; ring <= inMaxDistance; ++ring)
+        {
+            if (0 <= bestDistance && bestDistance <= ring * ring) {
+                break;
+            }
+
+            const MINT32 minX = inIndex2D.X - ring;
+            const MINT32 maxX = inIndex2D.X + ring;
+            const MINT32 minY = inIndex2D.Y - ring;
+            const MINT32 maxY = inIndex2D.Y + ring;
+
+            for (MINT32 y = minY; y <= maxY; ++y)
+            {
+                // 위 / 아래 행이 아니면 양 끝만 검사
+                const MINT32 stepX = (y == minY || y == maxY) ? 1 : std::max(1, maxX - minX);
+
+                for (MINT32 x = minX; x <= maxX; x += stepX)
+                {
+                    if (inComponent != GetComponent(x, y)) {
+                        continue;
+                    }
+
+                    const MINT32 distance = ((x - inIndex2D.X) * (x - inIndex2D.X)) + ((y - inIndex2D.Y) * (y - inIndex2D.Y));
+                    if (bestDistance < 0 || distance < bestDistance)
+                    {
+                        bestDistance = distance;
+                        outIndex2D = MIntPoint(x, y);
+                    }
+                }
+            }
+        }
+
+        return 0 <= bestDistance;
+    }
+
+    void MComponentMap::UnionRows(MINT32 inStartY, MINT32 inEndY)
+    {
+        const MINT32 countX = Grid->TileCount.X;
+
+        for (MINT32 y = inStartY; y < inEndY; ++y)
+        {
+            for (MINT32 x = 0; x < countX; ++x)
+            {
+                const MINT32 index = (y * countX) + x;
+                if (TileParentList[index] < 0) {
+                    continue;
+                }
+
+                // 왼쪽 / 위쪽 타일과 연결
+                if (0 < x && 0 <= TileParentList[index - 1]) {
+                    UnionTile(index, index - 1);
+                }
+
+                if (inStartY < y && 0 <= TileParentList[index - countX]) {
+                    UnionTile(index, index - countX);
+                }
+            }
+        }
+    }
+
+    MINT32 MComponentMap::FindTileRoot(MINT32 inIndex)
+    {
+        // 경로 절반 압축
+        while (TileParentList[inIndex] != inIndex)
+        {
+            TileParentList[inIndex] = TileParentList[TileParentList[inIndex]];
+            inIndex = TileParentList[inIndex];
+        }
+
+        return inIndex;
+    }
+
+    void MComponentMap::UnionTile(MINT32 inIndex1, MINT32 inIndex2)
+    {
+        const MINT32 root1 = FindTileRoot(inIndex1);
+        const MINT32 root2 = FindTileRoot(inIndex2);
+
+        // 인덱스가 작은 타일을 대표로
+        if (root1 < root2) {
+            TileParentList[root2] = root1;
+        }
+        else if (root2 < root1) {
+            TileParentList[root1] = root2;
+        }
+    }
+
+    MINT32 MComponentMap::FindLabel(MINT32 inLabel) const
+    {
+        while (LabelParentList[inLabel] != inLabel) {
+            inLabel = LabelParentList[inLabel];
+        }
+
+        return inLabel;
+    }
+
+    MINT32 MComponentMap::FindLabel_Compress(MINT32 inLabel)
+    {
+        while (LabelParentList[inLabel] != inLabel)
+        {
+            LabelParentList[inLabel] = LabelParentList[LabelParentList[inLabel]];
+            inLabel = LabelParentList[inLabel];
+        }
+
+        return inLabel;
+    }
+
+    MINT32 MComponentMap::UnionLabel(MINT32 inLabel1, MINT32 inLabel2)
+    {
+        MINT32 root1 = FindLabel_Compress(inLabel1);
+        MINT32 root2 = FindLabel_Compress(inLabel2);
+        if (root1 == root2) {
+            return root1;
+        }
+
+        // 깊이가 낮은 쪽을 아래로
+        if (LabelRankList[root1] < LabelRankList[root2]) {
+            std::swap(root1, root2);
+        }
+
+        LabelParentList[root2] = root1;
+        if (LabelRankList[root1] == LabelRankList[root2]) {
+            ++LabelRankList[root1];
+        }
+
+        return root1;
+    }
+
+    MINT32 MComponentMap::AddLabel()
+    {
+        const MINT32 label = static_cast<MINT32>(LabelParentList.size());
+        LabelParentList.push_back(label);
+        LabelRankList.push_back(0);
+
+        return label;
+    }
+
+    //----------------------------------------------------------------
+    // 막힌 타일 주변의 이동 가능한 타일에서 동시에 한칸씩 탐색한다
+    // 탐색끼리 만나면 하나로 합치고, 먼저 끝난 탐색은 떨어진 영역이므로 새 번호를 준다
+    // 탐색이 하나만 남으면 종료하므로 작은 쪽 영역 크기만큼만 비용이 든다
+    //----------------------------------------------------------------
+    void MComponentMap::SplitComponent(const std::vector<MIntPoint>& inBlockedList)
+    {
+        if (0 == ++VisitStamp)
+        {
+            std::fill(VisitStampList.begin(), VisitStampList.end(), 0);
+            VisitStamp = 1;
+        }
+
+        // 탐색 시작 타일별 검색 큐와 그룹 (합쳐진 탐색은 같은 그룹)
+        std::vector<std::vector<MINT32>> queueList;
+        std::vector<size_t> headList;
+        std::vector<MINT32> groupList;
+        std::vector<MBOOL> isDoneList;
+
+        for (const MIntPoint& blockedIndex2D : inBlockedList)
+        {
+            for (const MIntPoint& direction : GridDirectionList)
+            {
+                const MIntPoint seedIndex2D = blockedIndex2D + direction;
+                if (MFALSE == Grid->IsWalkable(seedIndex2D.X, seedIndex2D.Y)) {
+                    continue;
+                }
+
+                const MINT32 seedIndex = Grid->GetTileIndex(seedIndex2D);
+                if (VisitStamp == VisitStampList[seedIndex]) {
+                    continue;
+                }
+
+                const MINT32 seed = static_cast<MINT32>(queueList.size());
+                VisitStampList[seedIndex] = VisitStamp;
+                VisitSeedList[seedIndex] = seed;
+
+                queueList.push_back(std::vector<MINT32>(1, seedIndex));
+                headList.push_back(0);
+                groupList.push_back(seed);
+                isDoneList.push_back(MFALSE);
+            }
+        }
+
+        // 시작 타일이 하나라면 나눠질 수 없다 (막힌 타일을 지나는 경로는 들어오고 나가는 타일이 달라야 한다)
+        const MINT32 seedCount = static_cast<MINT32>(queueList.size());
+        if (seedCount <= 1) {
+            return;
+        }
+
+        auto FindGroup = [&groupList](MINT32 inSeed)
+        {
+            while (groupList[inSeed] != inSeed)
+            {
+                groupList[inSeed] = groupList[groupList[inSeed]];
+                inSeed = groupList[inSeed];
+            }
+            return inSeed;
+        };
+
+        MINT32 activeCount = seedCount;
+        std::vector<MBOOL> hasQueueList(seedCount);
+
+        while (1 < activeCount)
+        {
+            // 탐색마다 한칸씩 진행
+            for (MINT32 seed = 0; seed < seedCount; ++seed)
+            {
+                if (queueList[seed].size() <= headList[seed]) {
+                    continue;
+                }
+
+                const MINT32 group = FindGroup(seed);
+                const MIntPoint index2D = Grid->GetTileIndex2D(queueList[seed][headList[seed]++]);
+
+                for (const MIntPoint& direction : GridDirectionList)
+                {
+                    const MIntPoint nextIndex2D = index2D + direction;
+                    if (MFALSE == Grid->IsWalkable(nextIndex2D.X, nextIndex2D.Y)) {
+                        continue;
+                    }
+
+                    const MINT32 nextIndex = Grid->GetTileIndex(nextIndex2D);
+                    if (VisitStamp == VisitStampList[nextIndex])
+                    {
+                        // 다른 탐색과 만났다면 합친다 (끝난 탐색과는 만날 수 없다)
+                        const MINT32 otherGroup = FindGroup(VisitSeedList[nextIndex]);
+                        if (otherGroup != group)
+                        {
+                            groupList[otherGroup] = group;
+                            --activeCount;
+                        }
+                        continue;
+                    }
+
+                    VisitStampList[nextIndex] = VisitStamp;
+                    VisitSeedList[nextIndex] = seed;
+                    queueList[seed].push_back(nextIndex);
+                }
+            }
+
+            // 더이상 진행할 수 없는 그룹은 떨어진 영역이므로 새 번호를 준다
+            std::fill(hasQueueList.begin(), hasQueueList.end(), MFALSE);
+            for (MINT32 seed = 0; seed < seedCount; ++seed)
+            {
+                if (headList[seed] < queueList[seed].size()) {
+                    hasQueueList[FindGroup(seed)] = MTRUE;
+                }
+            }
+
+            for (MINT32 seed = 0; seed < seedCount && 1 < activeCount; ++seed)
+            {
+                if (seed != FindGroup(seed) || MTRUE == isDoneList[seed] || MTRUE == hasQueueList[seed]) {
+                    continue;
+                }
+
+                const MINT32 label = AddLabel();
+                for (MINT32 member = 0; member < seedCount; ++member)
+                {
+                    if (seed != FindGroup(member)) {
+                        continue;
+                    }
+
+                    for (const MINT32 index : queueList[member]) {
+                        TileLabelList[index] = label;
+                    }
+                }
+
+                isDoneList[seed] = MTRUE;
+                --activeCount;
+            }
+        }
+    }
+
+    void MComponentMap::MergeComponent(const MIntPoint& inIndex2D)
+    {
+        MINT32 root = -1;
+
+        for (const MIntPoint& direction : GridDirectionList)
+        {
+            const MIntPoint nearIndex2D = inIndex2D + direction;
+            if (MFALSE == Grid->IsWalkable(nearIndex2D.X, nearIndex2D.Y)) {
+                continue;
+            }
+
+            const MINT32 nearLabel = TileLabelList[Grid->GetTileIndex(nearIndex2D)];
+            if (nearLabel < 0) {
+                continue;
+            }
+
+            root = (root < 0) ? FindLabel_Compress(nearLabel) : UnionLabel(root, nearLabel);
+        }
+
+        // 주변에 영역이 없다면 새 영역
+        if (root < 0) {
+            root = AddLabel();
+        }
+
+        TileLabelList[Grid->GetTileIndex(inIndex2D)] = root;
+    }
+};
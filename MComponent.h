@@ -0,0 +1,91 @@
+﻿#pragma once
+
+#include <vector>
+
+#include "MPrerequisites.h"
+#include "MType.h"
+#include "MAstar.h"
+
+
+namespace MAstar
+{
+    //----------------------------------------------------------------------
+    // 이동 가능한 타일의 연결 영역 정보 (상하좌우 연결)
+    // 같은 영역 번호를 가진 타일끼리만 서로 이동할 수 있다 (막힌 타일은 -1)
+    // 영역 번호끼리도 합쳐질 수 있으므로 비교는 GetComponent 값으로 한다
+    //----------------------------------------------------------------------
+    class MComponentMap
+    {
+    public:
+        // 스레드 수 설정 (행 묶음 단위로 나눠서 처리)
+        void SetThreadCount(MINT32 inCount) {
+            ThreadCount = std::max(inCount, 1);
+        }
+
+        // 전체 계산
+        void Build(const MGrid* inGrid);
+
+        // 막힘 정보가 바뀐 타일 주변만 다시 계산 (그리드는 이미 변경된 상태여야 한다)
+        void UpdateTiles(const std::vector<MIntPoint>& inChangedList);
+
+        // 영역 번호 (막혔거나 범위 밖이면 -1)
+        MINT32 GetComponent(MINT32 inX, MINT32 inY) const;
+
+        MINT32 GetComponent(const MIntPoint& inIndex2D) const {
+            return GetComponent(inIndex2D.X, inIndex2D.Y);
+        }
+
+        // 시작 위치에서 종료 위치로 갈 수 있는지
+        // 막힌 타일에서 출발하는 경우는 알 수 없으므로 MTRUE (경로 검색은 막힌 시작 타일을 허용한다)
+        MBOOL IsReachable(const MIntPoint& inStartIndex2D, const MIntPoint& inEndIndex2D) const;
+
+        // 대상 위치에서 가장 가까운 (직선 거리) 해당 영역의 타일 (inMaxDistance 칸 안에 없다면 MFALSE)
+        MBOOL FindNearestTile(const MIntPoint& inIndex2D, MINT32 inComponent, MINT32 inMaxDistance, MIntPoint& outIndex2D) const;
+
+        const MGrid* GetGrid() const {
+            return Grid;
+        }
+
+    protected:
+        // 행 범위 안에서만 타일을 연결 (스레드별 처리)
+        void UnionRows(MINT32 inStartY, MINT32 inEndY);
+
+        // 타일 연결 정보의 대표 타일
+        MINT32 FindTileRoot(MINT32 inIndex);
+        void UnionTile(MINT32 inIndex1, MINT32 inIndex2);
+
+        // 영역 번호 연결 정보의 대표 번호
+        MINT32 FindLabel(MINT32 inLabel) const;
+        MINT32 FindLabel_Compress(MINT32 inLabel);
+        MINT32 UnionLabel(MINT32 inLabel1, MINT32 inLabel2);
+        MINT32 AddLabel();
+
+        // 막힌 타일들 주변의 영역이 나눠졌는지 확인해서 나눠진 부분에 새 번호를 준다
+        void SplitComponent(const std::vector<MIntPoint>& inBlockedList);
+
+        // 열린 타일 주변의 영역을 합친다
+        void MergeComponent(const MIntPoint& inIndex2D);
+
+    protected:
+        // 대상 그리드
+        const MGrid* Grid = nullptr;
+
+        // 계산에 사용할 스레드 수
+        MINT32 ThreadCount = 1;
+
+        // 타일별 영역 번호 (막힌 타일은 -1)
+        std::vector<MINT32> TileLabelList;
+
+        // 영역 번호끼리의 연결 정보
+        std::vector<MINT32> LabelParentList;
+        std::vector<MINT32> LabelRankList;
+
+        // 전체 계산시 타일 연결 정보
+        std::vector<MINT32> TileParentList;
+
+        // 영역 나누기 검색용 (검색마다 값을 올려서 초기화 없이 사용)
+        std::vector<MUINT32> VisitStampList;
+        std::vector<MINT32> VisitSeedList;
+        MUINT32 VisitStamp = 0;
+    };
+};
@@ -0,0 +1,563 @@
+﻿#include "MCooperative.h"
+#include "MGridCommon.h"
+
+#include <algorithm>
+
+
+namespace MAstar
+{
+    //---------------------------------------------------------------------------
+    // ReservationTable
+    //---------------------------------------------------------------------------
+    void MReservationTable::Reset(MINT32 inTileCount, MINT32 inDepth, MINT32 inTime)
+    {
+        TileCount = inTileCount;
+        Depth = std::max(inDepth, 1);
+        Time = inTime;
+
+        AgentList.assign(static_cast<size_t>(TileCount) * Depth, -1);
+        ParkAgentList.assign(TileCount, -1);
+        ParkTimeList.assign(TileCount, 0);
+    }
+
+    void MReservationTable::Advance()
+    {
+        // 지나간 시간의 칸은 (현재 시간 + 깊이)의 칸으로 다시 사용
+        const auto first = AgentList.begin() + GetSlotIndex(0, Time);
+        std::fill(first, first + TileCount, -1);
+
+        ++Time;
+    }
+
+    MINT32 MReservationTable::GetAgent(MINT32 inIndex, MINT32 inTime) const
+    {
+        if (MTRUE == IsInside(inTime))
+        {
+            const MINT32 agent = AgentList[GetSlotIndex(inIndex, inTime)];
+            if (0 <= agent) {
+                return agent;
+            }
+        }
+
+        if (0 <= ParkAgentList[inIndex] && ParkTimeList[inIndex] <= inTime) {
+            return ParkAgentList[inIndex];
+        }
+
+        return -1;
+    }
+
+    MBOOL MReservationTable::Reserve(MINT32 inIndex, MINT32 inTime, MINT32 inAgent)
+    {
+        if (MFALSE == IsInside(inTime)) {
+            return MTRUE;
+        }
+
+        if (MFALSE == IsFree(inIndex, inTime, inAgent)) {
+            return MFALSE;
+        }
+
+        AgentList[GetSlotIndex(inIndex, inTime)] = inAgent;
+        return MTRUE;
+    }
+
+    void MReservationTable::Release(MINT32 inIndex, MINT32 inTime, MINT32 inAgent)
+    {
+        if (MFALSE == IsInside(inTime)) {
+            return;
+        }
+
+        MINT32& agent = AgentList[GetSlotIndex(inIndex, inTime)];
+        if (agent == inAgent) {
+            agent = -1;
+        }
+    }
+
+    MBOOL MReservationTable::Park(MINT32 inIndex, MINT32 inTime, MINT32 inAgent)
+    {
+        const MINT32 parkAgent = ParkAgentList[inIndex];
+        if (0 <= parkAgent && parkAgent != inAgent) {
+            return MFALSE;
+        }
+
+        for (MINT32 time = std::max(inTime, Time); time < Time + Depth; ++time)
+        {
+            if (MFALSE == IsFree(inIndex, time, inAgent)) {
+                return MFALSE;
+            }
+        }
+
+        ParkAgentList[inIndex] = inAgent;
+        ParkTimeList[inIndex] = inTime;
+        return MTRUE;
+    }
+
+    void MReservationTable::Unpark(MINT32 inIndex, MINT32 inAgent)
+    {
+        if (ParkAgentList[inIndex] == inAgent) {
+            ParkAgentList[inIndex] = -1;
+        }
+    }
+
+    MBOOL MReservationTable::IsMoveFree(MINT32 inFromIndex, MINT32 inToIndex, MINT32 inTime, MINT32 inAgent) const
+    {
+        if (MFALSE == IsFree(inToIndex, inTime + 1, inAgent)) {
+            return MFALSE;
+        }
+
+        // 대상 타일에 있던 에이전트가 같은 시간에 출발 타일로 온다면 서로 지나치게 된다
+        const MINT32 agent = GetAgent(inToIndex, inTime);
+        if (inFromIndex == inToIndex || agent < 0 || agent == inAgent) {
+            return MTRUE;
+        }
+
+        return agent != GetAgent(inFromIndex, inTime + 1);
+    }
+
+
+    //---------------------------------------------------------------------------
+    // CooperativePlanner
+    //---------------------------------------------------------------------------
+    void MCooperativePlanner::SetWindow(MINT32 inWindow, MINT32 inReplanInterval)
+    {
+        Window = std::max(inWindow, 1);
+        ReplanInterval = std::max(1, std::min(inReplanInterval, Window));
+    }
+
+    void MCooperativePlanner::Reset(const MGrid* inGrid)
+    {
+        Grid = inGrid;
+
+        const MINT32 tileCount = Grid->TileCount.X * Grid->TileCount.Y;
+
+        // 계획은 현재 시간부터 윈도우 크기 이후까지
+        ReservationTable.Reset(tileCount, Window + 1);
+
+        AgentList.clear();
+        GoalDistanceMap.clear();
+        TileAgentList.assign(tileCount, -1);
+
+        ReplanCount = 0;
+        FailedPlanCount = 0;
+        ArriveCount = 0;
+        MoveCount = 0;
+        ConflictCount = 0;
+        ExpandCount = 0;
+    }
+
+    MINT32 MCooperativePlanner::AddAgent(const MIntPoint& inStartIndex2D, const MIntPoint& inGoalIndex2D)
+    {
+        if (nullptr == Grid->GetTile(inStartIndex2D.X, inStartIndex2D.Y) || nullptr == Grid->GetTile(inGoalIndex2D.X, inGoalIndex2D.Y)) {
+            return -1;
+        }
+
+        const MINT32 agentIndex = GetAgentCount();
+
+        AgentList.emplace_back();
+        MCooperativeAgent& agent = AgentList.back();
+
+        agent.Index2D = inStartIndex2D;
+        agent.GoalIndex2D = inGoalIndex2D;
+
+        AddGoalDistance(Grid->GetTileIndex(inGoalIndex2D));
+
+        // 재계획 전까지는 제자리에서 대기
+        agent.PlanList.assign(Window + 1, Grid->GetTileIndex(inStartIndex2D));
+        agent.PlanTime = GetTime();
+        agent.ReplanTime = GetTime();
+
+        ClashList.clear();
+        ReleaseClashPlan(agentIndex);
+
+        ReservePlan(agentIndex);
+        ReplanClashList();
+
+        return agentIndex;
+    }
+
+    MBOOL MCooperativePlanner::SetGoal(MINT32 inAgent, const MIntPoint& inGoalIndex2D)
+    {
+        if (inAgent < 0 || GetAgentCount() <= inAgent || nullptr == Grid->GetTile(inGoalIndex2D.X, inGoalIndex2D.Y)) {
+            return MFALSE;
+        }
+
+        MCooperativeAgent& agent = AgentList[inAgent];
+
+        if (MFALSE == (agent.GoalIndex2D == inGoalIndex2D))
+        {
+            AddGoalDistance(Grid->GetTileIndex(inGoalIndex2D));
+            RemoveGoalDistance(Grid->GetTileIndex(agent.GoalIndex2D));
+
+            agent.GoalIndex2D = inGoalIndex2D;
+        }
+
+        agent.ReplanTime = GetTime();
+        return MTRUE;
+    }
+
+    void MCooperativePlanner::Update()
+    {
+        const MINT32 time = GetTime();
+        const MINT32 agentCount = GetAgentCount();
+
+        //----------------------------------------------------------------
+        // 재계획 시간이 된 에이전트를 오래 기다린 순서로 제한 수만큼 재계획
+        // 다음 이동이 계획의 마지막이라면 제한과 상관없이 재계획
+        //----------------------------------------------------------------
+        ReplanList.clear();
+        for (MINT32 i = 0; i < agentCount; ++i)
+        {
+            if (AgentList[i].ReplanTime <= time) {
+                ReplanList.push_back(i);
+            }
+        }
+
+        std::stable_sort(ReplanList.begin(), ReplanList.end(), [this](MINT32 inLeft, MINT32 inRight) {
+            return AgentList[inLeft].ReplanTime < AgentList[inRight].ReplanTime;
+        });
+
+        MINT32 replanCount = 0;
+        for (const MINT32 agentIndex : ReplanList)
+        {
+            const MCooperativeAgent& agent = AgentList[agentIndex];
+            const MBOOL isPlanEnd = static_cast<MINT32>(agent.PlanList.size()) - 1 <= (time + 1 - agent.PlanTime);
+
+            if (replanCount < ReplanBudget || MTRUE == isPlanEnd)
+            {
+                Replan(agentIndex);
+                ++replanCount;
+            }
+        }
+
+        //----------------------------------------------------------------
+        // 계획대로 한칸씩 이동
+        //----------------------------------------------------------------
+        PrevIndexList.resize(agentCount);
+
+        for (MINT32 i = 0; i < agentCount; ++i)
+        {
+            MCooperativeAgent& agent = AgentList[i];
+
+            const MINT32 step = std::min(time + 1 - agent.PlanTime, static_cast<MINT32>(agent.PlanList.size()) - 1);
+            const MINT32 prevIndex = Grid->GetTileIndex(agent.Index2D);
+            const MINT32 nextIndex = agent.PlanList[step];
+
+            PrevIndexList[i] = prevIndex;
+
+            if (prevIndex == nextIndex) {
+                continue;
+            }
+
+            agent.Index2D = Grid->GetTileIndex2D(nextIndex);
+            ++MoveCount;
+
+            if (agent.Index2D == agent.GoalIndex2D) {
+                ++ArriveCount;
+            }
+        }
+
+        ReservationTable.Advance();
+
+        //----------------------------------------------------------------
+        // 예약을 지키지 못한 경우 체크 (같은 타일 / 서로 자리를 바꾼 이동)
+        //----------------------------------------------------------------
+        for (MINT32 i = 0; i < agentCount; ++i)
+        {
+            MINT32& tileAgent = TileAgentList[Grid->GetTileIndex(AgentList[i].Index2D)];
+            if (0 <= tileAgent) {
+                ++ConflictCount;
+            }
+            else {
+                tileAgent = i;
+            }
+        }
+
+        for (MINT32 i = 0; i < agentCount; ++i)
+        {
+            const MINT32 index = Grid->GetTileIndex(AgentList[i].Index2D);
+            if (index == PrevIndexList[i]) {
+                continue;
+            }
+
+            // 출발 타일에 있는 에이전트가 이번에 도착한 타일에서 왔다면 서로 지나쳤다
+            const MINT32 otherAgent = TileAgentList[PrevIndexList[i]];
+            if (i < otherAgent && index == PrevIndexList[otherAgent]) {
+                ++ConflictCount;
+            }
+        }
+
+        for (const MCooperativeAgent& agent : AgentList) {
+            TileAgentList[Grid->GetTileIndex(agent.Index2D)] = -1;
+        }
+    }
+
+    void MCooperativePlanner::Replan(MINT32 inAgent)
+    {
+        ClashList.clear();
+
+        PlanWindow(inAgent);
+        ReplanClashList();
+    }
+
+    void MCooperativePlanner::PlanWindow(MINT32 inAgent)
+    {
+        MCooperativeAgent& agent = AgentList[inAgent];
+
+        ReleasePlan(inAgent);
+
+        agent.PlanTime = GetTime();
+        agent.ReplanTime = GetTime() + ReplanInterval;
+        ++ReplanCount;
+
+        // 목표 위치에 갈 수 없다면 현재 위치 근처에 머무른다
+        const std::vector<MINT32>* distanceList = &GoalDistanceMap[Grid->GetTileIndex(agent.GoalIndex2D)].DistanceList;
+        if (INFINITY_DISTANCE == (*distanceList)[Grid->GetTileIndex(agent.Index2D)])
+        {
+            distanceList = nullptr;
+            ++FailedPlanCount;
+        }
+
+        // 이전 계획을 따를 수 있으므로 실패하지 않지만 예약이 어긋난 경우에는 제자리에서 대기
+        if (MFALSE == SearchWindow(inAgent, distanceList, agent.PlanList))
+        {
+            agent.PlanList.assign(Window + 1, Grid->GetTileIndex(agent.Index2D));
+            ReleaseClashPlan(inAgent);
+            ++FailedPlanCount;
+        }
+
+        ReservePlan(inAgent);
+    }
+
+    //----------------------------------------------------------------
+    // 대기하는 에이전트는 움직일 수 없으므로 그 타일로 들어오려던 에이전트가 비켜간다
+    // 대기하는 타일의 예약만 해제하므로 대기하는 에이전트가 다시 해제되지 않아서 반복은 에이전트 수 이내로 끝난다
+    //----------------------------------------------------------------
+    void MCooperativePlanner::ReleaseClashPlan(MINT32 inAgent)
+    {
+        const MINT32 index = Grid->GetTileIndex(AgentList[inAgent].Index2D);
+
+        // 현재 시간은 이미 지나가는 중이므로 다음 시간부터 (계속 차지하는 경우 포함)
+        for (MINT32 time = GetTime() + 1; time <= GetTime() + Window; ++time)
+        {
+            const MINT32 otherAgent = ReservationTable.GetAgent(index, time);
+            if (otherAgent < 0 || otherAgent == inAgent) {
+                continue;
+            }
+
+            // 같은 타일에 있는 에이전트는 다시 계획해도 비킬 수 없다
+            if (Grid->GetTileIndex(AgentList[otherAgent].Index2D) == index) {
+                continue;
+            }
+
+            ReleasePlan(otherAgent);
+            ClashList.push_back(otherAgent);
+        }
+    }
+
+    void MCooperativePlanner::ReplanClashList()
+    {
+        while (MFALSE == ClashList.empty())
+        {
+            const MINT32 agentIndex = ClashList.back();
+            ClashList.pop_back();
+
+            PlanWindow(agentIndex);
+        }
+    }
+
+    //----------------------------------------------------------------
+    // 시간 축 A*
+    // 노드는 (윈도우 안의 시간, 타일) 이고 이동 / 대기 모두 한칸 10
+    // 목표 위치에서 대기하는 경우만 비용이 없어서 도착한 뒤에는 그 자리에 머문다
+    // 윈도우 마지막 시간의 노드를 꺼내면 남은 거리가 실제 거리이므로 검색을 끝낸다
+    // 한 시간에 한칸만 이동하므로 시작 위치에서 윈도우 크기 이내의 영역만 노드로 사용한다
+    //----------------------------------------------------------------
+    MBOOL MCooperativePlanner::SearchWindow(MINT32 inAgent, const std::vector<MINT32>* inDistanceList, std::vector<MINT32>& outPlanList)
+    {
+        const MCooperativeAgent& agent = AgentList[inAgent];
+
+        const MINT32 time = GetTime();
+        const MINT32 startIndex = Grid->GetTileIndex(agent.Index2D);
+        const MINT32 goalIndex = (nullptr != inDistanceList) ? Grid->GetTileIndex(agent.GoalIndex2D) : startIndex;
+
+        // 목표가 없다면 남은 거리 없이 현재 위치에서 대기하는 비용만 없앤다
+        auto GetDistance_H = [inDistanceList](MINT32 inIndex)
+        {
+            return (nullptr != inDistanceList) ? (*inDistanceList)[inIndex] : 0;
+        };
+
+        // 윈도우 안에 갈 수 있는 영역 (그리드 밖은 제외)
+        const MIntPoint regionMin(std::max(agent.Index2D.X - Window, 0), std::max(agent.Index2D.Y - Window, 0));
+        const MIntPoint regionMax(std::min(agent.Index2D.X + Window + 1, Grid->TileCount.X), std::min(agent.Index2D.Y + Window + 1, Grid->TileCount.Y));
+        const MINT32 regionWidth = regionMax.X - regionMin.X;
+        const MINT32 regionCount = regionWidth * (regionMax.Y - regionMin.Y);
+
+        // 노드 인덱스는 (시간 * 영역 타일 수 + 영역 안의 타일 인덱스), 같은 시간에서는 타일 인덱스(Y, X)와 순서가 같다
+        auto GetNodeIndex = [&regionMin, regionWidth, regionCount](MINT32 inStep, const MIntPoint& inIndex2D)
+        {
+            return (inStep * regionCount) + ((inIndex2D.Y - regionMin.Y) * regionWidth) + (inIndex2D.X - regionMin.X);
+        };
+
+        auto GetNodeIndex2D = [&regionMin, regionWidth, regionCount](MINT32 inNodeIndex)
+        {
+            const MINT32 regionIndex = inNodeIndex % regionCount;
+            return MIntPoint(regionMin.X + (regionIndex % regionWidth), regionMin.Y + (regionIndex / regionWidth));
+        };
+
+        NodeTable.BeginSearch(regionCount * (Window + 1));
+        OpenList.Reset(NodeTable.GetNodeData());
+
+        const MINT32 startNodeIndex = GetNodeIndex(0, agent.Index2D);
+        NodeTable.VisitNode(startNodeIndex, GetDistance_H(startIndex)).SetDistance_G(0);
+        OpenList.Push(startNodeIndex);
+
+        MINT32 endNodeIndex = -1;
+
+        while (MFALSE == OpenList.IsEmpty())
+        {
+            const MINT32 baseNodeIndex = OpenList.Pop();
+            const MINT32 baseStep = baseNodeIndex / regionCount;
+            const MIntPoint baseIndex2D = GetNodeIndex2D(baseNodeIndex);
+            const MINT32 baseIndex = Grid->GetTileIndex(baseIndex2D);
+
+            if (Window <= baseStep)
+            {
+                endNodeIndex = baseNodeIndex;
+                break;
+            }
+
+            NodeTable.SetClose(baseNodeIndex);
+            ++ExpandCount;
+
+            const MINT32 baseDistance_G = NodeTable.GetNode(baseNodeIndex).GetDistance_G();
+
+            // 0번은 제자리 대기, 이후는 상하좌우 이동
+            for (MINT32 i = 0; i <= 4; ++i)
+            {
+                const MIntPoint targetIndex2D = (0 == i) ? baseIndex2D : (baseIndex2D + GridDirectionList[i - 1]);
+                if (MFALSE == Grid->IsWalkable(targetIndex2D.X, targetIndex2D.Y)) {
+                    continue;
+                }
+
+                const MINT32 targetIndex = Grid->GetTileIndex(targetIndex2D);
+                const MINT32 targetNodeIndex = GetNodeIndex(baseStep + 1, targetIndex2D);
+
+                if (INFINITY_DISTANCE == GetDistance_H(targetIndex) || MTRUE == NodeTable.IsClose(targetNodeIndex)) {
+                    continue;
+                }
+
+                if (MFALSE == ReservationTable.IsMoveFree(baseIndex, targetIndex, time + baseStep, inAgent)) {
+                    continue;
+                }
+
+                const MINT32 moveCost = (baseIndex == targetIndex && targetIndex == goalIndex) ? 0 : 10;
+                const MINT32 distance_G = baseDistance_G + moveCost;
+
+                MNode& targetNode = NodeTable.VisitNode(targetNodeIndex, GetDistance_H(targetIndex));
+                if (targetNode.GetDistance_G() <= distance_G) {
+                    continue;
+                }
+
+                targetNode.SetDistance_G(distance_G);
+                targetNode.SetPrevIndex(baseNodeIndex);
+
+                if (MTRUE == OpenList.IsContain(targetNodeIndex)) {
+                    OpenList.Update(targetNodeIndex);
+                }
+                else {
+                    OpenList.Push(targetNodeIndex);
+                }
+            }
+        }
+
+        if (endNodeIndex < 0) {
+            return MFALSE;
+        }
+
+        // 시간 순서대로 타일 인덱스를 채운다
+        outPlanList.resize(Window + 1);
+        for (MINT32 nodeIndex = endNodeIndex; 0 <= nodeIndex; nodeIndex = NodeTable.GetNode(nodeIndex).GetPrevIndex()) {
+            outPlanList[nodeIndex / regionCount] = Grid->GetTileIndex(GetNodeIndex2D(nodeIndex));
+        }
+
+        return MTRUE;
+    }
+
+    void MCooperativePlanner::ReservePlan(MINT32 inAgent)
+    {
+        const MCooperativeAgent& agent = AgentList[inAgent];
+
+        const MINT32 count = static_cast<MINT32>(agent.PlanList.size());
+        for (MINT32 i = 0; i < count; ++i) {
+            ReservationTable.Reserve(agent.PlanList[i], agent.PlanTime + i, inAgent);
+        }
+
+        ReservationTable.Park(agent.PlanList.back(), agent.PlanTime + count - 1, inAgent);
+    }
+
+    void MCooperativePlanner::ReleasePlan(MINT32 inAgent)
+    {
+        const MCooperativeAgent& agent = AgentList[inAgent];
+
+        // 지나간 시간은 이미 지워졌다
+        const MINT32 count = static_cast<MINT32>(agent.PlanList.size());
+        for (MINT32 i = std::max(0, GetTime() - agent.PlanTime); i < count; ++i) {
+            ReservationTable.Release(agent.PlanList[i], agent.PlanTime + i, inAgent);
+        }
+
+        ReservationTable.Unpark(agent.PlanList.back(), inAgent);
+    }
+
+    const std::vector<MINT32>& MCooperativePlanner::AddGoalDistance(MINT32 inGoalIndex)
+    {
+        MGoalDistance& goalDistance = GoalDistanceMap[inGoalIndex];
+        if (0 < goalDistance.RefCount++) {
+            return goalDistance.DistanceList;
+        }
+
+        //----------------------------------------------------------------
+        // 목표 위치에서 너비 우선 탐색 (상하좌우 이동, 한칸 10)
+        //----------------------------------------------------------------
+        const MINT32 tileCount = Grid->TileCount.X * Grid->TileCount.Y;
+
+        std::vector<MINT32>& distanceList = goalDistance.DistanceList;
+        distanceList.assign(tileCount, INFINITY_DISTANCE);
+
+        std::vector<MINT32> queueList;
+        queueList.reserve(tileCount);
+
+        distanceList[inGoalIndex] = 0;
+        queueList.push_back(inGoalIndex);
+
+        for (size_t head = 0; head < queueList.size(); ++head)
+        {
+            const MINT32 index = queueList[head];
+            const MIntPoint index2D = Grid->GetTileIndex2D(index);
+
+            for (const MIntPoint& direction : GridDirectionList)
+            {
+                const MIntPoint nextIndex2D = index2D + direction;
+                if (MFALSE == Grid->IsWalkable(nextIndex2D.X, nextIndex2D.Y)) {
+                    continue;
+                }
+
+                const MINT32 nextIndex = Grid->GetTileIndex(nextIndex2D);
+                if (INFINITY_DISTANCE != distanceList[nextIndex]) {
+                    continue;
+                }
+
+                distanceList[nextIndex] = distanceList[index] + 10;
+                queueList.push_back(nextIndex);
+            }
+        }
+
+        return distanceList;
+    }
+
+    void MCooperativePlanner::RemoveGoalDistance(MINT32 inGoalIndex)
+    {
+        auto it = GoalDistanceMap.find(inGoalIndex);
+        if (GoalDistanceMap.end() != it && --it->second.RefCount <= 0) {
+            GoalDistanceMap.erase(it);
+        }
+    }
+};
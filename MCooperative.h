@@ -0,0 +1,251 @@
+﻿#pragma once
+
+#include <vector>
+#include <unordered_map>
+
+#include "MPrerequisites.h"
+#include "MType.h"
+#include "MAstar.h"
+
+
+namespace MAstar
+{
+    //----------------------------------------------------------------------
+    // 시간별 타일 예약 정보
+    // 현재 시간부터 (깊이 - 1) 이후까지의 시간만 저장하고 (시간 % 깊이)번째 칸을 돌려가며 사용한다
+    // 계획이 끝난 에이전트는 마지막 타일을 이후 시간에도 계속 차지한다 (다음 계획 전까지 머무는 위치)
+    //----------------------------------------------------------------------
+    class MReservationTable
+    {
+    public:
+        // 초기화 (inDepth : 저장할 시간 수)
+        void Reset(MINT32 inTileCount, MINT32 inDepth, MINT32 inTime = 0);
+
+        // 시간을 한칸 진행 (지나간 시간의 예약은 지워진다)
+        void Advance();
+
+        // 대상 시간에 타일을 예약하거나 차지한 에이전트 (없다면 -1)
+        MINT32 GetAgent(MINT32 inIndex, MINT32 inTime) const;
+
+        // 예약 / 해제 (다른 에이전트가 예약한 경우 실패)
+        MBOOL Reserve(MINT32 inIndex, MINT32 inTime, MINT32 inAgent);
+        void Release(MINT32 inIndex, MINT32 inTime, MINT32 inAgent);
+
+        // inTime 이후로 타일을 계속 차지 / 해제 (다른 에이전트가 차지했거나 이후 시간을 예약한 경우 실패)
+        MBOOL Park(MINT32 inIndex, MINT32 inTime, MINT32 inAgent);
+        void Unpark(MINT32 inIndex, MINT32 inAgent);
+
+        // 에이전트가 대상 시간에 타일에 있을 수 있는지
+        MBOOL IsFree(MINT32 inIndex, MINT32 inTime, MINT32 inAgent) const {
+            const MINT32 agent = GetAgent(inIndex, inTime);
+            return agent < 0 || agent == inAgent;
+        }
+
+        // inTime에 inFromIndex에서 inToIndex로 이동할 수 있는지 (도착 타일 예약 / 서로 자리를 바꾸는 이동 체크)
+        MBOOL IsMoveFree(MINT32 inFromIndex, MINT32 inToIndex, MINT32 inTime, MINT32 inAgent) const;
+
+        MINT32 GetTime() const {
+            return Time;
+        }
+
+        MINT32 GetDepth() const {
+            return Depth;
+        }
+
+    protected:
+        // 저장 범위의 시간인지
+        MBOOL IsInside(MINT32 inTime) const {
+            return Time <= inTime && inTime < Time + Depth;
+        }
+
+        MINT32 GetSlotIndex(MINT32 inIndex, MINT32 inTime) const {
+            return ((inTime % Depth) * TileCount) + inIndex;
+        }
+
+    protected:
+        MINT32 TileCount = 0;
+        MINT32 Depth = 0;
+
+        // 현재 시간
+        MINT32 Time = 0;
+
+        // 시간 칸별 타일 예약 에이전트 ((시간 % 깊이) * 타일 수 + 타일 인덱스)
+        std::vector<MINT32> AgentList;
+
+        // 타일별 계속 차지하는 에이전트 / 차지하기 시작한 시간
+        std::vector<MINT32> ParkAgentList;
+        std::vector<MINT32> ParkTimeList;
+    };
+
+
+    //----------------------------------------------------------------------
+    // 협동 경로 검색 에이전트
+    //----------------------------------------------------------------------
+    struct MCooperativeAgent
+    {
+    public:
+        // 현재 / 목표 위치
+        MIntPoint Index2D;
+        MIntPoint GoalIndex2D;
+
+        // 계획한 경로 (PlanTime부터 시간별 타일 인덱스)
+        std::vector<MINT32> PlanList;
+        MINT32 PlanTime = 0;
+
+        // 다음 재계획 시간
+        MINT32 ReplanTime = 0;
+    };
+
+
+    //----------------------------------------------------------------------
+    // 협동 경로 검색 (Windowed Hierarchical Cooperative A*)
+    // 시간 축을 추가해서 다른 에이전트가 예약한 타일 / 시간을 피해서 이동 계획을 세운다
+    // 계획은 윈도우 크기만큼의 시간만 세우고 이후는 목표까지의 실제 거리로 대신한다
+    // 계획의 마지막 타일은 다음 계획 전까지 계속 차지하므로 다시 계획할때 이전 계획을 항상 따를 수 있다
+    // 예약이 어긋나서 (예약된 타일에 추가한 에이전트 등) 제자리에서 대기하는 경우 그 타일을 예약한 다른 에이전트를 다시 계획한다
+    // 목표 위치에 도착한 에이전트도 그 자리를 차지하므로 새 목표를 주지 않으면 통로를 막을 수 있다
+    // 재계획은 간격마다 하고 한 틱에 처리할 수를 제한해서 여러 틱에 나눠 처리한다
+    // 상하좌우 이동 / 제자리 대기만 사용하고 검색중에는 그리드를 변경하면 안된다
+    //----------------------------------------------------------------------
+    class MCooperativePlanner
+    {
+    public:
+        // 윈도우 크기 / 재계획 간격 (Reset 전에 설정, 간격은 윈도우 크기 이하)
+        void SetWindow(MINT32 inWindow, MINT32 inReplanInterval);
+
+        // 한 틱에 재계획할 최대 에이전트 수 (계획이 끝나가는 에이전트는 제한과 상관없이 재계획)
+        void SetReplanBudget(MINT32 inBudget) {
+            ReplanBudget = std::max(inBudget, 1);
+        }
+
+        // 그리드 설정 (등록된 에이전트 / 통계 초기화)
+        void Reset(const MGrid* inGrid);
+
+        // 에이전트 추가 (에이전트 번호를 리턴, 시작 위치에서 대기하다 다음 틱에 재계획)
+        // 시작 / 목표 위치가 그리드 밖이라면 추가하지 않고 -1
+        MINT32 AddAgent(const MIntPoint& inStartIndex2D, const MIntPoint& inGoalIndex2D);
+
+        // 목표 위치 변경 (다음 틱에 재계획, 에이전트 번호 / 목표 위치가 잘못되었다면 MFALSE)
+        MBOOL SetGoal(MINT32 inAgent, const MIntPoint& inGoalIndex2D);
+
+        // 한 틱 진행 (재계획 후 모든 에이전트가 한칸씩 이동)
+        void Update();
+
+        const MCooperativeAgent& GetAgent(MINT32 inAgent) const {
+            return AgentList[inAgent];
+        }
+
+        MINT32 GetAgentCount() const {
+            return static_cast<MINT32>(AgentList.size());
+        }
+
+        // 목표 위치에 있는지
+        MBOOL IsArrived(MINT32 inAgent) const {
+            return AgentList[inAgent].Index2D == AgentList[inAgent].GoalIndex2D;
+        }
+
+        MINT32 GetTime() const {
+            return ReservationTable.GetTime();
+        }
+
+        //--------------------------------------------------------------
+        // 통계
+        //--------------------------------------------------------------
+        // 재계획 수 / 경로를 찾지 못해서 대기한 수
+        MINT32 GetReplanCount() const {
+            return ReplanCount;
+        }
+
+        MINT32 GetFailedPlanCount() const {
+            return FailedPlanCount;
+        }
+
+        // 목표 위치에 도착한 수
+        MINT32 GetArriveCount() const {
+            return ArriveCount;
+        }
+
+        // 이동한 칸 수
+        MINT32 GetMoveCount() const {
+            return MoveCount;
+        }
+
+        // 같은 타일에 두 에이전트가 있거나 서로 자리를 바꾼 수 (예약을 지키지 못한 경우)
+        MINT32 GetConflictCount() const {
+            return ConflictCount;
+        }
+
+        // 검색에서 확장한 노드 수
+        MUINT64 GetExpandCount() const {
+            return ExpandCount;
+        }
+
+    protected:
+        // 현재 위치에서 윈도우 크기만큼 계획을 다시 세운다 (대기와 겹쳐서 계획을 해제한 에이전트 포함)
+        void Replan(MINT32 inAgent);
+        void PlanWindow(MINT32 inAgent);
+
+        // 제자리에서 대기하는 계획과 겹치는 다른 에이전트의 계획을 해제하고 ClashList에 추가 / ClashList 재계획
+        void ReleaseClashPlan(MINT32 inAgent);
+        void ReplanClashList();
+
+        // 시간 축 A* (찾지 못했다면 MFALSE)
+        // inDistanceList가 없다면 목표 없이 현재 위치에 머무르는 계획을 찾는다
+        MBOOL SearchWindow(MINT32 inAgent, const std::vector<MINT32>* inDistanceList, std::vector<MINT32>& outPlanList);
+
+        // 계획한 경로 예약 / 현재 시간 이후 예약 해제 (마지막 타일 차지 포함)
+        void ReservePlan(MINT32 inAgent);
+        void ReleasePlan(MINT32 inAgent);
+
+        // 목표 위치까지의 실제 거리 (같은 목표는 공유, 사용하는 에이전트가 없으면 제거)
+        const std::vector<MINT32>& AddGoalDistance(MINT32 inGoalIndex);
+        void RemoveGoalDistance(MINT32 inGoalIndex);
+
+    protected:
+        // 목표 위치별 실제 거리
+        struct MGoalDistance
+        {
+        public:
+            std::vector<MINT32> DistanceList;
+            MINT32 RefCount = 0;
+        };
+
+        // 대상 그리드
+        const MGrid* Grid = nullptr;
+
+        // 윈도우 크기 / 재계획 간격
+        MINT32 Window = 16;
+        MINT32 ReplanInterval = 8;
+
+        // 한 틱에 재계획할 최대 에이전트 수
+        MINT32 ReplanBudget = 32;
+
+        // 시간별 예약 정보
+        MReservationTable ReservationTable;
+
+        // 에이전트
+        std::vector<MCooperativeAgent> AgentList;
+
+        // 목표 위치별 실제 거리
+        std::unordered_map<MINT32, MGoalDistance> GoalDistanceMap;
+
+        // 시간 축 검색 노드 저장소 / 열린 리스트 (윈도우 시간 * 영역 타일 수 + 영역 안의 타일 인덱스)
+        // 영역은 시작 위치에서 윈도우 크기 이내라서 그리드 크기와 상관없이 ((2 * 윈도우 크기 + 1)^2 * (윈도우 크기 + 1)) 이하
+        MNodeTable NodeTable;
+        MOpenList OpenList;
+
+        // 재계획 대상 / 대기와 겹쳐서 계획을 해제한 에이전트 / 충돌 체크용 임시 정보
+        std::vector<MINT32> ReplanList;
+        std::vector<MINT32> ClashList;
+        std::vector<MINT32> PrevIndexList;
+        std::vector<MINT32> TileAgentList;
+
+        // 통계
+        MINT32 ReplanCount = 0;
+        MINT32 FailedPlanCount = 0;
+        MINT32 ArriveCount = 0;
+        MINT32 MoveCount = 0;
+        MINT32 ConflictCount = 0;
+        MUINT64 ExpandCount = 0;
+    };
+};
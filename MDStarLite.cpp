@@ -0,0 +1,357 @@
+﻿#include "MDStarLite.h"
+
+
+namespace MAstar
+{
+    MBOOL MDStarLitePlanner::Initialize(const MGrid* inGrid, const MIntPoint& inStartIndex2D, const MIntPoint& inEndIndex2D)
+    {
+        Grid = inGrid;
+
+        HeapList.clear();
+        KeyModifier = 0;
+        StartIndex = -1;
+        EndIndex = -1;
+        LastStartIndex = -1;
+
+        if (nullptr == Grid->GetTile(inStartIndex2D) || nullptr == Grid->GetTile(inEndIndex2D)) {
+            return MFALSE;
+        }
+
+        StartIndex = Grid->GetTileIndex(inStartIndex2D);
+        EndIndex = Grid->GetTileIndex(inEndIndex2D);
+        LastStartIndex = StartIndex;
+
+        const MINT32 tileCount = Grid->TileCount.X * Grid->TileCount.Y;
+        DistanceList_G.assign(tileCount, INFINITY_DISTANCE);
+        DistanceList_RHS.assign(tileCount, INFINITY_DISTANCE);
+        KeyList.assign(tileCount, MDStarKey());
+        HeapIndexList.assign(tileCount, -1);
+
+        // 종료 위치에서 검색 시작
+        DistanceList_RHS[EndIndex] = 0;
+        HeapPush(EndIndex, CalculateKey(EndIndex));
+
+        return MTRUE;
+    }
+
+    void MDStarLitePlanner::SetStart(const MIntPoint& inStartIndex2D)
+    {
+        if (nullptr == Grid || nullptr == Grid->GetTile(inStartIndex2D)) {
+            return;
+        }
+
+        StartIndex = Grid->GetTileIndex(inStartIndex2D);
+
+        // 이동한 거리만큼 기존 키를 보정
+        KeyModifier += GetDistance_H(LastStartIndex);
+        LastStartIndex = StartIndex;
+    }
+
+    void MDStarLitePlanner::UpdateTiles(const std::vector<MIntPoint>& inChangedList)
+    {
+        if (nullptr == Grid || EndIndex < 0) {
+            return;
+        }
+
+        MINT32 aroundIndexList[4];
+
+        // 바뀐 타일로 들어가는 비용이 바뀌므로 주변 타일을 갱신
+        for (const MIntPoint& index2D : inChangedList)
+        {
+            if (nullptr == Grid->GetTile(index2D)) {
+                continue;
+            }
+
+            const MINT32 aroundCount = GetAroundIndex(Grid->GetTileIndex(index2D), aroundIndexList);
+            for (MINT32 i = 0; i < aroundCount; ++i) {
+                UpdateVertex(aroundIndexList[i]);
+            }
+        }
+    }
+
+    void MDStarLitePlanner::FindPath(std::vector<MIntPoint>& inList)
+    {
+        inList.clear();
+        LastExpandCount = 0;
+
+        if (nullptr == Grid || StartIndex < 0) {
+            return;
+        }
+
+        ComputeShortestPath();
+
+        if (INFINITY_DISTANCE <= DistanceList_G[StartIndex]) {
+            return;
+        }
+
+        // 거리가 가장 가까운 타일을 따라간다
+        // 거리 정보가 맞지 않으면 같은 타일을 돌 수 있으므로 전체 타일 수까지만 따라간다
+        MINT32 aroundIndexList[4];
+        MINT32 currentIndex = StartIndex;
+        inList.push_back(Grid->GetTileIndex2D(currentIndex));
+
+        const MINT32 maxStepCount = Grid->TileCount.X * Grid->TileCount.Y;
+
+        while (currentIndex != EndIndex)
+        {
+            if (maxStepCount <= static_cast<MINT32>(inList.size()))
+            {
+                // 정상적인 상황이라면 오지 않는다
+                inList.clear();
+                return;
+            }
+
+            MINT32 nextIndex = -1;
+            MINT32 minDistance = INFINITY_DISTANCE;
+
+            const MINT32 aroundCount = GetAroundIndex(currentIndex, aroundIndexList);
+            for (MINT32 i = 0; i < aroundCount; ++i)
+            {
+                const MINT32 targetIndex = aroundIndexList[i];
+                const MINT32 distance = GetMoveCost(targetIndex) + DistanceList_G[targetIndex];
+
+                if (distance < minDistance)
+                {
+                    minDistance = distance;
+                    nextIndex = targetIndex;
+                }
+            }
+
+            if (nextIndex < 0)
+            {
+                // 정상적인 상황이라면 오지 않는다
+                inList.clear();
+                return;
+            }
+
+            currentIndex = nextIndex;
+            inList.push_back(Grid->GetTileIndex2D(currentIndex));
+        }
+    }
+
+    void MDStarLitePlanner::ComputeShortestPath()
+    {
+        MINT32 aroundIndexList[4];
+
+        while (MFALSE == HeapList.empty())
+        {
+            const MINT32 topIndex = HeapList.front();
+            const MDStarKey oldKey = KeyList[topIndex];
+
+            // 시작 위치가 확정되었다면 종료
+            if (MFALSE == (oldKey < CalculateKey(StartIndex)) && DistanceList_RHS[StartIndex] == DistanceList_G[StartIndex]) {
+                break;
+            }
+
+            ++LastExpandCount;
+
+            const MDStarKey newKey = CalculateKey(topIndex);
+            if (oldKey < newKey)
+            {
+                // 키가 오래된 경우 다시 넣는다
+                HeapRemove(topIndex);
+                HeapPush(topIndex, newKey);
+                continue;
+            }
+
+            HeapRemove(topIndex);
+
+            const MINT32 aroundCount = GetAroundIndex(topIndex, aroundIndexList);
+            if (DistanceList_RHS[topIndex] < DistanceList_G[topIndex])
+            {
+                // 거리가 줄어든 경우
+                DistanceList_G[topIndex] = DistanceList_RHS[topIndex];
+            }
+            else
+            {
+                // 거리가 늘어난 경우 자신도 다시 계산
+                DistanceList_G[topIndex] = INFINITY_DISTANCE;
+                UpdateVertex(topIndex);
+            }
+
+            for (MINT32 i = 0; i < aroundCount; ++i) {
+                UpdateVertex(aroundIndexList[i]);
+            }
+        }
+    }
+
+    void MDStarLitePlanner::UpdateVertex(MINT32 inIndex)
+    {
+        if (inIndex != EndIndex)
+        {
+            // 주변 타일을 거쳐서 가는 거리중 가장 가까운 거리
+            MINT32 aroundIndexList[4];
+            MINT32 minDistance = INFINITY_DISTANCE;
+
+            const MINT32 aroundCount = GetAroundIndex(inIndex, aroundIndexList);
+            for (MINT32 i = 0; i < aroundCount; ++i)
+            {
+                const MINT32 targetIndex = aroundIndexList[i];
+                minDistance = std::min(minDistance, GetMoveCost(targetIndex) + DistanceList_G[targetIndex]);
+            }
+
+            DistanceList_RHS[inIndex] = std::min(minDistance, INFINITY_DISTANCE);
+        }
+
+        if (0 <= HeapIndexList[inIndex]) {
+            HeapRemove(inIndex);
+        }
+
+        if (DistanceList_G[inIndex] != DistanceList_RHS[inIndex]) {
+            HeapPush(inIndex, CalculateKey(inIndex));
+        }
+    }
+
+    MDStarKey MDStarLitePlanner::CalculateKey(MINT32 inIndex) const
+    {
+        const MINT32 distance = std::min(DistanceList_G[inIndex], DistanceList_RHS[inIndex]);
+
+        MDStarKey key;
+        if (INFINITY_DISTANCE <= distance)
+        {
+            key.Key1 = INFINITY_DISTANCE;
+            key.Key2 = INFINITY_DISTANCE;
+        }
+        else
+        {
+            key.Key1 = distance + GetDistance_H(inIndex) + KeyModifier;
+            key.Key2 = distance;
+        }
+
+        return key;
+    }
+
+    MINT32 MDStarLitePlanner::GetDistance_H(MINT32 inIndex) const
+    {
+        const MIntPoint index2D = Grid->GetTileIndex2D(inIndex);
+        const MIntPoint startIndex2D = Grid->GetTileIndex2D(StartIndex);
+
+        return (abs(startIndex2D.X - index2D.X) + abs(startIndex2D.Y - index2D.Y)) * 10;
+    }
+
+    MINT32 MDStarLitePlanner::GetMoveCost(MINT32 inToIndex) const
+    {
+        // 막힌 타일로는 들어갈 수 없다
+        if (MTRUE == Grid->TileList[inToIndex].IsBlocked) {
+            return INFINITY_DISTANCE;
+        }
+        return 10;
+    }
+
+    MINT32 MDStarLitePlanner::GetAroundIndex(MINT32 inIndex, MINT32* outIndexList) const
+    {
+        const MIntPoint index2D = Grid->GetTileIndex2D(inIndex);
+        MINT32 count = 0;
+
+        if (0 < index2D.X) {
+            outIndexList[count++] = inIndex - 1;
+        }
+        if (index2D.X + 1 < Grid->TileCount.X) {
+            outIndexList[count++] = inIndex + 1;
+        }
+        if (0 < index2D.Y) {
+            outIndexList[count++] = inIndex - Grid->TileCount.X;
+        }
+        if (index2D.Y + 1 < Grid->TileCount.Y) {
+            outIndexList[count++] = inIndex + Grid->TileCount.X;
+        }
+
+        return count;
+    }
+
+    //---------------------------------------------------------------------------
+    // 열린 리스트
+    //---------------------------------------------------------------------------
+    void MDStarLitePlanner::HeapPush(MINT32 inIndex, const MDStarKey& inKey)
+    {
+        KeyList[inIndex] = inKey;
+
+        HeapList.push_back(inIndex);
+        const MINT32 heapIndex = static_cast<MINT32>(HeapList.size()) - 1;
+        HeapIndexList[inIndex] = heapIndex;
+
+        HeapSiftUp(heapIndex);
+    }
+
+    void MDStarLitePlanner::HeapRemove(MINT32 inIndex)
+    {
+        const MINT32 heapIndex = HeapIndexList[inIndex];
+        HeapIndexList[inIndex] = -1;
+
+        // 마지막 노드를 빈자리로 옮긴다
+        const MINT32 lastIndex = HeapList.back();
+        HeapList.pop_back();
+
+        if (lastIndex == inIndex) {
+            return;
+        }
+
+        HeapSetAt(heapIndex, lastIndex);
+        HeapSiftUp(heapIndex);
+        HeapSiftDown(HeapIndexList[lastIndex]);
+    }
+
+    void MDStarLitePlanner::HeapSiftUp(MINT32 inHeapIndex)
+    {
+        const MINT32 index = HeapList[inHeapIndex];
+
+        while (0 < inHeapIndex)
+        {
+            const MINT32 parentHeapIndex = (inHeapIndex - 1) / 2;
+            const MINT32 parentIndex = HeapList[parentHeapIndex];
+
+            if (MFALSE == IsHigherPriority(index, parentIndex)) {
+                break;
+            }
+
+            HeapSetAt(inHeapIndex, parentIndex);
+            inHeapIndex = parentHeapIndex;
+        }
+
+        HeapSetAt(inHeapIndex, index);
+    }
+
+    void MDStarLitePlanner::HeapSiftDown(MINT32 inHeapIndex)
+    {
+        const MINT32 count = static_cast<MINT32>(HeapList.size());
+        const MINT32 index = HeapList[inHeapIndex];
+
+        while (MTRUE)
+        {
+            MINT32 childHeapIndex = (inHeapIndex * 2) + 1;
+            if (count <= childHeapIndex) {
+                break;
+            }
+
+            const MINT32 rightHeapIndex = childHeapIndex + 1;
+            if (rightHeapIndex < count && MTRUE == IsHigherPriority(HeapList[rightHeapIndex], HeapList[childHeapIndex])) {
+                childHeapIndex = rightHeapIndex;
+            }
+
+            if (MFALSE == IsHigherPriority(HeapList[childHeapIndex], index)) {
+                break;
+            }
+
+            HeapSetAt(inHeapIndex, HeapList[childHeapIndex]);
+            inHeapIndex = childHeapIndex;
+        }
+
+        HeapSetAt(inHeapIndex, index);
+    }
+
+    MBOOL MDStarLitePlanner::IsHigherPriority(MINT32 inLeft, MINT32 inRight) const
+    {
+        const MDStarKey& leftKey = KeyList[inLeft];
+        const MDStarKey& rightKey = KeyList[inRight];
+
+        if (leftKey < rightKey) {
+            return MTRUE;
+        }
+        if (rightKey < leftKey) {
+            return MFALSE;
+        }
+
+        // 키가 같다면 타일 인덱스 순서
+        return inLeft < inRight;
+    }
+};
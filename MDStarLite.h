@@ -0,0 +1,108 @@
+﻿#pragma once
+
+#include <vector>
+
+#include "MPrerequisites.h"
+#include "MType.h"
+#include "MAstar.h"
+
+
+namespace MAstar
+{
+    //----------------------------------------------------------------------
+    // D* Lite 검색 키
+    //----------------------------------------------------------------------
+    struct MDStarKey
+    {
+    public:
+        MINT32 Key1 = 0;
+        MINT32 Key2 = 0;
+
+        MBOOL operator<(const MDStarKey& inOther) const {
+            return (Key1 != inOther.Key1) ? (Key1 < inOther.Key1) : (Key2 < inOther.Key2);
+        }
+    };
+
+
+    //----------------------------------------------------------------------
+    // 타일 변경시 바뀐 부분만 다시 계산하는 경로 검색 (D* Lite)
+    // 종료 위치에서 시작 위치 방향으로 검색한 정보를 계속 유지하므로
+    // 목표가 같은 동안 하나의 에이전트가 계속 사용한다
+    //----------------------------------------------------------------------
+    class MDStarLitePlanner
+    {
+    public:
+        // 그리드 / 시작 / 종료 위치 설정 (이전 검색 정보는 모두 제거)
+        MBOOL Initialize(const MGrid* inGrid, const MIntPoint& inStartIndex2D, const MIntPoint& inEndIndex2D);
+
+        // 에이전트가 이동한 경우 시작 위치 변경
+        void SetStart(const MIntPoint& inStartIndex2D);
+
+        // 막힘 정보가 바뀐 타일 목록 (그리드는 이미 변경된 상태여야 한다)
+        void UpdateTiles(const std::vector<MIntPoint>& inChangedList);
+
+        // 바뀐 부분을 다시 계산하고 현재 시작 위치에서의 경로를 얻는다 (찾지 못했다면 빈 리스트)
+        void FindPath(std::vector<MIntPoint>& inList);
+
+        // 마지막 FindPath에서 확장한 노드 수
+        MINT32 GetLastExpandCount() const {
+            return LastExpandCount;
+        }
+
+    protected:
+        // 경로 재계산
+        void ComputeShortestPath();
+
+        // 노드 정보 갱신
+        void UpdateVertex(MINT32 inIndex);
+
+        // 키 계산
+        MDStarKey CalculateKey(MINT32 inIndex) const;
+
+        // 시작 위치까지의 추정 거리
+        MINT32 GetDistance_H(MINT32 inIndex) const;
+
+        // 대상 타일로 들어가는 비용
+        MINT32 GetMoveCost(MINT32 inToIndex) const;
+
+        // 주변 타일 목록을 얻는다 (개수 리턴)
+        MINT32 GetAroundIndex(MINT32 inIndex, MINT32* outIndexList) const;
+
+        //--------------------------------------------------------------
+        // 열린 리스트 (인덱스 바이너리 힙)
+        //--------------------------------------------------------------
+        void HeapPush(MINT32 inIndex, const MDStarKey& inKey);
+        void HeapRemove(MINT32 inIndex);
+        void HeapSiftUp(MINT32 inHeapIndex);
+        void HeapSiftDown(MINT32 inHeapIndex);
+        MBOOL IsHigherPriority(MINT32 inLeft, MINT32 inRight) const;
+
+        void HeapSetAt(MINT32 inHeapIndex, MINT32 inIndex) {
+            HeapList[inHeapIndex] = inIndex;
+            HeapIndexList[inIndex] = inHeapIndex;
+        }
+
+    protected:
+        // 대상 그리드
+        const MGrid* Grid = nullptr;
+
+        // 현재 시작 / 종료 타일 인덱스
+        MINT32 StartIndex = -1;
+        MINT32 EndIndex = -1;
+
+        // 시작 위치가 바뀔때 누적되는 키 보정값
+        MINT32 KeyModifier = 0;
+        MINT32 LastStartIndex = -1;
+
+        // 타일별 거리 정보
+        std::vector<MINT32> DistanceList_G;
+        std::vector<MINT32> DistanceList_RHS;
+
+        // 열린 리스트
+        std::vector<MDStarKey> KeyList;
+        std::vector<MINT32> HeapIndexList;
+        std::vector<MINT32> HeapList;
+
+        MINT32 LastExpandCount = 0;
+    };
+};
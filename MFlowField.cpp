@@ -0,0 +1,184 @@
+﻿#include "MFlowField.h"
+#include "MGridCommon.h"
+
+#include <thread>
+
+
+namespace MAstar
+{
+    const MUINT8 MFlowField::DirectionNone;
+
+    void MFlowField::Build(const MGrid* inGrid, const MIntPoint& inGoalIndex2D)
+    {
+        Build(inGrid, std::vector<MIntPoint>(1, inGoalIndex2D));
+    }
+
+    void MFlowField::Build(const MGrid* inGrid, const std::vector<MIntPoint>& inGoalList)
+    {
+        Grid = inGrid;
+
+        // 거리 전파
+        BuildDistance(inGoalList);
+
+        // 방향은 행마다 독립적이므로 행 단위로 나눠서 처리
+        const MINT32 rowCount = Grid->TileCount.Y;
+        const MINT32 threadCount = std::max(1, std::min(ThreadCount, rowCount / MinRowCountPerThread));
+
+        if (1 == threadCount)
+        {
+            BuildDirection(0, rowCount);
+            return;
+        }
+
+        std::vector<std::thread> threadList;
+        for (MINT32 i = 1; i < threadCount; ++i) {
+            threadList.emplace_back(&MFlowField::BuildDirection, this, (rowCount * i) / threadCount, (rowCount * (i + 1)) / threadCount);
+        }
+
+        BuildDirection(0, rowCount / threadCount);
+
+        for (std::thread& thread : threadList) {
+            thread.join();
+        }
+    }
+
+    MINT32 MFlowField::GetDistance(const MIntPoint& inIndex2D) const
+    {
+        if (nullptr == Grid || nullptr == Grid->GetTile(inIndex2D)) {
+            return INFINITY_DISTANCE;
+        }
+
+        return DistanceList[Grid->GetTileIndex(inIndex2D)];
+    }
+
+    MBOOL MFlowField::GetNextIndex2D(const MIntPoint& inIndex2D, MIntPoint& outIndex2D) const
+    {
+        if (nullptr == Grid || nullptr == Grid->GetTile(inIndex2D)) {
+            return MFALSE;
+        }
+
+        const MUINT8 direction = DirectionList[Grid->GetTileIndex(inIndex2D)];
+        if (DirectionNone == direction) {
+            return MFALSE;
+        }
+
+        outIndex2D = inIndex2D + GridDirectionList[direction];
+        return MTRUE;
+    }
+
+    void MFlowField::BuildDistance(const std::vector<MIntPoint>& inGoalList)
+    {
+        const MINT32 countX = Grid->TileCount.X;
+        const MINT32 countY = Grid->TileCount.Y;
+
+        DistanceList.assign(countX * countY, INFINITY_DISTANCE);
+        DirectionList.assign(countX * countY, DirectionNone);
+
+        QueueList.clear();
+        QueueList.reserve(countX * countY);
+
+        // 목표 지점부터 시작
+        for (const MIntPoint& goalIndex2D : inGoalList)
+        {
+            if (MFALSE == Grid->IsWalkable(goalIndex2D.X, goalIndex2D.Y)) {
+                continue;
+            }
+
+            const MINT32 goalIndex = Grid->GetTileIndex(goalIndex2D);
+            if (0 == DistanceList[goalIndex]) {
+                continue;
+            }
+
+            DistanceList[goalIndex] = 0;
+            QueueList.push_back(goalIndex);
+        }
+
+        // 균일 비용이므로 너비 우선으로 전파하면 처음 도달한 거리가 최단 거리
+        const MTile* tileList = Grid->TileList.data();
+        MINT32* distanceList = DistanceList.data();
+
+        for (size_t i = 0; i < QueueList.size(); ++i)
+        {
+            const MINT32 index = QueueList[i];
+            const MINT32 x = index % countX;
+            const MINT32 y = index / countX;
+            const MINT32 nextDistance = distanceList[index] + 10;
+
+            auto VisitFunc = [this, tileList, distanceList, nextDistance](MINT32 inTargetIndex)
+            {
+                if (INFINITY_DISTANCE != distanceList[inTargetIndex] || MTRUE == tileList[inTargetIndex].IsBlocked) {
+                    return;
+                }
+
+                distanceList[inTargetIndex] = nextDistance;
+                QueueList.push_back(inTargetIndex);
+            };
+
+            if (x + 1 < countX) {
+                VisitFunc(index + 1);
+            }
+            if (0 < x) {
+                VisitFunc(index - 1);
+            }
+            if (y + 1 < countY) {
+                VisitFunc(index + countX);
+            }
+            if (0 < y) {
+                VisitFunc(index - countX);
+            }
+        }
+    }
+
+    void MFlowField::BuildDirection(MINT32 inBeginY, MINT32 inEndY)
+    {
+        const MINT32 countX = Grid->TileCount.X;
+        const MINT32 countY = Grid->TileCount.Y;
+
+        const MINT32* distanceList = DistanceList.data();
+        MUINT8* directionList = DirectionList.data();
+
+        for (MINT32 y = inBeginY; y < inEndY; ++y)
+        {
+            const MINT32 rowIndex = y * countX;
+
+            for (MINT32 x = 0; x < countX; ++x)
+            {
+                const MINT32 index = rowIndex + x;
+                const MINT32 distance = distanceList[index];
+
+                // 목표 지점
+                // (막힌 타일은 거리가 없지만 빠져나올 수 있도록 방향은 계산한다)
+                if (0 == distance) {
+                    continue;
+                }
+
+                // 주변에서 거리가 가장 짧은 타일 방향
+                MINT32 minDistance = distance;
+                MUINT8 direction = DirectionNone;
+
+                if (x + 1 < countX && distanceList[index + 1] < minDistance)
+                {
+                    minDistance = distanceList[index + 1];
+                    direction = 0;
+                }
+                if (0 < x && distanceList[index - 1] < minDistance)
+                {
+                    minDistance = distanceList[index - 1];
+                    direction = 1;
+                }
+                if (y + 1 < countY && distanceList[index + countX] < minDistance)
+                {
+                    minDistance = distanceList[index + countX];
+                    direction = 2;
+                }
+                if (0 < y && distanceList[index - countX] < minDistance)
+                {
+                    minDistance = distanceList[index - countX];
+                    direction = 3;
+                }
+
+                directionList[index] = direction;
+            }
+        }
+    }
+};
@@ -0,0 +1,73 @@
+﻿#pragma once
+
+#include <vector>
+
+#include "MPrerequisites.h"
+#include "MType.h"
+#include "MAstar.h"
+
+
+namespace MAstar
+{
+    //----------------------------------------------------------------------
+    // 목표 지점까지의 거리 / 이동 방향을 모든 타일에 대해 미리 계산
+    // 같은 목표로 이동하는 에이전트들은 다음 타일을 바로 얻을 수 있다
+    // 거리 전파(너비 우선 탐색)는 호출 스레드에서만 처리하고 방향 계산만 행 단위로 나눠서 스레드로 처리한다
+    // 거리 전파가 대부분의 시간을 차지하므로 스레드 수를 늘려도 전체 시간은 크게 줄지 않는다
+    //----------------------------------------------------------------------
+    class MFlowField
+    {
+    public:
+        // 이동 방향이 없는 타일 (목표 지점이거나 도달할 수 없는 타일)
+        static const MUINT8 DirectionNone = 0xFF;
+
+    public:
+        // 목표 지점으로 필드를 만든다
+        void Build(const MGrid* inGrid, const MIntPoint& inGoalIndex2D);
+
+        // 여러 목표 지점중 가장 가까운 곳으로 이동하는 필드를 만든다
+        void Build(const MGrid* inGrid, const std::vector<MIntPoint>& inGoalList);
+
+        // 방향 계산에 사용할 스레드 수 (1이라면 호출 스레드에서만 처리, 거리 전파는 항상 호출 스레드에서 처리)
+        void SetThreadCount(MINT32 inCount) {
+            ThreadCount = std::max(inCount, 1);
+        }
+
+        // 목표까지 거리 (도달할 수 없다면 INFINITY_DISTANCE)
+        MINT32 GetDistance(const MIntPoint& inIndex2D) const;
+
+        // 다음에 이동할 타일을 얻는다 (이동할 수 없다면 MFALSE)
+        MBOOL GetNextIndex2D(const MIntPoint& inIndex2D, MIntPoint& outIndex2D) const;
+
+        // 타일별 거리 / 방향 정보
+        const std::vector<MINT32>& GetDistanceList() const {
+            return DistanceList;
+        }
+
+        const std::vector<MUINT8>& GetDirectionList() const {
+            return DirectionList;
+        }
+
+    protected:
+        // 목표 지점에서 거리 전파
+        void BuildDistance(const std::vector<MIntPoint>& inGoalList);
+
+        // 행 범위의 방향 계산
+        void BuildDirection(MINT32 inBeginY, MINT32 inEndY);
+
+    protected:
+        // 대상 그리드
+        const MGrid* Grid = nullptr;
+
+        // 타일별 목표까지 거리
+        std::vector<MINT32> DistanceList;
+
+        // 타일별 이동 방향
+        std::vector<MUINT8> DirectionList;
+
+        // 거리 전파에 사용하는 큐
+        std::vector<MINT32> QueueList;
+
+        MINT32 ThreadCount = 1;
+    };
+};
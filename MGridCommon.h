@@ -0,0 +1,18 @@
+﻿#pragma once
+
+#include "MPrerequisites.h"
+#include "MType.h"
+
+
+namespace MAstar
+{
+    //----------------------------------------------------------------------
+    // 그리드 모듈 (흐름장 / 연결 영역 / 랜드마크 / 협동 경로 / 계층 검색) 공용 정보
+    //----------------------------------------------------------------------
+    // 상하좌우 방향별 이동량 (오른쪽, 왼쪽, 아래, 위)
+    // MFlowField의 타일별 이동 방향은 이 목록의 인덱스로 저장하므로 순서를 바꾸면 안된다
+    const MIntPoint GridDirectionList[4] = { MIntPoint(1, 0), MIntPoint(-1, 0), MIntPoint(0, 1), MIntPoint(0, -1) };
+
+    // 행 단위로 나눠서 스레드로 처리할때 한 스레드가 처리할 최소 행 수
+    const MINT32 MinRowCountPerThread = 64;
+};
@@ -0,0 +1,678 @@
+﻿#include "MHierarchy.h"
+#include "MGridCommon.h"
+
+
+namespace MAstar
+{
+    //---------------------------------------------------------------------------
+    // ClusterSearch
+    //---------------------------------------------------------------------------
+    void MClusterSearch::Search(const MGrid* inGrid, const MIntPoint& inMin, const MIntSize& inSize, const MIntPoint& inStartIndex2D, const MIntPoint* inStopIndex2D)
+    {
+        Min = inMin;
+        Size = inSize;
+
+        const MINT32 count = Size.X * Size.Y;
+        DistanceList.assign(count, INFINITY_DISTANCE);
+        PrevList.assign(count, -1);
+        QueueList.clear();
+
+        if (MFALSE == IsInside(inStartIndex2D)) {
+            return;
+        }
+
+        // 시작 타일은 막혀있어도 출발은 가능
+        const MINT32 startLocalIndex = GetLocalIndex(inStartIndex2D);
+        DistanceList[startLocalIndex] = 0;
+        QueueList.push_back(startLocalIndex);
+
+        const MINT32 stopLocalIndex = (nullptr != inStopIndex2D && MTRUE == IsInside(*inStopIndex2D)) ? GetLocalIndex(*inStopIndex2D) : -1;
+
+        for (size_t i = 0; i < QueueList.size(); ++i)
+        {
+            const MINT32 localIndex = QueueList[i];
+            if (localIndex == stopLocalIndex) {
+                break;
+            }
+
+            const MIntPoint index2D(Min.X + (localIndex % Size.X), Min.Y + (localIndex / Size.X));
+            const MINT32 nextDistance = DistanceList[localIndex] + 10;
+
+            for (const MIntPoint& direction : GridDirectionList)
+            {
+                const MIntPoint targetIndex2D = index2D + direction;
+                if (MFALSE == IsInside(targetIndex2D)) {
+                    continue;
+                }
+
+                const MINT32 targetLocalIndex = GetLocalIndex(targetIndex2D);
+                if (INFINITY_DISTANCE != DistanceList[targetLocalIndex]) {
+                    continue;
+                }
+
+                if (MFALSE == inGrid->IsWalkable(targetIndex2D.X, targetIndex2D.Y)) {
+                    continue;
+                }
+
+                DistanceList[targetLocalIndex] = nextDistance;
+                PrevList[targetLocalIndex] = localIndex;
+                QueueList.push_back(targetLocalIndex);
+            }
+        }
+    }
+
+    MINT32 MClusterSearch::GetDistance(const MIntPoint& inIndex2D) const
+    {
+        if (MFALSE == IsInside(inIndex2D)) {
+            return INFINITY_DISTANCE;
+        }
+
+        return DistanceList[GetLocalIndex(inIndex2D)];
+    }
+
+    void MClusterSearch::AppendPath(std::vector<MIntPoint>& inList, const MIntPoint& inEndIndex2D) const
+    {
+        if (INFINITY_DISTANCE == GetDistance(inEndIndex2D)) {
+            return;
+        }
+
+        // 종료 위치에서 역추적 (시작 타일은 제외)
+        const size_t beginCount = inList.size();
+
+        MINT32 localIndex = GetLocalIndex(inEndIndex2D);
+        while (0 <= PrevList[localIndex])
+        {
+            inList.push_back(MIntPoint(Min.X + (localIndex % Size.X), Min.Y + (localIndex / Size.X)));
+            localIndex = PrevList[localIndex];
+        }
+
+        // 역순으로 변경
+        std::reverse(inList.begin() + beginCount, inList.end());
+    }
+
+    //---------------------------------------------------------------------------
+    // ClusterGraph
+    //---------------------------------------------------------------------------
+    void MClusterGraph::Build(const MGrid* inGrid, const MClusterGraphConfig& inConfig)
+    {
+        Grid = inGrid;
+
+        Config = inConfig;
+        Config.ClusterSize = std::max(Config.ClusterSize, 2);
+        Config.MaxTransitionGap = std::max(Config.MaxTransitionGap, 1);
+
+        // 클러스터 생성
+        const MINT32 clusterSize = Config.ClusterSize;
+        ClusterCount = MIntSize(
+            (Grid->TileCount.X + clusterSize - 1) / clusterSize,
+            (Grid->TileCount.Y + clusterSize - 1) / clusterSize);
+
+        const MINT32 clusterCount = ClusterCount.X * ClusterCount.Y;
+        ClusterList.clear();
+        ClusterList.resize(clusterCount);
+
+        for (MINT32 y = 0; y < ClusterCount.Y; ++y)
+        {
+            for (MINT32 x = 0; x < ClusterCount.X; ++x)
+            {
+                MCluster& cluster = ClusterList[(y * ClusterCount.X) + x];
+                cluster.Min = MIntPoint(x * clusterSize, y * clusterSize);
+                cluster.Size = MIntSize(
+                    std::min(clusterSize, Grid->TileCount.X - cluster.Min.X),
+                    std::min(clusterSize, Grid->TileCount.Y - cluster.Min.Y));
+            }
+        }
+
+        // 노드 초기화
+        NodeList.clear();
+        FreeNodeList.clear();
+        TileNodeMap.clear();
+
+        BorderTransitionList.clear();
+        BorderTransitionList.resize(clusterCount * 2);
+
+        // 경계 전이 지점 생성
+        for (MINT32 i = 0; i < clusterCount * 2; ++i) {
+            BuildBorder(i);
+        }
+
+        // 내부 간선 생성
+        for (MINT32 i = 0; i < clusterCount; ++i) {
+            BuildIntraEdge(i);
+        }
+    }
+
+    void MClusterGraph::UpdateTiles(const std::vector<MIntPoint>& inChangedList)
+    {
+        std::vector<MINT32> borderList;
+        std::vector<MINT32> clusterList;
+
+        // 바뀐 타일이 걸쳐있는 경계 / 클러스터를 모은다
+        for (const MIntPoint& index2D : inChangedList)
+        {
+            if (nullptr == Grid->GetTile(index2D)) {
+                continue;
+            }
+
+            const MINT32 clusterX = index2D.X / Config.ClusterSize;
+            const MINT32 clusterY = index2D.Y / Config.ClusterSize;
+            const MINT32 clusterIndex = (clusterY * ClusterCount.X) + clusterX;
+            clusterList.push_back(clusterIndex);
+
+            const MCluster& cluster = ClusterList[clusterIndex];
+            const MINT32 localX = index2D.X - cluster.Min.X;
+            const MINT32 localY = index2D.Y - cluster.Min.Y;
+
+            // 오른쪽 / 왼쪽
+            if (localX == cluster.Size.X - 1 && clusterX + 1 < ClusterCount.X)
+            {
+                borderList.push_back(GetBorderIndex(clusterX, clusterY, 0));
+                clusterList.push_back(clusterIndex + 1);
+            }
+            if (0 == localX && 0 < clusterX)
+            {
+                borderList.push_back(GetBorderIndex(clusterX - 1, clusterY, 0));
+                clusterList.push_back(clusterIndex - 1);
+            }
+
+            // 아래쪽 / 위쪽
+            if (localY == cluster.Size.Y - 1 && clusterY + 1 < ClusterCount.Y)
+            {
+                borderList.push_back(GetBorderIndex(clusterX, clusterY, 1));
+                clusterList.push_back(clusterIndex + ClusterCount.X);
+            }
+            if (0 == localY && 0 < clusterY)
+            {
+                borderList.push_back(GetBorderIndex(clusterX, clusterY - 1, 1));
+                clusterList.push_back(clusterIndex - ClusterCount.X);
+            }
+        }
+
+        std::sort(borderList.begin(), borderList.end());
+        borderList.erase(std::unique(borderList.begin(), borderList.end()), borderList.end());
+
+        std::sort(clusterList.begin(), clusterList.end());
+        clusterList.erase(std::unique(clusterList.begin(), clusterList.end()), clusterList.end());
+
+        // 경계는 모두 제거한뒤 다시 생성 (노드 재사용을 위해)
+        for (MINT32 borderIndex : borderList) {
+            ClearBorder(borderIndex);
+        }
+
+        for (MINT32 borderIndex : borderList) {
+            BuildBorder(borderIndex);
+        }
+
+        // 내부 간선 갱신
+        for (MINT32 clusterIndex : clusterList) {
+            BuildIntraEdge(clusterIndex);
+        }
+    }
+
+    MINT32 MClusterGraph::FindNode(MINT32 inTileIndex) const
+    {
+        auto findIter = TileNodeMap.find(inTileIndex);
+        if (TileNodeMap.end() != findIter) {
+            return findIter->second;
+        }
+
+        return -1;
+    }
+
+    void MClusterGraph::BuildBorder(MINT32 inBorderIndex)
+    {
+        const MINT32 clusterIndex = inBorderIndex / 2;
+        const MINT32 side = inBorderIndex % 2;
+
+        const MINT32 clusterX = clusterIndex % ClusterCount.X;
+        const MINT32 clusterY = clusterIndex / ClusterCount.X;
+
+        const MCluster& cluster = ClusterList[clusterIndex];
+
+        // 경계 양쪽 타일 / 경계를 따라가는 방향
+        MIntPoint baseIndex2D;
+        MIntPoint crossStep;
+        MIntPoint lineStep;
+        MINT32 lineCount = 0;
+
+        if (0 == side)
+        {
+            if (ClusterCount.X <= clusterX + 1) {
+                return;
+            }
+
+            baseIndex2D = MIntPoint(cluster.Min.X + cluster.Size.X - 1, cluster.Min.Y);
+            crossStep = MIntPoint(1, 0);
+            lineStep = MIntPoint(0, 1);
+            lineCount = cluster.Size.Y;
+        }
+        else
+        {
+            if (ClusterCount.Y <= clusterY + 1) {
+                return;
+            }
+
+            baseIndex2D = MIntPoint(cluster.Min.X, cluster.Min.Y + cluster.Size.Y - 1);
+            crossStep = MIntPoint(0, 1);
+            lineStep = MIntPoint(1, 0);
+            lineCount = cluster.Size.X;
+        }
+
+        auto GetLineIndex2D = [&baseIndex2D, &lineStep](MINT32 inOffset) {
+            return MIntPoint(baseIndex2D.X + (lineStep.X * inOffset), baseIndex2D.Y + (lineStep.Y * inOffset));
+        };
+
+        // 양쪽이 모두 열려있는 구간을 찾아서 전이 지점을 만든다
+        MINT32 runStart = -1;
+        for (MINT32 i = 0; i <= lineCount; ++i)
+        {
+            MBOOL isOpen = MFALSE;
+            if (i < lineCount)
+            {
+                const MIntPoint index2D = GetLineIndex2D(i);
+                const MIntPoint crossIndex2D = index2D + crossStep;
+                isOpen = Grid->IsWalkable(index2D.X, index2D.Y) && Grid->IsWalkable(crossIndex2D.X, crossIndex2D.Y);
+            }
+
+            if (MTRUE == isOpen)
+            {
+                if (runStart < 0) {
+                    runStart = i;
+                }
+                continue;
+            }
+
+            if (runStart < 0) {
+                continue;
+            }
+
+            const MINT32 runEnd = i - 1;
+            const MINT32 runLength = runEnd - runStart + 1;
+
+            if (runLength <= Config.MaxTransitionGap)
+            {
+                // 짧은 구간은 중앙 하나
+                const MIntPoint index2D = GetLineIndex2D(runStart + ((runLength - 1) / 2));
+                AddTransition(inBorderIndex, index2D, index2D + crossStep);
+            }
+            else
+            {
+                // 긴 구간은 양 끝과 간격마다
+                for (MINT32 offset = runStart; offset < runEnd; offset += Config.MaxTransitionGap)
+                {
+                    const MIntPoint index2D = GetLineIndex2D(offset);
+                    AddTransition(inBorderIndex, index2D, index2D + crossStep);
+                }
+
+                const MIntPoint index2D = GetLineIndex2D(runEnd);
+                AddTransition(inBorderIndex, index2D, index2D + crossStep);
+            }
+
+            runStart = -1;
+        }
+    }
+
+    void MClusterGraph::ClearBorder(MINT32 inBorderIndex)
+    {
+        auto RemoveEdgeFunc = [this, inBorderIndex](MINT32 inNodeIndex, MINT32 inTargetNode)
+        {
+            std::vector<MAbstractEdge>& edgeList = NodeList[inNodeIndex].EdgeList;
+            edgeList.erase(
+                std::remove_if(edgeList.begin(), edgeList.end(), [inBorderIndex, inTargetNode](const MAbstractEdge& inEdge) {
+                    return inEdge.BorderIndex == inBorderIndex && inEdge.TargetNode == inTargetNode;
+                }),
+                edgeList.end());
+        };
+
+        for (const auto& pair : BorderTransitionList[inBorderIndex])
+        {
+            RemoveEdgeFunc(pair.first, pair.second);
+            RemoveEdgeFunc(pair.second, pair.first);
+
+            RemoveNodeRef(pair.first);
+            RemoveNodeRef(pair.second);
+        }
+
+        BorderTransitionList[inBorderIndex].clear();
+    }
+
+    void MClusterGraph::AddTransition(MINT32 inBorderIndex, const MIntPoint& inIndex2D1, const MIntPoint& inIndex2D2)
+    {
+        const MINT32 node1 = AddNodeRef(inIndex2D1);
+        const MINT32 node2 = AddNodeRef(inIndex2D2);
+
+        // 경계를 넘는 간선은 한칸 거리
+        MAbstractEdge edge;
+        edge.Distance = 10;
+        edge.BorderIndex = inBorderIndex;
+
+        edge.TargetNode = node2;
+        NodeList[node1].EdgeList.push_back(edge);
+
+        edge.TargetNode = node1;
+        NodeList[node2].EdgeList.push_back(edge);
+
+        BorderTransitionList[inBorderIndex].push_back(std::make_pair(node1, node2));
+    }
+
+    void MClusterGraph::BuildIntraEdge(MINT32 inClusterIndex)
+    {
+        const MCluster& cluster = ClusterList[inClusterIndex];
+
+        // 기존 내부 간선 제거
+        for (MINT32 nodeIndex : cluster.NodeList)
+        {
+            std::vector<MAbstractEdge>& edgeList = NodeList[nodeIndex].EdgeList;
+            edgeList.erase(
+                std::remove_if(edgeList.begin(), edgeList.end(), [](const MAbstractEdge& inEdge) {
+                    return inEdge.BorderIndex < 0;
+                }),
+                edgeList.end());
+        }
+
+        // 각 노드에서 클러스터 안의 다른 노드까지 거리를 구한다
+        for (MINT32 nodeIndex : cluster.NodeList)
+        {
+            MAbstractNode& node = NodeList[nodeIndex];
+            ClusterSearch.Search(Grid, cluster.Min, cluster.Size, Grid->GetTileIndex2D(node.TileIndex));
+
+            for (MINT32 targetNode : cluster.NodeList)
+            {
+                if (targetNode == nodeIndex) {
+                    continue;
+                }
+
+                const MINT32 distance = ClusterSearch.GetDistance(Grid->GetTileIndex2D(NodeList[targetNode].TileIndex));
+                if (INFINITY_DISTANCE == distance) {
+                    continue;
+                }
+
+                MAbstractEdge edge;
+                edge.TargetNode = targetNode;
+                edge.Distance = distance;
+                node.EdgeList.push_back(edge);
+            }
+        }
+    }
+
+    MINT32 MClusterGraph::AddNodeRef(const MIntPoint& inIndex2D)
+    {
+        const MINT32 tileIndex = Grid->GetTileIndex(inIndex2D);
+
+        // 이미 있다면 참조만 추가
+        auto findIter = TileNodeMap.find(tileIndex);
+        if (TileNodeMap.end() != findIter)
+        {
+            ++NodeList[findIter->second].TransitionCount;
+            return findIter->second;
+        }
+
+        // 비어있는 슬롯 사용
+        MINT32 nodeIndex = -1;
+        if (MFALSE == FreeNodeList.empty())
+        {
+            nodeIndex = FreeNodeList.back();
+            FreeNodeList.pop_back();
+        }
+        else
+        {
+            nodeIndex = static_cast<MINT32>(NodeList.size());
+            NodeList.emplace_back();
+        }
+
+        MAbstractNode& node = NodeList[nodeIndex];
+        node.TileIndex = tileIndex;
+        node.ClusterIndex = GetClusterIndex(inIndex2D);
+        node.TransitionCount = 1;
+        node.EdgeList.clear();
+
+        ClusterList[node.ClusterIndex].NodeList.push_back(nodeIndex);
+        TileNodeMap.emplace(tileIndex, nodeIndex);
+
+        return nodeIndex;
+    }
+
+    void MClusterGraph::RemoveNodeRef(MINT32 inNodeIndex)
+    {
+        MAbstractNode& node = NodeList[inNodeIndex];
+        if (0 < --node.TransitionCount) {
+            return;
+        }
+
+        // 더이상 사용하지 않는 노드는 반납
+        std::vector<MINT32>& clusterNodeList = ClusterList[node.ClusterIndex].NodeList;
+        clusterNodeList.erase(std::remove(clusterNodeList.begin(), clusterNodeList.end(), inNodeIndex), clusterNodeList.end());
+
+        TileNodeMap.erase(node.TileIndex);
+
+        node.TileIndex = -1;
+        node.ClusterIndex = -1;
+        node.EdgeList.clear();
+
+        FreeNodeList.push_back(inNodeIndex);
+    }
+
+    //---------------------------------------------------------------------------
+    // HierarchicalPathFinder
+    //---------------------------------------------------------------------------
+    MHierarchicalPathFinder::MHierarchicalPathFinder(const MClusterGraph* inGraph)
+    {
+        Graph = inGraph;
+
+        // 클러스터 두개 정도의 거리는 바로 검색하는게 빠르다
+        DirectSearchDistance = inGraph->GetConfig().ClusterSize * 2;
+    }
+
+    MBOOL MHierarchicalPathFinder::FindAbstractPath(MHierarchicalPath& outPath, const MIntPoint& inStartIndex2D, const MIntPoint& inEndIndex2D)
+    {
+        outPath.Clear();
+
+        const MGrid* grid = Graph->GetGrid();
+        if (nullptr == grid->GetTile(inStartIndex2D) || nullptr == grid->GetTile(inEndIndex2D)) {
+            return MFALSE;
+        }
+
+        const MINT32 startClusterIndex = Graph->GetClusterIndex(inStartIndex2D);
+        const MINT32 endClusterIndex = Graph->GetClusterIndex(inEndIndex2D);
+
+        //----------------------------------------------------------------
+        // 가까운 거리라면 일반 검색 결과를 그대로 사용
+        //----------------------------------------------------------------
+        const MINT32 manhattan = abs(inEndIndex2D.X - inStartIndex2D.X) + abs(inEndIndex2D.Y - inStartIndex2D.Y);
+        // 막힌 시작 타일에서 출발하는 경우는 전이 지점이 없으므로 일반 검색을 사용
+        const MBOOL isStartBlocked = (MFALSE == grid->IsWalkable(inStartIndex2D.X, inStartIndex2D.Y));
+        if (startClusterIndex == endClusterIndex || manhattan <= DirectSearchDistance || MTRUE == isStartBlocked)
+        {
+            PathFinder.FindPath(outPath.WaypointList, grid, inStartIndex2D, inEndIndex2D);
+            outPath.Distance = (static_cast<MINT32>(outPath.WaypointList.size()) - 1) * 10;
+            return outPath.IsValid();
+        }
+
+        // 막힌 타일로는 이동할 수 없다
+        if (MFALSE == grid->IsWalkable(inEndIndex2D.X, inEndIndex2D.Y)) {
+            return MFALSE;
+        }
+
+        //----------------------------------------------------------------
+        // 시작 / 종료 타일을 각 클러스터의 노드와 연결
+        //----------------------------------------------------------------
+        ConnectTerminal(StartEdgeList, inStartIndex2D);
+        ConnectTerminal(EndEdgeList, inEndIndex2D);
+
+        if (MTRUE == StartEdgeList.empty() || MTRUE == EndEdgeList.empty()) {
+            return MFALSE;
+        }
+
+        //----------------------------------------------------------------
+        // 추상 그래프 검색
+        //----------------------------------------------------------------
+        const MINT32 nodeCount = Graph->GetNodeCount();
+        const MINT32 startNode = nodeCount;
+        const MINT32 endNode = nodeCount + 1;
+
+        NodeTable.BeginSearch(nodeCount + 2);
+        OpenList.Reset(NodeTable.GetNodeData());
+
+        auto GetTileIndex2DFunc = [this, grid, startNode, endNode, &inStartIndex2D, &inEndIndex2D](MINT32 inNodeIndex)
+        {
+            if (startNode == inNodeIndex) {
+                return inStartIndex2D;
+            }
+            if (endNode == inNodeIndex) {
+                return inEndIndex2D;
+            }
+            return grid->GetTileIndex2D(Graph->GetNode(inNodeIndex).TileIndex);
+        };
+
+        auto UpdateFunc = [this, &GetTileIndex2DFunc, &inEndIndex2D](MINT32 inTargetNode, MINT32 inBaseNode, MINT32 inDistance_G)
+        {
+            if (MTRUE == NodeTable.IsClose(inTargetNode)) {
+                return;
+            }
+
+            const MIntPoint targetIndex2D = GetTileIndex2DFunc(inTargetNode);
+            const MINT32 distanceH = (abs(inEndIndex2D.X - targetIndex2D.X) + abs(inEndIndex2D.Y - targetIndex2D.Y)) * 10;
+
+            MNode& targetNode = NodeTable.VisitNode(inTargetNode, distanceH);
+            if (inDistance_G < targetNode.GetDistance_G())
+            {
+                targetNode.SetDistance_G(inDistance_G);
+                targetNode.SetPrevIndex(inBaseNode);
+
+                if (MTRUE == OpenList.IsContain(inTargetNode)) {
+                    OpenList.Update(inTargetNode);
+                }
+                else {
+                    OpenList.Push(inTargetNode);
+                }
+            }
+        };
+
+        UpdateFunc(startNode, -1, 0);
+
+        while (MTRUE)
+        {
+            const MINT32 checkNode = OpenList.Top();
+            if (checkNode < 0 || checkNode == endNode) {
+                break;
+            }
+
+            OpenList.Pop();
+            NodeTable.SetClose(checkNode);
+
+            const MINT32 baseDistance_G = NodeTable.GetNode(checkNode).GetDistance_G();
+
+            if (startNode == checkNode)
+            {
+                for (const auto& pair : StartEdgeList) {
+                    UpdateFunc(pair.first, checkNode, baseDistance_G + pair.second);
+                }
+                continue;
+            }
+
+            const MAbstractNode& node = Graph->GetNode(checkNode);
+            for (const MAbstractEdge& edge : node.EdgeList) {
+                UpdateFunc(edge.TargetNode, checkNode, baseDistance_G + edge.Distance);
+            }
+
+            // 종료 클러스터의 노드라면 종료 타일로 연결
+            if (node.ClusterIndex == endClusterIndex)
+            {
+                for (const auto& pair : EndEdgeList)
+                {
+                    if (pair.first == checkNode) {
+                        UpdateFunc(endNode, checkNode, baseDistance_G + pair.second);
+                    }
+                }
+            }
+        }
+
+        if (MFALSE == NodeTable.IsVisited(endNode)) {
+            return MFALSE;
+        }
+
+        // 역추적
+        for (MINT32 nodeIndex = endNode; 0 <= nodeIndex; nodeIndex = NodeTable.GetNode(nodeIndex).GetPrevIndex()) {
+            outPath.WaypointList.push_back(GetTileIndex2DFunc(nodeIndex));
+        }
+
+        std::reverse(outPath.WaypointList.begin(), outPath.WaypointList.end());
+        outPath.Distance = NodeTable.GetNode(endNode).GetDistance_G();
+
+        return MTRUE;
+    }
+
+    MBOOL MHierarchicalPathFinder::RefineNext(MHierarchicalPath& inPath, std::vector<MIntPoint>& inList)
+    {
+        if (MFALSE == inPath.IsValid() || MTRUE == inPath.IsComplete()) {
+            return MFALSE;
+        }
+
+        // 처음이라면 시작 타일 추가
+        if (0 == inPath.RefineIndex) {
+            inList.push_back(inPath.WaypointList.front());
+        }
+
+        const MIntPoint& fromIndex2D = inPath.WaypointList[inPath.RefineIndex];
+        const MIntPoint& toIndex2D = inPath.WaypointList[inPath.RefineIndex + 1];
+
+        const MINT32 manhattan = abs(toIndex2D.X - fromIndex2D.X) + abs(toIndex2D.Y - fromIndex2D.Y);
+        if (1 == manhattan)
+        {
+            // 인접한 타일
+            inList.push_back(toIndex2D);
+        }
+        else if (1 < manhattan)
+        {
+            // 같은 클러스터 안에서만 검색
+            const MCluster& cluster = Graph->GetCluster(Graph->GetClusterIndex(fromIndex2D));
+            ClusterSearch.Search(Graph->GetGrid(), cluster.Min, cluster.Size, fromIndex2D, &toIndex2D);
+
+            if (INFINITY_DISTANCE == ClusterSearch.GetDistance(toIndex2D))
+            {
+                // 추상 경로를 구한 뒤에 그리드가 바뀐 경우
+                return MFALSE;
+            }
+
+            ClusterSearch.AppendPath(inList, toIndex2D);
+        }
+
+        ++inPath.RefineIndex;
+        return MTRUE;
+    }
+
+    void MHierarchicalPathFinder::FindPath(std::vector<MIntPoint>& inList, const MIntPoint& inStartIndex2D, const MIntPoint& inEndIndex2D)
+    {
+        inList.clear();
+
+        MHierarchicalPath path;
+        if (MFALSE == FindAbstractPath(path, inStartIndex2D, inEndIndex2D)) {
+            return;
+        }
+
+        if (MTRUE == path.IsComplete())
+        {
+            // 시작과 종료가 같은 타일
+            inList.push_back(inStartIndex2D);
+            return;
+        }
+
+        while (MTRUE == RefineNext(path, inList)) {}
+    }
+
+    void MHierarchicalPathFinder::ConnectTerminal(std::vector<std::pair<MINT32, MINT32>>& outEdgeList, const MIntPoint& inIndex2D)
+    {
+        outEdgeList.clear();
+
+        const MCluster& cluster = Graph->GetCluster(Graph->GetClusterIndex(inIndex2D));
+        ClusterSearch.Search(Graph->GetGrid(), cluster.Min, cluster.Size, inIndex2D);
+
+        for (MINT32 nodeIndex : cluster.NodeList)
+        {
+            const MINT32 distance = ClusterSearch.GetDistance(Graph->GetGrid()->GetTileIndex2D(Graph->GetNode(nodeIndex).TileIndex));
+            if (INFINITY_DISTANCE != distance) {
+                outEdgeList.push_back(std::make_pair(nodeIndex, distance));
+            }
+        }
+    }
+};
@@ -0,0 +1,282 @@
+﻿#pragma once
+
+#include <vector>
+#include <unordered_map>
+
+#include "MPrerequisites.h"
+#include "MType.h"
+#include "MAstar.h"
+
+
+namespace MAstar
+{
+    //----------------------------------------------------------------------
+    // 클러스터 설정
+    //----------------------------------------------------------------------
+    struct MClusterGraphConfig
+    {
+    public:
+        // 클러스터 한변의 타일 수
+        MINT32 ClusterSize = 16;
+
+        // 입구 구간에서 전이 지점 사이의 최대 간격(타일 수)
+        // 경계를 한번 넘을때마다 최적 경로보다 최대 이만큼 돌아갈 수 있다 (1이면 최적 경로)
+        MINT32 MaxTransitionGap = 6;
+    };
+
+    //----------------------------------------------------------------------
+    // 추상 그래프의 간선
+    //----------------------------------------------------------------------
+    struct MAbstractEdge
+    {
+    public:
+        // 대상 노드
+        MINT32 TargetNode = -1;
+
+        // 거리
+        MINT32 Distance = 0;
+
+        // 클러스터 사이의 간선이라면 경계 인덱스 (클러스터 내부 간선은 -1)
+        MINT32 BorderIndex = -1;
+    };
+
+    //----------------------------------------------------------------------
+    // 추상 그래프의 노드 (클러스터 경계의 전이 지점)
+    //----------------------------------------------------------------------
+    struct MAbstractNode
+    {
+    public:
+        // 타일 인덱스 (-1이면 사용하지 않는 노드)
+        MINT32 TileIndex = -1;
+
+        // 속한 클러스터
+        MINT32 ClusterIndex = -1;
+
+        // 이 노드를 사용하는 전이 지점 수
+        MINT32 TransitionCount = 0;
+
+        // 간선 목록
+        std::vector<MAbstractEdge> EdgeList;
+    };
+
+    //----------------------------------------------------------------------
+    // 클러스터
+    //----------------------------------------------------------------------
+    struct MCluster
+    {
+    public:
+        // 시작 인덱스 / 크기
+        MIntPoint Min;
+        MIntSize Size;
+
+        // 속한 노드 목록
+        std::vector<MINT32> NodeList;
+    };
+
+
+    //----------------------------------------------------------------------
+    // 영역 안으로 제한된 너비 우선 검색 (균일 비용)
+    //----------------------------------------------------------------------
+    class MClusterSearch
+    {
+    public:
+        // 영역 안에서 시작 타일로부터 거리를 구한다
+        // inStopIndex2D에 도달하면 검색을 멈춘다 (nullptr라면 영역 전체)
+        void Search(const MGrid* inGrid, const MIntPoint& inMin, const MIntSize& inSize, const MIntPoint& inStartIndex2D, const MIntPoint* inStopIndex2D = nullptr);
+
+        // 시작 타일로부터의 거리 (도달하지 못했거나 영역 밖이라면 INFINITY_DISTANCE)
+        MINT32 GetDistance(const MIntPoint& inIndex2D) const;
+
+        // 시작 타일 다음부터 대상 타일까지의 경로를 추가한다
+        void AppendPath(std::vector<MIntPoint>& inList, const MIntPoint& inEndIndex2D) const;
+
+    protected:
+        MINT32 GetLocalIndex(const MIntPoint& inIndex2D) const {
+            return ((inIndex2D.Y - Min.Y) * Size.X) + (inIndex2D.X - Min.X);
+        }
+
+        MBOOL IsInside(const MIntPoint& inIndex2D) const {
+            return Min.X <= inIndex2D.X && inIndex2D.X < Min.X + Size.X && Min.Y <= inIndex2D.Y && inIndex2D.Y < Min.Y + Size.Y;
+        }
+
+    protected:
+        // 검색 영역
+        MIntPoint Min;
+        MIntSize Size;
+
+        // 영역 내부 인덱스 기준 거리 / 이전 타일
+        std::vector<MINT32> DistanceList;
+        std::vector<MINT32> PrevList;
+
+        // 검색 큐
+        std::vector<MINT32> QueueList;
+    };
+
+
+    //----------------------------------------------------------------------
+    // 그리드를 클러스터로 나눈 추상 그래프 (HPA*)
+    //----------------------------------------------------------------------
+    class MClusterGraph
+    {
+    public:
+        // 그리드로 전체 그래프를 만든다
+        void Build(const MGrid* inGrid, const MClusterGraphConfig& inConfig);
+
+        // 막힘 정보가 바뀐 타일 목록으로 관련된 클러스터만 다시 만든다
+        // (그리드는 이미 변경된 상태여야 한다)
+        void UpdateTiles(const std::vector<MIntPoint>& inChangedList);
+
+        // 타일이 속한 클러스터
+        MINT32 GetClusterIndex(const MIntPoint& inIndex2D) const {
+            return ((inIndex2D.Y / Config.ClusterSize) * ClusterCount.X) + (inIndex2D.X / Config.ClusterSize);
+        }
+
+        // 타일 위치의 노드를 얻는다 (없다면 -1)
+        MINT32 FindNode(MINT32 inTileIndex) const;
+
+        const MGrid* GetGrid() const {
+            return Grid;
+        }
+
+        const MClusterGraphConfig& GetConfig() const {
+            return Config;
+        }
+
+        const MCluster& GetCluster(MINT32 inClusterIndex) const {
+            return ClusterList[inClusterIndex];
+        }
+
+        const MAbstractNode& GetNode(MINT32 inNodeIndex) const {
+            return NodeList[inNodeIndex];
+        }
+
+        // 노드 슬롯 수 (사용하지 않는 슬롯 포함)
+        MINT32 GetNodeCount() const {
+            return static_cast<MINT32>(NodeList.size());
+        }
+
+    protected:
+        // 경계 인덱스 (클러스터 * 2 + 0 : 오른쪽, 1 : 아래쪽)
+        MINT32 GetBorderIndex(MINT32 inClusterX, MINT32 inClusterY, MINT32 inSide) const {
+            return (((inClusterY * ClusterCount.X) + inClusterX) * 2) + inSide;
+        }
+
+        // 경계의 전이 지점 생성 / 제거
+        void BuildBorder(MINT32 inBorderIndex);
+        void ClearBorder(MINT32 inBorderIndex);
+
+        // 전이 지점 추가
+        void AddTransition(MINT32 inBorderIndex, const MIntPoint& inIndex2D1, const MIntPoint& inIndex2D2);
+
+        // 클러스터 내부 간선 생성
+        void BuildIntraEdge(MINT32 inClusterIndex);
+
+        // 노드 참조 추가 / 제거
+        MINT32 AddNodeRef(const MIntPoint& inIndex2D);
+        void RemoveNodeRef(MINT32 inNodeIndex);
+
+    protected:
+        // 대상 그리드
+        const MGrid* Grid = nullptr;
+
+        // 설정
+        MClusterGraphConfig Config;
+
+        // 클러스터 정보
+        MIntSize ClusterCount;
+        std::vector<MCluster> ClusterList;
+
+        // 노드 정보
+        std::vector<MAbstractNode> NodeList;
+        std::vector<MINT32> FreeNodeList;
+
+        // 타일 인덱스 -> 노드
+        std::unordered_map<MINT32, MINT32> TileNodeMap;
+
+        // 경계별 전이 지점 (노드 쌍)
+        std::vector<std::vector<std::pair<MINT32, MINT32>>> BorderTransitionList;
+
+        // 내부 간선 생성에 사용
+        MClusterSearch ClusterSearch;
+    };
+
+
+    //----------------------------------------------------------------------
+    // 추상 경로 (구간별로 필요할때 상세화)
+    //----------------------------------------------------------------------
+    class MHierarchicalPath
+    {
+    public:
+        // 경로가 있는지
+        MBOOL IsValid() const {
+            return MFALSE == WaypointList.empty();
+        }
+
+        // 모든 구간이 상세화 되었는지
+        MBOOL IsComplete() const {
+            return static_cast<MINT32>(WaypointList.size()) <= RefineIndex + 1;
+        }
+
+        void Clear() {
+            WaypointList.clear();
+            RefineIndex = 0;
+            Distance = 0;
+        }
+
+    public:
+        // 경유 타일 (시작, 전이 지점들, 종료)
+        std::vector<MIntPoint> WaypointList;
+
+        // 다음에 상세화 할 구간
+        MINT32 RefineIndex = 0;
+
+        // 추상 경로 거리
+        MINT32 Distance = 0;
+    };
+
+
+    //----------------------------------------------------------------------
+    // 추상 그래프를 이용한 경로 검색
+    //----------------------------------------------------------------------
+    class MHierarchicalPathFinder
+    {
+    public:
+        MHierarchicalPathFinder(const MClusterGraph* inGraph);
+
+    public:
+        // 추상 경로를 구한다
+        MBOOL FindAbstractPath(MHierarchicalPath& outPath, const MIntPoint& inStartIndex2D, const MIntPoint& inEndIndex2D);
+
+        // 다음 구간을 상세화 해서 타일 경로에 추가한다 (더이상 구간이 없다면 MFALSE)
+        MBOOL RefineNext(MHierarchicalPath& inPath, std::vector<MIntPoint>& inList);
+
+        // 전체 타일 경로를 구한다
+        void FindPath(std::vector<MIntPoint>& inList, const MIntPoint& inStartIndex2D, const MIntPoint& inEndIndex2D);
+
+    public:
+        // 맨허튼 거리가 이 값(타일 수) 이하인 검색은 일반 A*로 처리
+        MINT32 DirectSearchDistance = 0;
+
+    protected:
+        // 시작 / 종료 타일과 클러스터 노드를 연결
+        void ConnectTerminal(std::vector<std::pair<MINT32, MINT32>>& outEdgeList, const MIntPoint& inIndex2D);
+
+    protected:
+        // 추상 그래프
+        const MClusterGraph* Graph = nullptr;
+
+        // 추상 그래프 검색용
+        MNodeTable NodeTable;
+        MOpenList OpenList;
+
+        // 클러스터 내부 검색용
+        MClusterSearch ClusterSearch;
+
+        // 가까운 거리 검색용
+        MPathFinder PathFinder;
+
+        // 시작 / 종료 연결 간선 (노드, 거리)
+        std::vector<std::pair<MINT32, MINT32>> StartEdgeList;
+        std::vector<std::pair<MINT32, MINT32>> EndEdgeList;
+    };
+};
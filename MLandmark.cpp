@@ -0,0 +1,353 @@
+﻿#include "MLandmark.h"
+#include "MGridCommon.h"
+
+#include <cstdio>
+#include <random>
+#include <thread>
+
+
+namespace MAstar
+{
+    namespace
+    {
+        // 파일 헤더
+        struct MLandmarkFileHeader
+        {
+        public:
+            MUINT32 Magic = MLANDMARK_FILE_MAGIC;
+            MUINT32 Version = MLANDMARK_FILE_VERSION;
+
+            MINT32 TileCountX = 0;
+            MINT32 TileCountY = 0;
+
+            MINT32 LandmarkCount = 0;
+            MUINT32 Reserved = 0;
+        };
+
+        // 가장 먼 타일 선택시 시작 타일을 고르는 최대 횟수
+        const MINT32 StartTryCount = 8;
+
+        // 파일에 저장할 수 있는 최대 랜드마크 수 (잘못된 헤더로 큰 메모리를 할당하지 않도록)
+        const MINT32 MaxFileLandmarkCount = 256;
+
+        // 파일 크기 (읽을 위치는 유지)
+        MBOOL GetFileSize(FILE* inFile, MUINT64& outSize)
+        {
+#if defined(_MSC_VER)
+            const __int64 position = _ftelli64(inFile);
+            if (position < 0 || 0 != _fseeki64(inFile, 0, SEEK_END)) {
+                return MFALSE;
+            }
+
+            const __int64 size = _ftelli64(inFile);
+            if (size < 0 || 0 != _fseeki64(inFile, position, SEEK_SET)) {
+                return MFALSE;
+            }
+#else
+            const off_t position = ftello(inFile);
+            if (position < 0 || 0 != fseeko(inFile, 0, SEEK_END)) {
+                return MFALSE;
+            }
+
+            const off_t size = ftello(inFile);
+            if (size < 0 || 0 != fseeko(inFile, position, SEEK_SET)) {
+                return MFALSE;
+            }
+#endif
+            outSize = static_cast<MUINT64>(size);
+            return MTRUE;
+        }
+    }
+
+    void MLandmarkMap::Build(const MGrid* inGrid, MINT32 inLandmarkCount, MLandmarkSelection inSelection, MUINT32 inSeed)
+    {
+        // 이동 가능한 타일 목록
+        std::vector<MIntPoint> walkableList;
+        for (const MTile& tile : inGrid->TileList)
+        {
+            if (MFALSE == tile.IsBlocked) {
+                walkableList.push_back(tile.Index2D);
+            }
+        }
+
+        const MINT32 landmarkCount = std::min(inLandmarkCount, static_cast<MINT32>(walkableList.size()));
+        if (landmarkCount <= 0)
+        {
+            Build(inGrid, std::vector<MIntPoint>());
+            return;
+        }
+
+        std::mt19937 random(inSeed);
+
+        if (MLandmarkSelection::Random == inSelection)
+        {
+            // 앞에서부터 무작위로 섞어서 사용
+            for (MINT32 i = 0; i < landmarkCount; ++i) {
+                std::swap(walkableList[i], walkableList[i + (random() % (walkableList.size() - i))]);
+            }
+
+            walkableList.resize(landmarkCount);
+            Build(inGrid, walkableList);
+            return;
+        }
+
+        //----------------------------------------------------------------
+        // 가장 먼 타일 선택
+        // 고를때마다 거리를 계산해야 하므로 랜드마크 단위로 순서대로 처리
+        // 도달할 수 없는 타일은 고르지 않는다 (작은 고립 영역에 랜드마크를 낭비하지 않도록)
+        //----------------------------------------------------------------
+        Grid = inGrid;
+        LandmarkList.clear();
+        LandmarkList.resize(landmarkCount);
+        DistanceList.assign(static_cast<size_t>(Grid->TileList.size()) * landmarkCount, INFINITY_DISTANCE);
+
+        const MINT32 tileCount = static_cast<MINT32>(Grid->TileList.size());
+
+        // 랜드마크별 최소 거리
+        std::vector<MINT32> minDistanceList(tileCount, INFINITY_DISTANCE);
+
+        //----------------------------------------------------------------
+        // 첫 랜드마크는 무작위 타일에서 가장 먼 타일
+        // 무작위 타일이 작은 고립 영역에 있다면 다른 타일로 다시 시도
+        //----------------------------------------------------------------
+        const MINT32 walkableCount = static_cast<MINT32>(walkableList.size());
+
+        MIntPoint startIndex2D;
+        MINT32 bestReachCount = -1;
+
+        for (MINT32 i = 0; i < StartTryCount && bestReachCount * 2 < walkableCount; ++i)
+        {
+            LandmarkList[0] = walkableList[random() % walkableList.size()];
+            BuildDistance(0);
+
+            MINT32 reachCount = 0;
+            for (MINT32 index = 0; index < tileCount; ++index) {
+                reachCount += (INFINITY_DISTANCE != GetDistance(0, index)) ? 1 : 0;
+            }
+
+            if (bestReachCount < reachCount)
+            {
+                bestReachCount = reachCount;
+                startIndex2D = LandmarkList[0];
+            }
+        }
+
+        LandmarkList[0] = startIndex2D;
+        BuildDistance(0);
+
+        for (MINT32 landmark = 0; landmark < landmarkCount; ++landmark)
+        {
+            // 먼저 계산한 거리로 다음 타일 선택
+            MINT32 bestIndex = -1;
+            MINT32 bestDistance = -1;
+
+            for (MINT32 i = 0; i < tileCount; ++i)
+            {
+                if (MTRUE == Grid->TileList[i].IsBlocked) {
+                    continue;
+                }
+
+                // 첫 랜드마크는 임시 위치에서의 거리로 선택
+                const MINT32 distance = (0 == landmark) ? GetDistance(0, i) : minDistanceList[i];
+                if (INFINITY_DISTANCE == distance) {
+                    continue;
+                }
+
+                if (bestDistance < distance)
+                {
+                    bestDistance = distance;
+                    bestIndex = i;
+                }
+            }
+
+            LandmarkList[landmark] = Grid->GetTileIndex2D(bestIndex);
+            BuildDistance(landmark);
+
+            for (MINT32 i = 0; i < tileCount; ++i) {
+                minDistanceList[i] = std::min(minDistanceList[i], GetDistance(landmark, i));
+            }
+        }
+    }
+
+    void MLandmarkMap::Build(const MGrid* inGrid, const std::vector<MIntPoint>& inLandmarkList)
+    {
+        Grid = inGrid;
+        LandmarkList = inLandmarkList;
+        DistanceList.assign(static_cast<size_t>(Grid->TileList.size()) * LandmarkList.size(), INFINITY_DISTANCE);
+
+        // 랜드마크끼리는 독립적이므로 랜드마크 단위로 나눠서 처리
+        const MINT32 landmarkCount = GetLandmarkCount();
+        const MINT32 threadCount = std::max(1, std::min(ThreadCount, landmarkCount));
+
+        std::vector<std::thread> threadList;
+        for (MINT32 i = 1; i < threadCount; ++i) {
+            threadList.emplace_back(&MLandmarkMap::BuildDistanceRange, this, (landmarkCount * i) / threadCount, (landmarkCount * (i + 1)) / threadCount);
+        }
+
+        BuildDistanceRange(0, landmarkCount / threadCount);
+
+        for (std::thread& thread : threadList) {
+            thread.join();
+        }
+    }
+
+    MBOOL MLandmarkMap::Save(const char* inPath) const
+    {
+        if (nullptr == Grid || MaxFileLandmarkCount < GetLandmarkCount()) {
+            return MFALSE;
+        }
+
+        MLandmarkFileHeader header;
+        header.TileCountX = Grid->TileCount.X;
+        header.TileCountY = Grid->TileCount.Y;
+        header.LandmarkCount = GetLandmarkCount();
+
+        FILE* file = fopen(inPath, "wb");
+        if (nullptr == file) {
+            return MFALSE;
+        }
+
+        MBOOL isSuccess = (1 == fwrite(&header, sizeof(header), 1, file));
+
+        for (const MIntPoint& landmark : LandmarkList)
+        {
+            const MINT32 value[2] = { landmark.X, landmark.Y };
+            isSuccess = isSuccess && (1 == fwrite(value, sizeof(value), 1, file));
+        }
+
+        if (MFALSE == DistanceList.empty()) {
+            isSuccess = isSuccess && (DistanceList.size() == fwrite(DistanceList.data(), sizeof(MINT32), DistanceList.size(), file));
+        }
+
+        isSuccess = (0 == fclose(file)) && isSuccess;
+
+        return isSuccess;
+    }
+
+    MBOOL MLandmarkMap::Load(const char* inPath, const MGrid* inGrid)
+    {
+        FILE* file = fopen(inPath, "rb");
+        if (nullptr == file) {
+            return MFALSE;
+        }
+
+        MLandmarkFileHeader header;
+        MBOOL isSuccess = (1 == fread(&header, sizeof(header), 1, file));
+
+        isSuccess = isSuccess && MLANDMARK_FILE_MAGIC == header.Magic && MLANDMARK_FILE_VERSION == header.Version;
+        isSuccess = isSuccess && inGrid->TileCount.X == header.TileCountX && inGrid->TileCount.Y == header.TileCountY;
+
+        // 랜드마크 수는 최대값 / 타일 수 이하이고 남은 파일 크기가 (위치 + 타일별 거리)와 맞아야 한다
+        const MUINT64 tileCount = inGrid->TileList.size();
+        isSuccess = isSuccess && 0 <= header.LandmarkCount && header.LandmarkCount <= MaxFileLandmarkCount && static_cast<MUINT64>(header.LandmarkCount) <= tileCount;
+
+        MUINT64 fileSize = 0;
+        isSuccess = isSuccess && MTRUE == GetFileSize(file, fileSize);
+        isSuccess = isSuccess && fileSize - sizeof(header) == static_cast<MUINT64>(header.LandmarkCount) * ((sizeof(MINT32) * 2) + (sizeof(MINT32) * tileCount));
+
+        std::vector<MIntPoint> landmarkList;
+        std::vector<MINT32> distanceList;
+
+        if (MTRUE == isSuccess)
+        {
+            landmarkList.resize(header.LandmarkCount);
+            for (MIntPoint& landmark : landmarkList)
+            {
+                MINT32 value[2] = {};
+                isSuccess = isSuccess && (1 == fread(value, sizeof(value), 1, file)) && nullptr != inGrid->GetTile(value[0], value[1]);
+                landmark = MIntPoint(value[0], value[1]);
+            }
+
+            distanceList.resize(inGrid->TileList.size() * landmarkList.size());
+            if (MFALSE == distanceList.empty()) {
+                isSuccess = isSuccess && (distanceList.size() == fread(distanceList.data(), sizeof(MINT32), distanceList.size(), file));
+            }
+        }
+
+        fclose(file);
+
+        if (MFALSE == isSuccess) {
+            return MFALSE;
+        }
+
+        Grid = inGrid;
+        LandmarkList.swap(landmarkList);
+        DistanceList.swap(distanceList);
+
+        return MTRUE;
+    }
+
+    MINT32 MLandmarkMap::GetHeuristic(MINT32 inIndex, MINT32 inGoalIndex) const
+    {
+        const MINT32 landmarkCount = GetLandmarkCount();
+        const MINT32* distanceList = &DistanceList[inIndex * landmarkCount];
+        const MINT32* goalDistanceList = &DistanceList[inGoalIndex * landmarkCount];
+
+        MINT32 heuristic = 0;
+        for (MINT32 i = 0; i < landmarkCount; ++i)
+        {
+            // 한쪽이라도 도달할 수 없다면 하한을 알 수 없다
+            if (INFINITY_DISTANCE == distanceList[i] || INFINITY_DISTANCE == goalDistanceList[i]) {
+                continue;
+            }
+
+            heuristic = std::max(heuristic, abs(distanceList[i] - goalDistanceList[i]));
+        }
+
+        return heuristic;
+    }
+
+    void MLandmarkMap::BuildDistance(MINT32 inLandmark)
+    {
+        const MINT32 landmarkCount = GetLandmarkCount();
+        const MIntPoint& landmarkIndex2D = LandmarkList[inLandmark];
+
+        const size_t count = DistanceList.size();
+        for (size_t i = inLandmark; i < count; i += landmarkCount) {
+            DistanceList[i] = INFINITY_DISTANCE;
+        }
+
+        // 막힌 타일이라면 주변으로 나가지 않는다
+        if (MFALSE == Grid->IsWalkable(landmarkIndex2D.X, landmarkIndex2D.Y)) {
+            return;
+        }
+
+        // 균일 비용이므로 너비 우선 탐색
+        std::vector<MINT32> queueList;
+        queueList.reserve(Grid->TileList.size());
+
+        const MINT32 landmarkIndex = Grid->GetTileIndex(landmarkIndex2D);
+        DistanceList[(landmarkIndex * landmarkCount) + inLandmark] = 0;
+        queueList.push_back(landmarkIndex);
+
+        for (size_t head = 0; head < queueList.size(); ++head)
+        {
+            const MINT32 index = queueList[head];
+            const MIntPoint index2D = Grid->GetTileIndex2D(index);
+            const MINT32 nextDistance = DistanceList[(index * landmarkCount) + inLandmark] + 10;
+
+            for (const MIntPoint& direction : GridDirectionList)
+            {
+                const MIntPoint nextIndex2D = index2D + direction;
+                if (MFALSE == Grid->IsWalkable(nextIndex2D.X, nextIndex2D.Y)) {
+                    continue;
+                }
+
+                MINT32& distance = DistanceList[(Grid->GetTileIndex(nextIndex2D) * landmarkCount) + inLandmark];
+                if (INFINITY_DISTANCE != distance) {
+                    continue;
+                }
+
+                distance = nextDistance;
+                queueList.push_back(Grid->GetTileIndex(nextIndex2D));
+            }
+        }
+    }
+
+    void MLandmarkMap::BuildDistanceRange(MINT32 inStart, MINT32 inEnd)
+    {
+        for (MINT32 landmark = inStart; landmark < inEnd; ++landmark) {
+            BuildDistance(landmark);
+        }
+    }
+};
@@ -0,0 +1,91 @@
+﻿#pragma once
+
+#include <vector>
+
+#include "MPrerequisites.h"
+#include "MType.h"
+#include "MAstar.h"
+
+
+
+#define MLANDMARK_FILE_MAGIC (0x4B4D4C4D)    // "MLMK"
+#define MLANDMARK_FILE_VERSION (1)
+
+namespace MAstar
+{
+    //----------------------------------------------------------------------
+    // 랜드마크 선택 방식
+    //----------------------------------------------------------------------
+    enum class MLandmarkSelection
+    {
+        Random,         // 이동 가능한 타일 중 무작위
+        Farthest,       // 이미 고른 랜드마크들에서 가장 먼 타일을 차례로 선택 (외곽 / 막다른 곳 위주)
+    };
+
+
+    //----------------------------------------------------------------------
+    // 랜드마크 거리 정보 (ALT 휴리스틱)
+    // 랜드마크마다 모든 타일까지의 실제 거리 (상하좌우 이동, 한칸 10)를 저장해두고
+    // 삼각 부등식 |d(L, n) - d(L, goal)| 의 최대값을 남은 거리의 하한으로 사용한다
+    // 막힘 정보가 바뀌면 다시 계산해야 한다 (막힌 타일이 늘어나는 경우는 하한이 유지된다)
+    //----------------------------------------------------------------------
+    class MLandmarkMap
+    {
+    public:
+        // 거리 계산에 사용할 스레드 수 (랜드마크 단위로 나눠서 처리)
+        void SetThreadCount(MINT32 inCount) {
+            ThreadCount = std::max(inCount, 1);
+        }
+
+        // 랜드마크를 골라서 계산 (inSeed는 시작 타일 선택에 사용)
+        void Build(const MGrid* inGrid, MINT32 inLandmarkCount, MLandmarkSelection inSelection = MLandmarkSelection::Farthest, MUINT32 inSeed = 0);
+
+        // 지정한 위치를 랜드마크로 계산
+        void Build(const MGrid* inGrid, const std::vector<MIntPoint>& inLandmarkList);
+
+        // 파일로 저장 / 불러오기 (그리드 크기가 다르거나 랜드마크가 256개보다 많으면 실패)
+        MBOOL Save(const char* inPath) const;
+        MBOOL Load(const char* inPath, const MGrid* inGrid);
+
+        // 랜드마크에서 타일까지 거리 (도달할 수 없다면 INFINITY_DISTANCE)
+        MINT32 GetDistance(MINT32 inLandmark, MINT32 inIndex) const {
+            return DistanceList[(inIndex * GetLandmarkCount()) + inLandmark];
+        }
+
+        // 두 타일 사이 거리의 하한
+        MINT32 GetHeuristic(MINT32 inIndex, MINT32 inGoalIndex) const;
+
+        MINT32 GetLandmarkCount() const {
+            return static_cast<MINT32>(LandmarkList.size());
+        }
+
+        const std::vector<MIntPoint>& GetLandmarkList() const {
+            return LandmarkList;
+        }
+
+        const MGrid* GetGrid() const {
+            return Grid;
+        }
+
+    protected:
+        // 랜드마크 하나의 거리 계산
+        void BuildDistance(MINT32 inLandmark);
+
+        // 랜드마크 범위의 거리 계산 (스레드별 처리)
+        void BuildDistanceRange(MINT32 inStart, MINT32 inEnd);
+
+    protected:
+        // 대상 그리드
+        const MGrid* Grid = nullptr;
+
+        // 계산에 사용할 스레드 수
+        MINT32 ThreadCount = 1;
+
+        // 랜드마크 위치
+        std::vector<MIntPoint> LandmarkList;
+
+        // 타일별 랜드마크 거리 (타일 인덱스 * 랜드마크 수 + 랜드마크)
+        // 검색중에 한 타일의 값을 한번에 읽으므로 타일 단위로 모아둔다
+        std::vector<MINT32> DistanceList;
+    };
+};
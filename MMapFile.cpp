@@ -0,0 +1,420 @@
+﻿#include "MMapFile.h"
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include <utility>
+#include <algorithm>
+
+#if defined(_WIN32)
+    #define WIN32_LEAN_AND_MEAN
+    #define NOMINMAX
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+#endif
+
+
+namespace MAstar
+{
+    namespace
+    {
+        // 레이어 데이터 정렬 단위
+        const MUINT64 LayerAlignment = 64;
+
+        // CRC32 테이블
+        struct MChecksumTable
+        {
+        public:
+            MChecksumTable()
+            {
+                for (MUINT32 i = 0; i < 256; ++i)
+                {
+                    MUINT32 value = i;
+                    for (MINT32 bit = 0; bit < 8; ++bit) {
+                        value = (0 != (value & 1)) ? (0xEDB88320u ^ (value >> 1)) : (value >> 1);
+                    }
+
+                    ValueList[i] = value;
+                }
+            }
+
+        public:
+            MUINT32 ValueList[256];
+        };
+
+        MUINT64 AlignOffset(MUINT64 inOffset)
+        {
+            return (inOffset + (LayerAlignment - 1)) & ~(LayerAlignment - 1);
+        }
+    }
+
+    MMapFile::MMapFile()
+    {
+
+    }
+
+    MMapFile::~MMapFile()
+    {
+        Close();
+    }
+
+    MBOOL MMapFile::Save(const char* inPath, const MBitGrid& inGrid, const MClearanceMap* inClearanceMap)
+    {
+        const MUINT64 tileCount = static_cast<MUINT64>(inGrid.TileCount.X) * inGrid.TileCount.Y;
+
+        // 레이어 구성
+        std::vector<MMapLayerInfo> layerList;
+        std::vector<const void*> layerDataList;
+        {
+            MMapLayerInfo layer;
+            layer.Type = static_cast<MUINT32>(MMapLayerType::BitGrid);
+            layer.Size = inGrid.GetBlockCount() * sizeof(MUINT64);
+            layerList.push_back(layer);
+            layerDataList.push_back(inGrid.GetBlockData());
+        }
+
+        if (nullptr != inClearanceMap)
+        {
+            // 같은 크기의 그리드로 만든 정보만 저장
+            const MGrid* grid = inClearanceMap->GetGrid();
+            if (nullptr == grid || grid->TileCount.X != inGrid.TileCount.X || grid->TileCount.Y != inGrid.TileCount.Y) {
+                return MFALSE;
+            }
+
+            MMapLayerInfo layer;
+            layer.Type = static_cast<MUINT32>(MMapLayerType::Clearance);
+            layer.Param = static_cast<MUINT32>(inClearanceMap->GetMaxClearance());
+            layer.Size = tileCount;
+            layerList.push_back(layer);
+            layerDataList.push_back(inClearanceMap->GetClearanceData());
+        }
+
+        // 위치 / 체크섬 계산
+        MUINT64 offset = sizeof(MMapFileHeader) + (sizeof(MMapLayerInfo) * layerList.size());
+        for (size_t i = 0; i < layerList.size(); ++i)
+        {
+            offset = AlignOffset(offset);
+
+            layerList[i].Offset = offset;
+            layerList[i].DataChecksum = GetChecksum(layerDataList[i], static_cast<size_t>(layerList[i].Size));
+
+            offset += layerList[i].Size;
+        }
+
+        MMapFileHeader header;
+        header.TileCountX = inGrid.TileCount.X;
+        header.TileCountY = inGrid.TileCount.Y;
+        header.LayerCount = static_cast<MUINT32>(layerList.size());
+        header.HeaderChecksum = GetChecksum(&header, sizeof(header));
+        header.HeaderChecksum = GetChecksum(layerList.data(), sizeof(MMapLayerInfo) * layerList.size(), header.HeaderChecksum);
+
+        // 저장
+        FILE* file = fopen(inPath, "wb");
+        if (nullptr == file) {
+            return MFALSE;
+        }
+
+        MBOOL isSuccess = (1 == fwrite(&header, sizeof(header), 1, file));
+        isSuccess = isSuccess && (layerList.size() == fwrite(layerList.data(), sizeof(MMapLayerInfo), layerList.size(), file));
+
+        // 쓴 위치는 직접 계산한 위치를 따라간다 (정렬 여백은 LayerAlignment보다 작다)
+        const MUINT8 padding[LayerAlignment] = {};
+        MUINT64 position = sizeof(MMapFileHeader) + (sizeof(MMapLayerInfo) * layerList.size());
+
+        for (size_t i = 0; i < layerList.size() && MTRUE == isSuccess; ++i)
+        {
+            const size_t paddingSize = static_cast<size_t>(layerList[i].Offset - position);
+            if (0 < paddingSize) {
+                isSuccess = (1 == fwrite(padding, paddingSize, 1, file));
+            }
+
+            if (0 < layerList[i].Size) {
+                isSuccess = isSuccess && (1 == fwrite(layerDataList[i], static_cast<size_t>(layerList[i].Size), 1, file));
+            }
+
+            position = layerList[i].Offset + layerList[i].Size;
+        }
+
+        isSuccess = (0 == fclose(file)) && isSuccess;
+
+        return isSuccess;
+    }
+
+    MBOOL MMapFile::Open(const char* inPath, MBOOL inVerifyData)
+    {
+        Close();
+
+#if defined(_WIN32)
+        HANDLE file = CreateFileA(inPath, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (INVALID_HANDLE_VALUE == file) {
+            return MFALSE;
+        }
+
+        LARGE_INTEGER fileSize;
+        if (FALSE == GetFileSizeEx(file, &fileSize) || 0 == fileSize.QuadPart)
+        {
+            CloseHandle(file);
+            return MFALSE;
+        }
+
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (nullptr == mapping)
+        {
+            CloseHandle(file);
+            return MFALSE;
+        }
+
+        const void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        if (nullptr == data)
+        {
+            CloseHandle(mapping);
+            CloseHandle(file);
+            return MFALSE;
+        }
+
+        FileHandle = file;
+        MappingHandle = mapping;
+        Size = static_cast<size_t>(fileSize.QuadPart);
+#else
+        const MINT32 file = open(inPath, O_RDONLY);
+        if (file < 0) {
+            return MFALSE;
+        }
+
+        struct stat fileStat;
+        if (0 != fstat(file, &fileStat) || 0 == fileStat.st_size)
+        {
+            close(file);
+            return MFALSE;
+        }
+
+        void* data = mmap(nullptr, static_cast<size_t>(fileStat.st_size), PROT_READ, MAP_SHARED, file, 0);
+        if (MAP_FAILED == data)
+        {
+            close(file);
+            return MFALSE;
+        }
+
+        FileHandle = file;
+        Size = static_cast<size_t>(fileStat.st_size);
+#endif
+
+        Data = static_cast<const MUINT8*>(data);
+
+        if (MFALSE == Validate(inVerifyData))
+        {
+            Close();
+            return MFALSE;
+        }
+
+        return MTRUE;
+    }
+
+    void MMapFile::Close()
+    {
+#if defined(_WIN32)
+        if (nullptr != Data) {
+            UnmapViewOfFile(Data);
+        }
+
+        if (nullptr != MappingHandle) {
+            CloseHandle(MappingHandle);
+        }
+
+        if (nullptr != FileHandle) {
+            CloseHandle(FileHandle);
+        }
+
+        MappingHandle = nullptr;
+        FileHandle = nullptr;
+#else
+        if (nullptr != Data) {
+            munmap(const_cast<MUINT8*>(Data), Size);
+        }
+
+        if (0 <= FileHandle) {
+            close(FileHandle);
+        }
+
+        FileHandle = -1;
+#endif
+
+        Data = nullptr;
+        Size = 0;
+    }
+
+    const MMapFileHeader* MMapFile::GetHeader() const
+    {
+        return reinterpret_cast<const MMapFileHeader*>(Data);
+    }
+
+    const MMapLayerInfo* MMapFile::FindLayer(MMapLayerType inType) const
+    {
+        if (nullptr == Data) {
+            return nullptr;
+        }
+
+        const MMapLayerInfo* layerList = reinterpret_cast<const MMapLayerInfo*>(Data + sizeof(MMapFileHeader));
+        for (MUINT32 i = 0; i < GetHeader()->LayerCount; ++i)
+        {
+            if (static_cast<MUINT32>(inType) == layerList[i].Type) {
+                return &layerList[i];
+            }
+        }
+
+        return nullptr;
+    }
+
+    MBOOL MMapFile::GetBitGrid(MBitGrid& outGrid) const
+    {
+        const MMapLayerInfo* layer = FindLayer(MMapLayerType::BitGrid);
+        if (nullptr == layer) {
+            return MFALSE;
+        }
+
+        const MMapFileHeader* header = GetHeader();
+        outGrid.SetView(MIntSize(header->TileCountX, header->TileCountY), static_cast<const MUINT64*>(GetLayerData(layer)));
+
+        return MTRUE;
+    }
+
+    MBOOL MMapFile::GetGrid(MGrid& outGrid) const
+    {
+        MBitGrid bitGrid;
+        if (MFALSE == GetBitGrid(bitGrid)) {
+            return MFALSE;
+        }
+
+        // 이동 비용은 저장하지 않으므로 기본값
+        outGrid.TileList.clear();
+        bitGrid.ToGrid(outGrid);
+
+        return MTRUE;
+    }
+
+    MBOOL MMapFile::GetClearanceMap(const MGrid* inGrid, MClearanceMap& outClearanceMap) const
+    {
+        const MMapLayerInfo* layer = FindLayer(MMapLayerType::Clearance);
+        if (nullptr == layer) {
+            return MFALSE;
+        }
+
+        const MMapFileHeader* header = GetHeader();
+        if (nullptr == inGrid || inGrid->TileCount.X != header->TileCountX || inGrid->TileCount.Y != header->TileCountY) {
+            return MFALSE;
+        }
+
+        outClearanceMap.SetView(inGrid, static_cast<MINT32>(layer->Param), static_cast<const MUINT8*>(GetLayerData(layer)));
+
+        return MTRUE;
+    }
+
+    MUINT32 MMapFile::GetChecksum(const void* inData, size_t inSize, MUINT32 inChecksum)
+    {
+        static const MChecksumTable table;
+
+        const MUINT8* data = static_cast<const MUINT8*>(inData);
+
+        MUINT32 checksum = ~inChecksum;
+        for (size_t i = 0; i < inSize; ++i) {
+            checksum = table.ValueList[(checksum ^ data[i]) & 0xFF] ^ (checksum >> 8);
+        }
+
+        return ~checksum;
+    }
+
+    MBOOL MMapFile::Validate(MBOOL inVerifyData) const
+    {
+        // 헤더
+        if (Size < sizeof(MMapFileHeader)) {
+            return MFALSE;
+        }
+
+        MMapFileHeader header = *GetHeader();
+        if (MMAP_FILE_MAGIC != header.Magic || MMAP_FILE_VERSION != header.Version) {
+            return MFALSE;
+        }
+
+        if (header.TileCountX < 0 || header.TileCountY < 0) {
+            return MFALSE;
+        }
+
+        // 레이어 정보 목록까지 체크섬 검사
+        const MUINT64 layerListSize = static_cast<MUINT64>(sizeof(MMapLayerInfo)) * header.LayerCount;
+        if (Size - sizeof(MMapFileHeader) < layerListSize) {
+            return MFALSE;
+        }
+
+        const MUINT32 headerChecksum = header.HeaderChecksum;
+        header.HeaderChecksum = 0;
+
+        MUINT32 checksum = GetChecksum(&header, sizeof(header));
+        checksum = GetChecksum(Data + sizeof(MMapFileHeader), static_cast<size_t>(layerListSize), checksum);
+        if (checksum != headerChecksum) {
+            return MFALSE;
+        }
+
+        // 레이어 범위 / 크기 검사
+        const MUINT64 tileCount = static_cast<MUINT64>(header.TileCountX) * header.TileCountY;
+        const MUINT64 blockCount = static_cast<MUINT64>((header.TileCountX + 7) / 8) * ((header.TileCountY + 7) / 8);
+
+        const MMapLayerInfo* layerList = reinterpret_cast<const MMapLayerInfo*>(Data + sizeof(MMapFileHeader));
+        MBOOL hasBitGrid = MFALSE;
+
+        // 레이어 데이터는 레이어 정보 목록 뒤에서 시작해야 한다
+        const MUINT64 dataOffset = sizeof(MMapFileHeader) + layerListSize;
+
+        // 겹침 검사용 레이어 범위 (시작, 끝)
+        std::vector<std::pair<MUINT64, MUINT64>> rangeList;
+        rangeList.reserve(header.LayerCount);
+
+        for (MUINT32 i = 0; i < header.LayerCount; ++i)
+        {
+            const MMapLayerInfo& layer = layerList[i];
+            if (0 != (layer.Offset % LayerAlignment) || layer.Offset < dataOffset || Size < layer.Offset || Size - layer.Offset < layer.Size) {
+                return MFALSE;
+            }
+
+            rangeList.emplace_back(layer.Offset, layer.Offset + layer.Size);
+
+            switch (static_cast<MMapLayerType>(layer.Type))
+            {
+            case MMapLayerType::BitGrid:
+                if (blockCount * sizeof(MUINT64) != layer.Size) {
+                    return MFALSE;
+                }
+                hasBitGrid = MTRUE;
+                break;
+
+            case MMapLayerType::Clearance:
+                if (tileCount != layer.Size) {
+                    return MFALSE;
+                }
+                break;
+
+            default:
+                // 모르는 레이어는 무시
+                break;
+            }
+
+            if (MTRUE == inVerifyData && layer.DataChecksum != GetChecksum(Data + layer.Offset, static_cast<size_t>(layer.Size))) {
+                return MFALSE;
+            }
+        }
+
+        // 시작 위치 순서로 정렬해서 이전 레이어의 끝이 다음 레이어의 시작을 넘으면 겹친다
+        std::sort(rangeList.begin(), rangeList.end());
+        for (size_t i = 1; i < rangeList.size(); ++i)
+        {
+            if (rangeList[i].first < rangeList[i - 1].second) {
+                return MFALSE;
+            }
+        }
+
+        return hasBitGrid;
+    }
+};
@@ -0,0 +1,136 @@
+﻿#pragma once
+
+#include "MPrerequisites.h"
+#include "MType.h"
+#include "MBitGrid.h"
+#include "MClearance.h"
+
+
+
+#define MMAP_FILE_MAGIC (0x4452474D)    // "MGRD"
+#define MMAP_FILE_VERSION (1)
+
+namespace MAstar
+{
+    //----------------------------------------------------------------------
+    // 맵 파일 레이어 종류
+    //----------------------------------------------------------------------
+    enum class MMapLayerType : MUINT32
+    {
+        BitGrid = 1,        // MBitGrid 블럭 데이터 (필수)
+        Clearance = 2,      // 타일별 여유 공간 (MUINT8, Param은 최대값)
+    };
+
+    //----------------------------------------------------------------------
+    // 맵 파일 헤더 (리틀 엔디안 고정 크기)
+    // 파일 구성 : 헤더 -> 레이어 정보 목록 -> 레이어 데이터 (64바이트 정렬)
+    //----------------------------------------------------------------------
+    struct MMapFileHeader
+    {
+    public:
+        MUINT32 Magic = MMAP_FILE_MAGIC;
+        MUINT32 Version = MMAP_FILE_VERSION;
+
+        // 타일 카운트
+        MINT32 TileCountX = 0;
+        MINT32 TileCountY = 0;
+
+        // 레이어 수
+        MUINT32 LayerCount = 0;
+
+        // 헤더 + 레이어 정보 목록의 체크섬 (이 값을 0으로 두고 계산)
+        MUINT32 HeaderChecksum = 0;
+    };
+
+    struct MMapLayerInfo
+    {
+    public:
+        // 레이어 종류 (MMapLayerType)
+        MUINT32 Type = 0;
+
+        // 레이어별 추가 정보
+        MUINT32 Param = 0;
+
+        // 파일 시작에서의 위치 / 크기
+        MUINT64 Offset = 0;
+        MUINT64 Size = 0;
+
+        // 데이터 체크섬
+        MUINT32 DataChecksum = 0;
+        MUINT32 Reserved = 0;
+    };
+
+    static_assert(24 == sizeof(MMapFileHeader), "MMapFileHeader size must not change");
+    static_assert(32 == sizeof(MMapLayerInfo), "MMapLayerInfo size must not change");
+
+
+    //----------------------------------------------------------------------
+    // 메모리 맵 방식의 맵 파일
+    // 읽기 전용으로 매핑하므로 같은 파일을 여는 프로세스끼리 메모리를 공유하고
+    // MBitGrid / 여유 공간 정보는 매핑된 데이터를 복사 없이 바로 사용한다
+    // MGrid는 타일 구조체 배열이라 연결할 수 없으므로 막힘 정보를 복사해서 만든다 (타일 수에 비례)
+    //----------------------------------------------------------------------
+    class MMapFile
+    {
+    public:
+        MMapFile();
+        ~MMapFile();
+
+        MMapFile(const MMapFile&) = delete;
+        MMapFile& operator=(const MMapFile&) = delete;
+
+    public:
+        // 파일로 저장 (여유 공간 정보는 선택)
+        static MBOOL Save(const char* inPath, const MBitGrid& inGrid, const MClearanceMap* inClearanceMap = nullptr);
+
+        // 파일 열기 (헤더 체크섬은 항상 검사, inVerifyData면 레이어 데이터 체크섬도 검사)
+        MBOOL Open(const char* inPath, MBOOL inVerifyData = MFALSE);
+
+        // 파일 닫기 (연결해둔 그리드는 더이상 사용할 수 없다)
+        void Close();
+
+        MBOOL IsOpen() const {
+            return nullptr != Data;
+        }
+
+    public:
+        const MMapFileHeader* GetHeader() const;
+
+        // 레이어 정보 (없다면 nullptr)
+        const MMapLayerInfo* FindLayer(MMapLayerType inType) const;
+
+        // 레이어 데이터
+        const void* GetLayerData(const MMapLayerInfo* inLayer) const {
+            return Data + inLayer->Offset;
+        }
+
+        // 그리드를 매핑된 데이터에 연결
+        MBOOL GetBitGrid(MBitGrid& outGrid) const;
+
+        // 막힘 정보로 MGrid를 만든다 (복사)
+        MBOOL GetGrid(MGrid& outGrid) const;
+
+        // 여유 공간 정보를 매핑된 데이터에 연결 (inGrid는 파일과 같은 크기여야 한다, 레이어가 없다면 MFALSE)
+        MBOOL GetClearanceMap(const MGrid* inGrid, MClearanceMap& outClearanceMap) const;
+
+        // 체크섬 (CRC32)
+        static MUINT32 GetChecksum(const void* inData, size_t inSize, MUINT32 inChecksum = 0);
+
+    protected:
+        // 헤더 / 레이어 검사
+        MBOOL Validate(MBOOL inVerifyData) const;
+
+    protected:
+        // 매핑된 데이터
+        const MUINT8* Data = nullptr;
+        size_t Size = 0;
+
+        // 파일 핸들
+#if defined(_WIN32)
+        void* FileHandle = nullptr;
+        void* MappingHandle = nullptr;
+#else
+        MINT32 FileHandle = -1;
+#endif
+    };
+};
@@ -0,0 +1,196 @@
+﻿#include "MPathBatch.h"
+
+
+namespace MAstar
+{
+    MPathBatchSolver::MPathBatchSolver(MINT32 inThreadCount)
+        : RemainCount(0)
+    {
+        MINT32 threadCount = inThreadCount;
+        if (threadCount <= 0) {
+            threadCount = static_cast<MINT32>(std::thread::hardware_concurrency());
+        }
+        threadCount = std::max(threadCount, 1);
+
+        for (MINT32 i = 0; i < threadCount; ++i) {
+            WorkerList.push_back(std::unique_ptr<MWorker>(new MWorker()));
+        }
+
+        // 0번은 호출 스레드
+        for (MINT32 i = 1; i < threadCount; ++i) {
+            WorkerList[i]->Thread = std::thread(&MPathBatchSolver::WorkerLoop, this, i);
+        }
+    }
+
+    MPathBatchSolver::~MPathBatchSolver()
+    {
+        {
+            std::lock_guard<std::mutex> lock(BatchMutex);
+            IsExit = MTRUE;
+        }
+        BatchCondition.notify_all();
+
+        for (auto& worker : WorkerList)
+        {
+            if (MTRUE == worker->Thread.joinable()) {
+                worker->Thread.join();
+            }
+        }
+    }
+
+    void MPathBatchSolver::Solve(std::vector<MPathResult>& outResultList, const MGrid* inGrid, const std::vector<MPathQuery>& inQueryList, const MVector2& inGridPos, MFLOAT inTileSize)
+    {
+        const MINT32 queryCount = static_cast<MINT32>(inQueryList.size());
+        outResultList.resize(queryCount);
+
+        if (0 == queryCount) {
+            return;
+        }
+
+        // 요청 정보 설정 (작업 큐에 넣기 전에 설정해야 한다)
+        Grid = inGrid;
+        QueryList = &inQueryList;
+        ResultList = &outResultList;
+        GridPos = inGridPos;
+        TileSize = inTileSize;
+        RemainCount.store(queryCount);
+
+        // 연속된 요청끼리 같은 스레드에 나눠준다
+        const MINT32 workerCount = GetThreadCount();
+        for (MINT32 i = 0; i < workerCount; ++i)
+        {
+            const MINT32 beginIndex = (queryCount * i) / workerCount;
+            const MINT32 endIndex = (queryCount * (i + 1)) / workerCount;
+
+            MWorker& worker = *WorkerList[i];
+            std::lock_guard<std::mutex> lock(worker.TaskMutex);
+            for (MINT32 queryIndex = beginIndex; queryIndex < endIndex; ++queryIndex) {
+                worker.TaskList.push_back(queryIndex);
+            }
+        }
+
+        // 작업 시작
+        {
+            std::lock_guard<std::mutex> lock(BatchMutex);
+            ++BatchIndex;
+        }
+        BatchCondition.notify_all();
+
+        // 호출 스레드도 같이 처리
+        RunTask(0);
+
+        // 모두 끝날때까지 대기
+        std::unique_lock<std::mutex> lock(BatchMutex);
+        DoneCondition.wait(lock, [this]() {
+            return 0 == RemainCount.load();
+        });
+    }
+
+    void MPathBatchSolver::SetPathEngine(MPathEngine inEngine)
+    {
+        for (auto& worker : WorkerList) {
+            worker->PathFinder.SetPathEngine(inEngine);
+        }
+    }
+
+    void MPathBatchSolver::SetPathCache(MPathCache* inPathCache)
+    {
+        for (auto& worker : WorkerList) {
+            worker->PathFinder.SetPathCache(inPathCache);
+        }
+    }
+
+    void MPathBatchSolver::WorkerLoop(MINT32 inWorkerIndex)
+    {
+        MUINT64 lastBatchIndex = 0;
+
+        while (MTRUE)
+        {
+            {
+                std::unique_lock<std::mutex> lock(BatchMutex);
+                BatchCondition.wait(lock, [this, lastBatchIndex]() {
+                    return MTRUE == IsExit || lastBatchIndex != BatchIndex;
+                });
+
+                if (MTRUE == IsExit) {
+                    return;
+                }
+
+                lastBatchIndex = BatchIndex;
+            }
+
+            RunTask(inWorkerIndex);
+        }
+    }
+
+    void MPathBatchSolver::RunTask(MINT32 inWorkerIndex)
+    {
+        MPathFinder& pathFinder = WorkerList[inWorkerIndex]->PathFinder;
+
+        while (MTRUE)
+        {
+            MINT32 queryIndex = PopTask(inWorkerIndex);
+            if (queryIndex < 0)
+            {
+                queryIndex = StealTask(inWorkerIndex);
+                if (queryIndex < 0) {
+                    break;
+                }
+            }
+
+            const MPathQuery& query = (*QueryList)[queryIndex];
+            MPathResult& result = (*ResultList)[queryIndex];
+
+            if (MTRUE == query.IsPositionQuery) {
+                pathFinder.FindPath(result.PositionList, GridPos, TileSize, Grid, query.StartPos, query.EndPos, query.Radius);
+            }
+            else {
+                pathFinder.FindPath(result.Index2DList, Grid, query.StartIndex2D, query.EndIndex2D);
+            }
+
+            // 마지막 요청이라면 대기중인 호출 스레드를 깨운다
+            if (1 == RemainCount.fetch_sub(1))
+            {
+                std::lock_guard<std::mutex> lock(BatchMutex);
+                DoneCondition.notify_all();
+            }
+        }
+    }
+
+    MINT32 MPathBatchSolver::PopTask(MINT32 inWorkerIndex)
+    {
+        MWorker& worker = *WorkerList[inWorkerIndex];
+        std::lock_guard<std::mutex> lock(worker.TaskMutex);
+
+        if (MTRUE == worker.TaskList.empty()) {
+            return -1;
+        }
+
+        // 자신의 작업은 앞에서부터 (연속된 요청이 캐시를 공유하도록)
+        const MINT32 queryIndex = worker.TaskList.front();
+        worker.TaskList.pop_front();
+        return queryIndex;
+    }
+
+    MINT32 MPathBatchSolver::StealTask(MINT32 inWorkerIndex)
+    {
+        const MINT32 workerCount = GetThreadCount();
+
+        for (MINT32 i = 1; i < workerCount; ++i)
+        {
+            MWorker& worker = *WorkerList[(inWorkerIndex + i) % workerCount];
+            std::lock_guard<std::mutex> lock(worker.TaskMutex);
+
+            if (MTRUE == worker.TaskList.empty()) {
+                continue;
+            }
+
+            // 다른 스레드의 작업은 뒤에서부터 가져온다
+            const MINT32 queryIndex = worker.TaskList.back();
+            worker.TaskList.pop_back();
+            return queryIndex;
+        }
+
+        return -1;
+    }
+};
@@ -0,0 +1,125 @@
+﻿#pragma once
+
+#include <vector>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+
+#include "MPrerequisites.h"
+#include "MType.h"
+#include "MVector.h"
+#include "MAstar.h"
+
+
+namespace MAstar
+{
+    //----------------------------------------------------------------------
+    // 경로 요청
+    //----------------------------------------------------------------------
+    struct MPathQuery
+    {
+    public:
+        // 위치 기준 요청인지 (MFALSE라면 인덱스 기준)
+        MBOOL IsPositionQuery = MFALSE;
+
+        // 인덱스 기준
+        MIntPoint StartIndex2D;
+        MIntPoint EndIndex2D;
+
+        // 위치 기준
+        MVector2 StartPos;
+        MVector2 EndPos;
+        MFLOAT Radius = 0;
+    };
+
+    //----------------------------------------------------------------------
+    // 경로 결과 (요청 종류에 맞는 리스트만 채워진다)
+    //----------------------------------------------------------------------
+    struct MPathResult
+    {
+    public:
+        std::vector<MIntPoint> Index2DList;
+        std::vector<MVector2> PositionList;
+    };
+
+
+    //----------------------------------------------------------------------
+    // 여러 경로 요청을 작업 스레드에서 나눠서 처리
+    // 스레드마다 별도의 MPathFinder를 사용하고 남는 스레드는 다른 스레드의 작업을 가져간다
+    // 그리드는 처리중에 읽기만 하므로 변경하면 안된다
+    //----------------------------------------------------------------------
+    class MPathBatchSolver
+    {
+    public:
+        // 스레드 수 (호출 스레드 포함, 0이라면 하드웨어 스레드 수)
+        MPathBatchSolver(MINT32 inThreadCount = 0);
+        ~MPathBatchSolver();
+
+    public:
+        // 요청을 모두 처리한다 (결과는 요청과 같은 순서)
+        void Solve(std::vector<MPathResult>& outResultList, const MGrid* inGrid, const std::vector<MPathQuery>& inQueryList, const MVector2& inGridPos = MVector2(), MFLOAT inTileSize = 1.0f);
+
+        // 모든 스레드의 검색 방식 설정
+        void SetPathEngine(MPathEngine inEngine);
+
+        // 모든 스레드가 함께 사용할 경로 저장소 설정
+        void SetPathCache(MPathCache* inPathCache);
+
+        MINT32 GetThreadCount() const {
+            return static_cast<MINT32>(WorkerList.size());
+        }
+
+    protected:
+        //--------------------------------------------------------------
+        // 작업 스레드
+        //--------------------------------------------------------------
+        struct MWorker
+        {
+        public:
+            std::thread Thread;
+
+            // 처리할 요청 인덱스
+            std::mutex TaskMutex;
+            std::deque<MINT32> TaskList;
+
+            // 스레드 전용 검색 정보
+            MPathFinder PathFinder;
+        };
+
+    protected:
+        // 작업 스레드 루프
+        void WorkerLoop(MINT32 inWorkerIndex);
+
+        // 작업이 없을때까지 처리 (자신의 작업이 없다면 다른 스레드의 작업을 가져온다)
+        void RunTask(MINT32 inWorkerIndex);
+
+        // 작업을 하나 가져온다 (없다면 -1)
+        MINT32 PopTask(MINT32 inWorkerIndex);
+        MINT32 StealTask(MINT32 inWorkerIndex);
+
+    protected:
+        // 0번은 호출 스레드가 사용
+        std::vector<std::unique_ptr<MWorker>> WorkerList;
+
+        // 작업 시작 / 종료 알림
+        std::mutex BatchMutex;
+        std::condition_variable BatchCondition;
+        std::condition_variable DoneCondition;
+
+        MUINT64 BatchIndex = 0;
+        MBOOL IsExit = MFALSE;
+
+        // 남은 요청 수
+        std::atomic<MINT32> RemainCount;
+
+        // 처리중인 요청 정보
+        const MGrid* Grid = nullptr;
+        const std::vector<MPathQuery>* QueryList = nullptr;
+        std::vector<MPathResult>* ResultList = nullptr;
+        MVector2 GridPos;
+        MFLOAT TileSize = 1.0f;
+    };
+};
@@ -0,0 +1,433 @@
+﻿#include "MPathCache.h"
+
+#include <mutex>
+
+
+namespace MAstar
+{
+    namespace
+    {
+        // 버킷 크기 (타일 수)
+        const MINT32 CacheBucketSize = 16;
+
+        // 범위 하나로 묶을 경로 타일 수
+        const MINT32 RegionPointCount = 8;
+
+        // 뒤쪽 경로를 찾을때 확인할 최대 경로 수 (최근에 추가된 경로부터)
+        const MINT32 MaxSuffixCandidateCount = 8;
+
+        // 막힌 타일의 비교용 비용 (어떤 이동 비용보다 크다)
+        const MUINT16 BlockedTileCost = 0xFFFF;
+    }
+
+    size_t MPathCacheKeyHash::operator()(const MPathCacheKey& inKey) const
+    {
+        MUINT64 hash = static_cast<MUINT32>(inKey.StartIndex);
+        hash = (hash * 0x9E3779B97F4A7C15ULL) ^ static_cast<MUINT32>(inKey.EndIndex);
+        hash = (hash * 0x9E3779B97F4A7C15ULL) ^ ((static_cast<MUINT64>(inKey.Option) << 16) | static_cast<MUINT32>(inKey.Clearance));
+        hash = (hash * 0x9E3779B97F4A7C15ULL) ^ static_cast<MUINT64>(inKey.Radius * 1024.0f);
+
+        return static_cast<size_t>(hash ^ (hash >> 32));
+    }
+
+    MPathCache::MPathCache()
+        : Version(0), UseTick(0), HitCount(0), SuffixHitCount(0), MissCount(0), InvalidateCount(0)
+    {
+
+    }
+
+    MPathCache::~MPathCache()
+    {
+
+    }
+
+    void MPathCache::SetCapacity(MINT32 inMaxPathCount, MINT32 inMaxPointCount)
+    {
+        MaxPathCount = std::max(inMaxPathCount, 1);
+        MaxPointCount = std::max(inMaxPointCount, 1);
+    }
+
+    void MPathCache::Reset(const MGrid* inGrid)
+    {
+        std::unique_lock<std::shared_mutex> lock(Mutex);
+
+        Grid = inGrid;
+
+        TileCostList.resize(Grid->TileList.size());
+        for (size_t i = 0; i < Grid->TileList.size(); ++i) {
+            TileCostList[i] = GetTileCost(Grid->TileList[i]);
+        }
+
+        EntryList.clear();
+        EntryList.resize(MaxPathCount);
+
+        FreeSlotList.clear();
+        for (MINT32 i = MaxPathCount - 1; 0 <= i; --i) {
+            FreeSlotList.push_back(i);
+        }
+
+        UseTickList.reset(new std::atomic<MUINT64>[MaxPathCount]);
+        for (MINT32 i = 0; i < MaxPathCount; ++i) {
+            UseTickList[i].store(0);
+        }
+
+        HeadSlot = -1;
+        TailSlot = -1;
+        PointCount = 0;
+
+        KeyMap.clear();
+        GoalMap.clear();
+
+        BucketCount = MIntSize((Grid->TileCount.X + CacheBucketSize - 1) / CacheBucketSize, (Grid->TileCount.Y + CacheBucketSize - 1) / CacheBucketSize);
+        BucketList.clear();
+        BucketList.resize(BucketCount.X * BucketCount.Y);
+
+        ++Version;
+        UseTick.store(0);
+        HitCount.store(0);
+        SuffixHitCount.store(0);
+        MissCount.store(0);
+        InvalidateCount.store(0);
+    }
+
+    void MPathCache::Clear()
+    {
+        std::unique_lock<std::shared_mutex> lock(Mutex);
+
+        RemoveAllEntry();
+
+        ++Version;
+    }
+
+    void MPathCache::UpdateTiles(const std::vector<MIntPoint>& inChangedList)
+    {
+        std::unique_lock<std::shared_mutex> lock(Mutex);
+
+        // 이전 버전으로 검색중인 경로는 저장하지 않는다
+        ++Version;
+
+        //----------------------------------------------------------------
+        // 열리거나 비용이 줄어든 타일은 지나가지 않던 경로도 짧게 만들 수 있으므로
+        // 저장된 경로가 최단 경로라는 보장이 깨진다 (모두 제거)
+        //----------------------------------------------------------------
+        MBOOL isCostDecrease = MFALSE;
+        for (const MIntPoint& index2D : inChangedList)
+        {
+            if (index2D.X < 0 || Grid->TileCount.X <= index2D.X || index2D.Y < 0 || Grid->TileCount.Y <= index2D.Y) {
+                continue;
+            }
+
+            const MINT32 index = Grid->GetTileIndex(index2D);
+            const MUINT16 cost = GetTileCost(Grid->TileList[index]);
+            if (cost < TileCostList[index]) {
+                isCostDecrease = MTRUE;
+            }
+
+            TileCostList[index] = cost;
+        }
+
+        if (MTRUE == isCostDecrease)
+        {
+            InvalidateCount += KeyMap.size();
+            RemoveAllEntry();
+            return;
+        }
+
+        // 막히거나 비용이 늘어난 타일은 그 주변을 지나는 경로만 영향을 받는다
+        std::vector<MINT32> slotList;
+        for (const MIntPoint& index2D : inChangedList)
+        {
+            if (index2D.X < 0 || Grid->TileCount.X <= index2D.X || index2D.Y < 0 || Grid->TileCount.Y <= index2D.Y) {
+                continue;
+            }
+
+            // 제거하면 버킷 목록이 바뀌므로 복사해서 확인
+            slotList = BucketList[((index2D.Y / CacheBucketSize) * BucketCount.X) + (index2D.X / CacheBucketSize)];
+
+            for (const MINT32 slot : slotList)
+            {
+                const MEntry& entry = EntryList[slot];
+                if (MFALSE == entry.IsUsed) {
+                    continue;
+                }
+
+                for (const MRegion& region : entry.RegionList)
+                {
+                    if (region.Min.X <= index2D.X && index2D.X <= region.Max.X && region.Min.Y <= index2D.Y && index2D.Y <= region.Max.Y)
+                    {
+                        RemoveEntry(slot);
+                        ++InvalidateCount;
+                        break;
+                    }
+                }
+            }
+        }
+    }
+
+    MBOOL MPathCache::FindPath(const MPathCacheKey& inKey, const MIntPoint& inStartIndex2D, std::vector<MIntPoint>& outList) const
+    {
+        std::shared_lock<std::shared_mutex> lock(Mutex);
+
+        const MIntPoint* begin = nullptr;
+        const MIntPoint* end = nullptr;
+        if (MFALSE == FindRange(inKey, inStartIndex2D, begin, end)) {
+            return MFALSE;
+        }
+
+        outList.assign(begin, end);
+        return MTRUE;
+    }
+
+    MBOOL MPathCache::FindRange(const MPathCacheKey& inKey, const MIntPoint& inStartIndex2D, const MIntPoint*& outBegin, const MIntPoint*& outEnd) const
+    {
+        // 같은 키
+        auto keyIter = KeyMap.find(inKey);
+        if (KeyMap.end() != keyIter)
+        {
+            const MINT32 slot = keyIter->second;
+            UseTickList[slot].store(++UseTick);
+
+            const std::vector<MIntPoint>& pathList = EntryList[slot].PathList;
+            outBegin = pathList.data();
+            outEnd = pathList.data() + pathList.size();
+            ++HitCount;
+            return MTRUE;
+        }
+
+        //----------------------------------------------------------------
+        // 같은 종료 위치로 가는 경로 위에 시작 타일이 있다면 그 뒤쪽 경로를 사용
+        // 최단 경로의 일부분도 최단 경로이므로 검색 결과와 비용이 같다
+        //----------------------------------------------------------------
+        auto goalIter = GoalMap.find(GetGoalKey(inKey));
+        if (GoalMap.end() != goalIter)
+        {
+            const std::vector<MINT32>& slotList = goalIter->second;
+            const MINT32 checkCount = std::min(static_cast<MINT32>(slotList.size()), MaxSuffixCandidateCount);
+
+            for (MINT32 i = 0; i < checkCount; ++i)
+            {
+                const MINT32 slot = slotList[slotList.size() - 1 - i];
+                const std::vector<MIntPoint>& pathList = EntryList[slot].PathList;
+
+                auto startIter = std::find(pathList.begin(), pathList.end(), inStartIndex2D);
+                if (pathList.end() == startIter) {
+                    continue;
+                }
+
+                UseTickList[slot].store(++UseTick);
+
+                outBegin = pathList.data() + (startIter - pathList.begin());
+                outEnd = pathList.data() + pathList.size();
+                ++SuffixHitCount;
+                return MTRUE;
+            }
+        }
+
+        ++MissCount;
+        return MFALSE;
+    }
+
+    void MPathCache::AddPath(const MPathCacheKey& inKey, MUINT32 inVersion, MINT32 inMargin, const MIntPoint* inList, MINT32 inCount)
+    {
+        const MINT32 pointCount = inCount;
+        if (0 == pointCount || MaxPointCount < pointCount) {
+            return;
+        }
+
+        std::unique_lock<std::shared_mutex> lock(Mutex);
+
+        // 검색중에 그리드가 바뀌었거나 다른 스레드가 먼저 추가했다
+        if (inVersion != Version.load() || KeyMap.end() != KeyMap.find(inKey)) {
+            return;
+        }
+
+        ReserveSpace(pointCount);
+
+        const MINT32 slot = FreeSlotList.back();
+        FreeSlotList.pop_back();
+
+        MEntry& entry = EntryList[slot];
+        entry.Key = inKey;
+        entry.PathList.assign(inList, inList + inCount);
+        entry.IsUsed = MTRUE;
+
+        entry.ListTick = ++UseTick;
+        UseTickList[slot].store(entry.ListTick);
+        LinkFront(slot);
+
+        RegisterRegion(slot, inMargin);
+
+        KeyMap[inKey] = slot;
+        GoalMap[GetGoalKey(inKey)].push_back(slot);
+        PointCount += pointCount;
+    }
+
+    const MGrid* MPathCache::GetGrid() const
+    {
+        std::shared_lock<std::shared_mutex> lock(Mutex);
+        return Grid;
+    }
+
+    MINT32 MPathCache::GetPathCount() const
+    {
+        std::shared_lock<std::shared_mutex> lock(Mutex);
+        return static_cast<MINT32>(KeyMap.size());
+    }
+
+    //----------------------------------------------------------------
+    // 읽기는 사용 시간만 기록하므로 리스트 끝의 경로가 그 뒤에 사용되었다면
+    // 앞으로 옮기고 다음 경로를 확인한다
+    //----------------------------------------------------------------
+    void MPathCache::ReserveSpace(MINT32 inPointCount)
+    {
+        while (0 <= TailSlot && (MTRUE == FreeSlotList.empty() || MaxPointCount < PointCount + inPointCount))
+        {
+            const MINT32 slot = TailSlot;
+            const MUINT64 useTick = UseTickList[slot].load();
+
+            if (EntryList[slot].ListTick < useTick)
+            {
+                Unlink(slot);
+                EntryList[slot].ListTick = useTick;
+                LinkFront(slot);
+                continue;
+            }
+
+            RemoveEntry(slot);
+        }
+    }
+
+    void MPathCache::RemoveEntry(MINT32 inSlot)
+    {
+        MEntry& entry = EntryList[inSlot];
+
+        Unlink(inSlot);
+
+        KeyMap.erase(entry.Key);
+
+        auto goalIter = GoalMap.find(GetGoalKey(entry.Key));
+        if (GoalMap.end() != goalIter)
+        {
+            std::vector<MINT32>& slotList = goalIter->second;
+
+            // 최근에 추가된 순서를 유지
+            slotList.erase(std::find(slotList.begin(), slotList.end(), inSlot));
+            if (MTRUE == slotList.empty()) {
+                GoalMap.erase(goalIter);
+            }
+        }
+
+        for (const MINT32 bucketIndex : entry.BucketIndexList)
+        {
+            std::vector<MINT32>& slotList = BucketList[bucketIndex];
+
+            auto slotIter = std::find(slotList.begin(), slotList.end(), inSlot);
+            *slotIter = slotList.back();
+            slotList.pop_back();
+        }
+
+        PointCount -= static_cast<MINT32>(entry.PathList.size());
+
+        entry.PathList.clear();
+        entry.RegionList.clear();
+        entry.BucketIndexList.clear();
+        entry.IsUsed = MFALSE;
+
+        FreeSlotList.push_back(inSlot);
+    }
+
+    void MPathCache::RemoveAllEntry()
+    {
+        while (0 <= HeadSlot) {
+            RemoveEntry(HeadSlot);
+        }
+    }
+
+    MUINT16 MPathCache::GetTileCost(const MTile& inTile)
+    {
+        return (MTRUE == inTile.IsBlocked) ? BlockedTileCost : inTile.MoveCost;
+    }
+
+    void MPathCache::LinkFront(MINT32 inSlot)
+    {
+        MEntry& entry = EntryList[inSlot];
+        entry.PrevSlot = -1;
+        entry.NextSlot = HeadSlot;
+
+        if (0 <= HeadSlot) {
+            EntryList[HeadSlot].PrevSlot = inSlot;
+        }
+        else {
+            TailSlot = inSlot;
+        }
+
+        HeadSlot = inSlot;
+    }
+
+    void MPathCache::Unlink(MINT32 inSlot)
+    {
+        MEntry& entry = EntryList[inSlot];
+
+        if (0 <= entry.PrevSlot) {
+            EntryList[entry.PrevSlot].NextSlot = entry.NextSlot;
+        }
+        else {
+            HeadSlot = entry.NextSlot;
+        }
+
+        if (0 <= entry.NextSlot) {
+            EntryList[entry.NextSlot].PrevSlot = entry.PrevSlot;
+        }
+        else {
+            TailSlot = entry.PrevSlot;
+        }
+
+        entry.PrevSlot = -1;
+        entry.NextSlot = -1;
+    }
+
+    //----------------------------------------------------------------
+    // 연속된 경로 타일을 묶어서 범위를 만든다
+    // 이전 묶음의 마지막 타일부터 시작하므로 직선으로 건너뛰는 경로(Theta*)도 사이 구간이 포함된다
+    //----------------------------------------------------------------
+    void MPathCache::RegisterRegion(MINT32 inSlot, MINT32 inMargin)
+    {
+        MEntry& entry = EntryList[inSlot];
+        const std::vector<MIntPoint>& pathList = entry.PathList;
+        const MINT32 pointCount = static_cast<MINT32>(pathList.size());
+
+        for (MINT32 beginIndex = 0; beginIndex < pointCount; beginIndex += RegionPointCount)
+        {
+            MRegion region;
+            region.Min = pathList[std::max(beginIndex - 1, 0)];
+            region.Max = region.Min;
+
+            const MINT32 endIndex = std::min(beginIndex + RegionPointCount, pointCount);
+            for (MINT32 i = beginIndex; i < endIndex; ++i)
+            {
+                region.Min = MIntPoint(std::min(region.Min.X, pathList[i].X), std::min(region.Min.Y, pathList[i].Y));
+                region.Max = MIntPoint(std::max(region.Max.X, pathList[i].X), std::max(region.Max.Y, pathList[i].Y));
+            }
+
+            region.Min = MIntPoint(std::max(region.Min.X - inMargin, 0), std::max(region.Min.Y - inMargin, 0));
+            region.Max = MIntPoint(std::min(region.Max.X + inMargin, Grid->TileCount.X - 1), std::min(region.Max.Y + inMargin, Grid->TileCount.Y - 1));
+
+            entry.RegionList.push_back(region);
+
+            // 범위가 겹치는 버킷에 등록 (같은 버킷은 한번만)
+            for (MINT32 bucketY = region.Min.Y / CacheBucketSize; bucketY <= region.Max.Y / CacheBucketSize; ++bucketY)
+            {
+                for (MINT32 bucketX = region.Min.X / CacheBucketSize; bucketX <= region.Max.X / CacheBucketSize; ++bucketX)
+                {
+                    const MINT32 bucketIndex = (bucketY * BucketCount.X) + bucketX;
+                    if (entry.BucketIndexList.end() != std::find(entry.BucketIndexList.begin(), entry.BucketIndexList.end(), bucketIndex)) {
+                        continue;
+                    }
+
+                    entry.BucketIndexList.push_back(bucketIndex);
+                    BucketList[bucketIndex].push_back(inSlot);
+                }
+            }
+        }
+    }
+};
@@ -0,0 +1,241 @@
+﻿#pragma once
+
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <shared_mutex>
+#include <unordered_map>
+
+#include "MPrerequisites.h"
+#include "MType.h"
+#include "MAstar.h"
+
+
+namespace MAstar
+{
+    //----------------------------------------------------------------------
+    // 저장된 경로를 찾는 키
+    //----------------------------------------------------------------------
+    struct MPathCacheKey
+    {
+    public:
+        MBOOL operator==(const MPathCacheKey& inKey) const {
+            return StartIndex == inKey.StartIndex && EndIndex == inKey.EndIndex && Clearance == inKey.Clearance && Option == inKey.Option && Radius == inKey.Radius;
+        }
+
+    public:
+        // 시작 / 종료 타일 인덱스 (같은 종료 위치의 경로 목록은 시작을 -1로 사용)
+        MINT32 StartIndex = -1;
+        MINT32 EndIndex = -1;
+
+        // 필요한 여유 공간
+        MINT32 Clearance = 0;
+
+        // 검색 방식 (같은 방식의 경로만 공유)
+        MUINT32 Option = 0;
+
+        // 타일 크기 기준 반지름 (검색중에 직선 체크를 하는 Theta*만 사용, 그 외는 0)
+        MFLOAT Radius = 0;
+    };
+
+    struct MPathCacheKeyHash
+    {
+    public:
+        size_t operator()(const MPathCacheKey& inKey) const;
+    };
+
+
+    //----------------------------------------------------------------------
+    // 타일 경로 저장소 (LRU)
+    // 시작 / 종료 타일과 검색 조건이 같은 요청은 저장된 경로를 바로 사용하고
+    // 시작 타일이 같은 종료 위치로 가는 저장된 경로 위에 있다면 그 뒤쪽 경로를 사용한다
+    // 막힘 / 이동 비용이 바뀐 타일은 UpdateTiles로 알려주면
+    // 막히거나 비용이 늘어난 경우는 그 주변을 지나는 경로만 제거하고 (다른 경로는 여전히 최단 경로)
+    // 열리거나 비용이 줄어든 경우는 어느 경로든 더 짧아질 수 있으므로 모든 경로를 제거한다
+    // 읽기는 여러 스레드에서 동시에 할 수 있고 추가 / 제거는 한 스레드씩 처리된다
+    //----------------------------------------------------------------------
+    class MPathCache
+    {
+    public:
+        MPathCache();
+        ~MPathCache();
+
+    public:
+        // 최대 경로 수 / 전체 경로 타일 수 (Reset 전에 설정)
+        void SetCapacity(MINT32 inMaxPathCount, MINT32 inMaxPointCount);
+
+        // 그리드 설정 (저장된 경로 / 통계 초기화)
+        void Reset(const MGrid* inGrid);
+
+        // 저장된 경로 모두 제거
+        void Clear();
+
+        // 바뀐 타일 반영 (그리드는 이미 변경된 상태여야 한다)
+        // 막히거나 비용이 늘어난 타일은 주변을 지나는 경로만, 열리거나 비용이 줄어든 타일이 있으면 모든 경로를 제거
+        void UpdateTiles(const std::vector<MIntPoint>& inChangedList);
+
+        // 그리드 변경 버전 (검색 전에 얻어서 AddPath에 넘긴다)
+        MUINT32 GetVersion() const {
+            return Version.load();
+        }
+
+        // 저장된 경로를 찾는다 (시작 ~ 종료 타일, 없다면 MFALSE)
+        MBOOL FindPath(const MPathCacheKey& inKey, const MIntPoint& inStartIndex2D, std::vector<MIntPoint>& outList) const;
+
+        // 저장된 경로를 outPath.Assign(처음, 끝)으로 넘긴다 (호출자 버퍼 등 std::vector가 아닌 대상에 바로 복사)
+        template<typename SINK>
+        MBOOL FindPath(const MPathCacheKey& inKey, const MIntPoint& inStartIndex2D, SINK& outPath) const
+        {
+            std::shared_lock<std::shared_mutex> lock(Mutex);
+
+            const MIntPoint* begin = nullptr;
+            const MIntPoint* end = nullptr;
+            if (MFALSE == FindRange(inKey, inStartIndex2D, begin, end)) {
+                return MFALSE;
+            }
+
+            outPath.Assign(begin, end);
+            return MTRUE;
+        }
+
+        // 경로 추가 (inVersion 이후로 그리드가 변경되었다면 저장하지 않는다)
+        // inMargin은 경로 타일에서 이 거리(체비셰프) 안의 타일이 바뀌면 경로를 제거할 범위
+        void AddPath(const MPathCacheKey& inKey, MUINT32 inVersion, MINT32 inMargin, const MIntPoint* inList, MINT32 inCount);
+
+        void AddPath(const MPathCacheKey& inKey, MUINT32 inVersion, MINT32 inMargin, const std::vector<MIntPoint>& inList) {
+            AddPath(inKey, inVersion, inMargin, inList.data(), static_cast<MINT32>(inList.size()));
+        }
+
+        // 대상 그리드 (Reset과 동시에 호출할 수 있도록 잠금 후 읽는다)
+        const MGrid* GetGrid() const;
+
+        //--------------------------------------------------------------
+        // 통계
+        //--------------------------------------------------------------
+        MINT32 GetPathCount() const;
+
+        // 같은 키 / 뒤쪽 경로 사용 / 찾지 못한 수
+        MUINT64 GetHitCount() const {
+            return HitCount.load();
+        }
+
+        MUINT64 GetSuffixHitCount() const {
+            return SuffixHitCount.load();
+        }
+
+        MUINT64 GetMissCount() const {
+            return MissCount.load();
+        }
+
+        // 타일 변경으로 제거된 경로 수
+        MUINT64 GetInvalidateCount() const {
+            return InvalidateCount.load();
+        }
+
+    protected:
+        // 경로가 지나가는 범위 (타일 인덱스, 양 끝 포함)
+        struct MRegion
+        {
+        public:
+            MIntPoint Min;
+            MIntPoint Max;
+        };
+
+        // 저장된 경로
+        struct MEntry
+        {
+        public:
+            MPathCacheKey Key;
+            std::vector<MIntPoint> PathList;
+
+            // 타일 변경시 체크할 범위 / 등록된 버킷
+            std::vector<MRegion> RegionList;
+            std::vector<MINT32> BucketIndexList;
+
+            // 사용 순서 리스트 (앞쪽이 최근, 없다면 -1)
+            MINT32 PrevSlot = -1;
+            MINT32 NextSlot = -1;
+
+            // 리스트 앞으로 옮겼을때의 사용 시간
+            MUINT64 ListTick = 0;
+
+            MBOOL IsUsed = MFALSE;
+        };
+
+    protected:
+        // 저장된 경로 범위를 찾는다 (잠금은 호출하는 쪽에서, 사용 시간 / 통계 갱신)
+        MBOOL FindRange(const MPathCacheKey& inKey, const MIntPoint& inStartIndex2D, const MIntPoint*& outBegin, const MIntPoint*& outEnd) const;
+
+        // 저장소 공간 확보 (오래 사용하지 않은 경로부터 제거)
+        void ReserveSpace(MINT32 inPointCount);
+
+        // 경로 제거
+        void RemoveEntry(MINT32 inSlot);
+
+        // 사용 순서 리스트
+        void LinkFront(MINT32 inSlot);
+        void Unlink(MINT32 inSlot);
+
+        // 경로가 지나가는 범위를 만들어서 버킷에 등록
+        void RegisterRegion(MINT32 inSlot, MINT32 inMargin);
+
+        // 저장된 경로 모두 제거 (잠금은 호출하는 쪽에서)
+        void RemoveAllEntry();
+
+        // 비용 비교용 타일 비용 (막힌 타일은 BlockedTileCost)
+        static MUINT16 GetTileCost(const MTile& inTile);
+
+        // 같은 종료 위치의 경로 목록 키
+        static MPathCacheKey GetGoalKey(const MPathCacheKey& inKey) {
+            MPathCacheKey key = inKey;
+            key.StartIndex = -1;
+            return key;
+        }
+
+    protected:
+        // 대상 그리드
+        const MGrid* Grid = nullptr;
+
+        // 마지막으로 알고 있는 타일별 비용 (UpdateTiles에서 비용이 줄었는지 비교)
+        std::vector<MUINT16> TileCostList;
+
+        // 최대 경로 수 / 전체 경로 타일 수
+        MINT32 MaxPathCount = 1024;
+        MINT32 MaxPointCount = 256 * 1024;
+
+        // 추가 / 제거와 읽기 동기화
+        mutable std::shared_mutex Mutex;
+
+        // 그리드 변경 버전
+        std::atomic<MUINT32> Version;
+
+        // 경로 저장소 / 빈 슬롯
+        std::vector<MEntry> EntryList;
+        std::vector<MINT32> FreeSlotList;
+
+        // 사용 순서 리스트 처음 / 끝
+        MINT32 HeadSlot = -1;
+        MINT32 TailSlot = -1;
+
+        // 저장된 경로 타일 수
+        MINT32 PointCount = 0;
+
+        // 슬롯별 마지막 사용 시간 (읽기 중에 갱신하므로 리스트는 제거할때 정리한다)
+        std::unique_ptr<std::atomic<MUINT64>[]> UseTickList;
+        mutable std::atomic<MUINT64> UseTick;
+
+        // 키 -> 슬롯 / 종료 위치 -> 슬롯 목록
+        std::unordered_map<MPathCacheKey, MINT32, MPathCacheKeyHash> KeyMap;
+        std::unordered_map<MPathCacheKey, std::vector<MINT32>, MPathCacheKeyHash> GoalMap;
+
+        // 버킷별 범위가 겹치는 슬롯 목록
+        MIntSize BucketCount;
+        std::vector<std::vector<MINT32>> BucketList;
+
+        // 통계
+        mutable std::atomic<MUINT64> HitCount;
+        mutable std::atomic<MUINT64> SuffixHitCount;
+        mutable std::atomic<MUINT64> MissCount;
+        std::atomic<MUINT64> InvalidateCount;
+    };
+};
@@ -0,0 +1,372 @@
+﻿#include "MPathSearch.h"
+
+#include <algorithm>
+
+
+namespace MAstar
+{
+    namespace
+    {
+        // 제한 시간을 확인하는 노드 확장 간격
+        const MINT32 DeadlineCheckInterval = 64;
+
+        // 검색 하나에 나눠줄 최소 노드 확장 수
+        const MINT32 MinExpandCountPerSearch = 64;
+    }
+
+    //---------------------------------------------------------------------------
+    // PathSearch
+    //---------------------------------------------------------------------------
+    void MPathSearch::Begin(const MGrid* inGrid, const MIntPoint& inStartIndex2D, const MIntPoint& inEndIndex2D, MFLOAT inWeight, MFLOAT inWeightStep)
+    {
+        Grid = inGrid;
+        StartIndex2D = inStartIndex2D;
+        EndIndex2D = inEndIndex2D;
+
+        Weight = std::max(inWeight, 1.0f);
+        WeightStep = inWeightStep;
+
+        PathList.clear();
+        PathCost = 0;
+        PathWeight = 0;
+        ExpandCount = 0;
+        InconsistentList.clear();
+
+        if (nullptr == Grid->GetTile(inStartIndex2D) || nullptr == Grid->GetTile(inEndIndex2D))
+        {
+            State = MPathSearchState::Failed;
+            return;
+        }
+
+        State = MPathSearchState::Running;
+
+        // 노드 저장소 / 열린 리스트 준비
+        const MINT32 tileCount = Grid->TileCount.X * Grid->TileCount.Y;
+        NodeTable.BeginSearch(tileCount);
+        OpenList.Reset(NodeTable.GetNodeData());
+
+        if (tileCount != static_cast<MINT32>(CloseStampList.size()))
+        {
+            CloseStampList.assign(tileCount, 0);
+            InconsistentStampList.assign(tileCount, 0);
+            CloseStamp = 0;
+        }
+
+        if (0 == ++CloseStamp)
+        {
+            std::fill(CloseStampList.begin(), CloseStampList.end(), 0);
+            std::fill(InconsistentStampList.begin(), InconsistentStampList.end(), 0);
+            CloseStamp = 1;
+        }
+
+        EndIndex = Grid->GetTileIndex(inEndIndex2D);
+
+        // 시작 노드 (혼자 열려있으므로 남은 거리는 필요 없다)
+        const MINT32 startIndex = Grid->GetTileIndex(inStartIndex2D);
+        NodeTable.VisitNode(startIndex, 0).SetDistance_G(0);
+        OpenList.Push(startIndex);
+    }
+
+    MPathSearchState MPathSearch::Step(MINT32 inMaxExpandCount)
+    {
+        RunStep(inMaxExpandCount, nullptr);
+        return State;
+    }
+
+    MPathSearchState MPathSearch::Step(const std::chrono::steady_clock::time_point& inDeadline)
+    {
+        RunStep(INFINITY_DISTANCE, &inDeadline);
+        return State;
+    }
+
+    void MPathSearch::Cancel()
+    {
+        if (MTRUE == IsFinished()) {
+            return;
+        }
+
+        // 찾은 경로가 있다면 그 경로로 끝낸다 (GetPathWeight로 배율 확인)
+        State = (MTRUE == PathList.empty()) ? MPathSearchState::Failed : MPathSearchState::Done;
+    }
+
+    MBOOL MPathSearch::GetPath(std::vector<MIntPoint>& outList) const
+    {
+        if (MTRUE == PathList.empty()) {
+            return MFALSE;
+        }
+
+        outList = PathList;
+        return MTRUE;
+    }
+
+    void MPathSearch::RunStep(MINT32 inMaxExpandCount, const std::chrono::steady_clock::time_point* inDeadline)
+    {
+        if (MTRUE == IsFinished()) {
+            return;
+        }
+
+        switch (NeighborMode)
+        {
+        case MNeighborMode::Eight:
+            if (MTRUE == IsUseTileCost) {
+                StepSearch<MNeighbor8<2>, MTileCost>(inMaxExpandCount, inDeadline);
+            }
+            else {
+                StepSearch<MNeighbor8<2>, MUniformCost>(inMaxExpandCount, inDeadline);
+            }
+            break;
+
+        case MNeighborMode::EightCornerCut:
+            if (MTRUE == IsUseTileCost) {
+                StepSearch<MNeighbor8<1>, MTileCost>(inMaxExpandCount, inDeadline);
+            }
+            else {
+                StepSearch<MNeighbor8<1>, MUniformCost>(inMaxExpandCount, inDeadline);
+            }
+            break;
+
+        default:
+            if (MTRUE == IsUseTileCost) {
+                StepSearch<MNeighbor4, MTileCost>(inMaxExpandCount, inDeadline);
+            }
+            else {
+                StepSearch<MNeighbor4, MUniformCost>(inMaxExpandCount, inDeadline);
+            }
+            break;
+        }
+    }
+
+    template<typename NEIGHBOR, typename COST>
+    void MPathSearch::StepSearch(MINT32 inMaxExpandCount, const std::chrono::steady_clock::time_point* inDeadline)
+    {
+        MINT32 count = 0;
+
+        while (count < inMaxExpandCount)
+        {
+            // 시간은 일정 간격으로만 확인
+            if (nullptr != inDeadline && 0 == (count % DeadlineCheckInterval) && *inDeadline <= std::chrono::steady_clock::now()) {
+                break;
+            }
+
+            //----------------------------------------------------------------
+            // 종료 노드의 거리보다 짧을 수 있는 노드가 없다면 이번 가중치의 검색이 끝난다
+            //----------------------------------------------------------------
+            const MINT32 checkIndex = OpenList.Top();
+            const MINT32 endDistance_G = (MTRUE == NodeTable.IsVisited(EndIndex)) ? NodeTable.GetNode(EndIndex).GetDistance_G() : INFINITY_DISTANCE;
+
+            if (checkIndex < 0 || endDistance_G <= NodeTable.GetNode(checkIndex).GetDistance_F())
+            {
+                FinishIteration<NEIGHBOR, COST>();
+                if (MTRUE == IsFinished()) {
+                    break;
+                }
+                continue;
+            }
+
+            OpenList.Pop();
+            CloseStampList[checkIndex] = CloseStamp;
+
+            UpdateAroundNode<NEIGHBOR, COST>(checkIndex);
+
+            ++count;
+            ++ExpandCount;
+        }
+    }
+
+    template<typename NEIGHBOR, typename COST>
+    void MPathSearch::UpdateAroundNode(MINT32 inBaseIndex)
+    {
+        const MIntPoint baseIndex2D = Grid->GetTileIndex2D(inBaseIndex);
+        const MINT32 baseDistance_G = NodeTable.GetNode(inBaseIndex).GetDistance_G();
+
+        auto IsTargetWalkable = [this](MINT32 inX, MINT32 inY)
+        {
+            return Grid->IsWalkable(inX, inY);
+        };
+
+        ForEachNeighbor<NEIGHBOR>(baseIndex2D, IsTargetWalkable, [&](const MIntPoint& inTargetIndex2D, MINT32 inDistance)
+        {
+            const MINT32 targetIndex = Grid->GetTileIndex(inTargetIndex2D);
+            MNode& targetNode = NodeTable.VisitNode(targetIndex, 0);
+
+            const MINT32 distance_G = baseDistance_G + COST::GetMoveCost(Grid, targetIndex, inDistance);
+            if (targetNode.GetDistance_G() <= distance_G) {
+                return;
+            }
+
+            targetNode.SetDistance_G(distance_G);
+            targetNode.SetPrevIndex(inBaseIndex);
+
+            // 이번 가중치에서 이미 닫힌 노드는 다음 가중치에서 다시 연다
+            if (MFALSE == IsClose(targetIndex)) {
+                PushOpen<NEIGHBOR>(targetIndex, inTargetIndex2D);
+            }
+            else if (CloseStamp != InconsistentStampList[targetIndex])
+            {
+                InconsistentStampList[targetIndex] = CloseStamp;
+                InconsistentList.push_back(targetIndex);
+            }
+        });
+    }
+
+    template<typename NEIGHBOR>
+    MINT32 MPathSearch::GetDistance_H(const MIntPoint& inIndex2D) const
+    {
+        const MINT32 distanceH = NEIGHBOR::GetDistance_H(abs(EndIndex2D.X - inIndex2D.X), abs(EndIndex2D.Y - inIndex2D.Y));
+        return static_cast<MINT32>(Weight * distanceH);
+    }
+
+    template<typename NEIGHBOR>
+    void MPathSearch::PushOpen(MINT32 inIndex, const MIntPoint& inIndex2D)
+    {
+        NodeTable.GetNode(inIndex).Distance_H = GetDistance_H<NEIGHBOR>(inIndex2D);
+
+        if (MTRUE == OpenList.IsContain(inIndex)) {
+            OpenList.Update(inIndex);
+        }
+        else {
+            OpenList.Push(inIndex);
+        }
+    }
+
+    template<typename NEIGHBOR, typename COST>
+    void MPathSearch::FinishIteration()
+    {
+        // 종료 위치에 도달하지 못했다
+        if (MFALSE == NodeTable.IsVisited(EndIndex) || INFINITY_DISTANCE == NodeTable.GetNode(EndIndex).GetDistance_G())
+        {
+            State = MPathSearchState::Failed;
+            return;
+        }
+
+        //----------------------------------------------------------------
+        // 결과 위치에서 역추적한다
+        // 닫힌 뒤에 거리가 줄어든 노드의 자식은 거리가 갱신되지 않았으므로
+        // 실제 경로 비용을 다시 계산해서 이전 경로보다 짧을때만 바꾼다
+        //----------------------------------------------------------------
+        std::vector<MIntPoint>& pathList = TempPathList;
+        pathList.clear();
+
+        MINT32 pathCost = 0;
+        for (MINT32 index = EndIndex; 0 <= index; )
+        {
+            const MIntPoint index2D = Grid->GetTileIndex2D(index);
+            pathList.push_back(index2D);
+
+            const MINT32 prevIndex = NodeTable.GetNode(index).GetPrevIndex();
+            if (0 <= prevIndex)
+            {
+                const MIntPoint prevIndex2D = Grid->GetTileIndex2D(prevIndex);
+                const MINT32 distance = (index2D.X != prevIndex2D.X && index2D.Y != prevIndex2D.Y) ? 14 : 10;
+                pathCost += COST::GetMoveCost(Grid, index, distance);
+            }
+
+            index = prevIndex;
+        }
+
+        if (MTRUE == PathList.empty() || pathCost < PathCost)
+        {
+            std::reverse(pathList.begin(), pathList.end());
+            PathList.swap(pathList);
+            PathCost = pathCost;
+        }
+
+        PathWeight = Weight;
+
+        if (Weight <= 1.0f)
+        {
+            State = MPathSearchState::Done;
+            return;
+        }
+
+        //----------------------------------------------------------------
+        // 다음 가중치로 진행
+        // 닫힌 노드를 모두 열 수 있게 하고 거리가 줄어든 닫힌 노드를 다시 열린 리스트에 넣는다
+        //----------------------------------------------------------------
+        State = MPathSearchState::Improving;
+        Weight = (0 < WeightStep) ? std::max(Weight - WeightStep, 1.0f) : 1.0f;
+
+        if (0 == ++CloseStamp)
+        {
+            std::fill(CloseStampList.begin(), CloseStampList.end(), 0);
+            std::fill(InconsistentStampList.begin(), InconsistentStampList.end(), 0);
+            CloseStamp = 1;
+        }
+
+        for (const MINT32 index : InconsistentList) {
+            OpenList.Push(index);
+        }
+        InconsistentList.clear();
+
+        // 열린 노드의 남은 거리를 새 가중치로 다시 계산
+        const MINT32 openCount = OpenList.GetCount();
+        for (MINT32 i = 0; i < openCount; ++i)
+        {
+            const MINT32 index = OpenList.GetAt(i);
+            NodeTable.GetNode(index).Distance_H = GetDistance_H<NEIGHBOR>(Grid->GetTileIndex2D(index));
+        }
+
+        OpenList.Rebuild();
+    }
+
+
+    //---------------------------------------------------------------------------
+    // PathScheduler
+    //---------------------------------------------------------------------------
+    void MPathScheduler::Add(MPathSearch* inSearch)
+    {
+        if (SearchList.end() == std::find(SearchList.begin(), SearchList.end(), inSearch)) {
+            SearchList.push_back(inSearch);
+        }
+    }
+
+    void MPathScheduler::Remove(MPathSearch* inSearch)
+    {
+        SearchList.erase(std::remove(SearchList.begin(), SearchList.end(), inSearch), SearchList.end());
+    }
+
+    MINT32 MPathScheduler::Update()
+    {
+        MINT32 remainCount = ExpandBudget;
+
+        // 경로가 없는 검색 먼저
+        RunSearch(MPathSearchState::Running, remainCount);
+        RunSearch(MPathSearchState::Improving, remainCount);
+
+        // 끝난 검색 제거 (시작하지 않은 검색은 Begin 이후에 처리하도록 남겨둔다)
+        SearchList.erase(std::remove_if(SearchList.begin(), SearchList.end(), [](const MPathSearch* inSearch) {
+            return MPathSearchState::Done == inSearch->GetState() || MPathSearchState::Failed == inSearch->GetState();
+        }), SearchList.end());
+
+        StartIndex = (MTRUE == SearchList.empty()) ? 0 : ((StartIndex + 1) % static_cast<MINT32>(SearchList.size()));
+
+        return ExpandBudget - remainCount;
+    }
+
+    void MPathScheduler::RunSearch(MPathSearchState inState, MINT32& inRemainCount)
+    {
+        const MINT32 searchCount = static_cast<MINT32>(SearchList.size());
+
+        MINT32 targetCount = 0;
+        for (const MPathSearch* search : SearchList) {
+            targetCount += (inState == search->GetState()) ? 1 : 0;
+        }
+
+        for (MINT32 i = 0; i < searchCount && 0 < targetCount && 0 < inRemainCount; ++i)
+        {
+            MPathSearch* search = SearchList[(StartIndex + i) % searchCount];
+            if (inState != search->GetState()) {
+                continue;
+            }
+
+            // 남은 수를 나눠준다 (먼저 끝난 검색이 남긴 수는 뒤의 검색이 사용)
+            const MINT32 expandCount = std::min(std::max(inRemainCount / targetCount, MinExpandCountPerSearch), inRemainCount);
+            const MINT32 prevExpandCount = search->GetExpandCount();
+
+            search->Step(expandCount);
+
+            inRemainCount -= search->GetExpandCount() - prevExpandCount;
+            --targetCount;
+        }
+    }
+};
@@ -0,0 +1,198 @@
+﻿#pragma once
+
+#include <vector>
+#include <chrono>
+
+#include "MPrerequisites.h"
+#include "MType.h"
+#include "MAstar.h"
+
+
+namespace MAstar
+{
+    //----------------------------------------------------------------------
+    // 나눠서 처리하는 검색 상태
+    //----------------------------------------------------------------------
+    enum class MPathSearchState
+    {
+        None,           // 시작하지 않음
+        Running,        // 아직 경로를 찾지 못함
+        Improving,      // 경로를 찾았고 더 짧은 경로로 다듬는 중 (GetPath로 현재 경로를 얻을 수 있다)
+        Done,           // 최단 경로를 찾음
+        Failed,         // 경로가 없음
+    };
+
+
+    //----------------------------------------------------------------------
+    // 여러 프레임에 나눠서 처리하는 경로 검색 (ARA*)
+    // 열린 / 닫힌 노드 정보를 유지하므로 Step을 여러번 호출해서 이어서 검색한다
+    // 가중치가 1보다 크면 남은 거리에 가중치를 곱해서 빠르게 경로를 찾고 (최단 경로의 가중치배 이하)
+    // 이후 가중치를 줄여가며 이전 검색 정보를 재사용해서 경로를 다듬는다
+    // 검색중에는 그리드를 변경하면 안된다
+    //----------------------------------------------------------------------
+    class MPathSearch
+    {
+    public:
+        // 주변 타일 방식 / 타일별 이동 비용 사용 설정 (Begin 전에 설정)
+        void SetNeighborMode(MNeighborMode inMode) {
+            NeighborMode = inMode;
+        }
+
+        void SetUseTileCost(MBOOL inIsUse) {
+            IsUseTileCost = inIsUse;
+        }
+
+        // 검색 시작
+        // inWeight : 처음 사용할 가중치 (1이라면 일반 A*), inWeightStep : 경로를 찾을때마다 줄일 가중치
+        void Begin(const MGrid* inGrid, const MIntPoint& inStartIndex2D, const MIntPoint& inEndIndex2D, MFLOAT inWeight = 1.0f, MFLOAT inWeightStep = 0.5f);
+
+        // 최대 inMaxExpandCount개의 노드를 확장하고 상태를 리턴
+        MPathSearchState Step(MINT32 inMaxExpandCount);
+
+        // 제한 시간까지 노드를 확장하고 상태를 리턴
+        MPathSearchState Step(const std::chrono::steady_clock::time_point& inDeadline);
+
+        // 검색 중단 (찾은 경로는 유지)
+        void Cancel();
+
+        MPathSearchState GetState() const {
+            return State;
+        }
+
+        // 검색이 끝났는지 (더이상 Step을 호출할 필요가 없다)
+        MBOOL IsFinished() const {
+            return MPathSearchState::Done == State || MPathSearchState::Failed == State || MPathSearchState::None == State;
+        }
+
+        // 지금까지 찾은 가장 짧은 경로 (없다면 MFALSE)
+        MBOOL GetPath(std::vector<MIntPoint>& outList) const;
+
+        // 찾은 경로의 비용
+        MINT32 GetPathCost() const {
+            return PathCost;
+        }
+
+        // 찾은 경로가 최단 경로의 몇배 이하인지
+        MFLOAT GetPathWeight() const {
+            return PathWeight;
+        }
+
+        // 지금까지 확장한 노드 수
+        MINT32 GetExpandCount() const {
+            return ExpandCount;
+        }
+
+    protected:
+        // 설정된 방식의 검색을 선택
+        void RunStep(MINT32 inMaxExpandCount, const std::chrono::steady_clock::time_point* inDeadline);
+
+        // 최대 inMaxExpandCount개의 노드를 확장 (inDeadline이 있다면 시간도 확인)
+        template<typename NEIGHBOR, typename COST>
+        void StepSearch(MINT32 inMaxExpandCount, const std::chrono::steady_clock::time_point* inDeadline);
+
+        // 주변 노드 갱신
+        template<typename NEIGHBOR, typename COST>
+        void UpdateAroundNode(MINT32 inBaseIndex);
+
+        // 가중치를 적용한 남은 거리
+        template<typename NEIGHBOR>
+        MINT32 GetDistance_H(const MIntPoint& inIndex2D) const;
+
+        // 열린 리스트에 추가 / 위치 갱신 (남은 거리를 현재 가중치로 다시 계산)
+        template<typename NEIGHBOR>
+        void PushOpen(MINT32 inIndex, const MIntPoint& inIndex2D);
+
+        // 이번 가중치의 검색이 끝났을때 경로를 저장하고 다음 가중치로 진행
+        template<typename NEIGHBOR, typename COST>
+        void FinishIteration();
+
+        // 이번 가중치에서 닫힌 노드인지
+        MBOOL IsClose(MINT32 inIndex) const {
+            return CloseStamp == CloseStampList[inIndex];
+        }
+
+    protected:
+        // 대상 그리드
+        const MGrid* Grid = nullptr;
+
+        // 주변 타일 방식
+        MNeighborMode NeighborMode = MNeighborMode::Four;
+        MBOOL IsUseTileCost = MFALSE;
+
+        // 시작 / 종료 위치
+        MIntPoint StartIndex2D;
+        MIntPoint EndIndex2D;
+        MINT32 EndIndex = -1;
+
+        // 검색 상태
+        MPathSearchState State = MPathSearchState::None;
+
+        // 현재 가중치 / 줄일 가중치
+        MFLOAT Weight = 1.0f;
+        MFLOAT WeightStep = 0.5f;
+
+        // 노드 저장소 / 열린 리스트
+        MNodeTable NodeTable;
+        MOpenList OpenList;
+
+        // 가중치별 닫힌 노드 (가중치가 바뀔때마다 값을 올려서 초기화 없이 사용)
+        std::vector<MUINT32> CloseStampList;
+        MUINT32 CloseStamp = 0;
+
+        // 닫힌 뒤에 거리가 줄어든 노드 (다음 가중치에서 다시 연다)
+        std::vector<MINT32> InconsistentList;
+        std::vector<MUINT32> InconsistentStampList;
+
+        // 찾은 경로
+        std::vector<MIntPoint> PathList;
+        MINT32 PathCost = 0;
+        MFLOAT PathWeight = 0;
+
+        // 역추적용 임시 경로
+        std::vector<MIntPoint> TempPathList;
+
+        // 확장한 노드 수
+        MINT32 ExpandCount = 0;
+    };
+
+
+    //----------------------------------------------------------------------
+    // 여러 검색이 프레임당 노드 확장 수를 나눠서 사용
+    // 경로를 아직 찾지 못한 검색에 먼저 나눠주고 남으면 경로를 다듬는 검색에 나눠준다
+    // 검색 객체는 등록한 쪽에서 관리하고 끝난 검색 (Done / Failed)은 Update에서 목록에서 빠진다
+    // Begin 전에 등록한 검색은 Begin을 호출할때까지 확장 수를 받지 않고 목록에 남는다
+    //----------------------------------------------------------------------
+    class MPathScheduler
+    {
+    public:
+        // 프레임당 노드 확장 수
+        void SetExpandBudget(MINT32 inBudget) {
+            ExpandBudget = std::max(inBudget, 1);
+        }
+
+        // 검색 등록 / 제거 (삭제하기 전에 제거해야 한다)
+        void Add(MPathSearch* inSearch);
+        void Remove(MPathSearch* inSearch);
+
+        // 한 프레임 처리 (사용한 노드 확장 수를 리턴)
+        MINT32 Update();
+
+        MINT32 GetSearchCount() const {
+            return static_cast<MINT32>(SearchList.size());
+        }
+
+    protected:
+        // 해당 상태의 검색에 남은 확장 수를 나눠준다
+        void RunSearch(MPathSearchState inState, MINT32& inRemainCount);
+
+    protected:
+        // 등록된 검색
+        std::vector<MPathSearch*> SearchList;
+
+        // 프레임당 노드 확장 수
+        MINT32 ExpandBudget = 4096;
+
+        // 매 프레임 처리를 시작할 검색 (앞쪽 검색만 계속 먼저 처리되지 않도록)
+        MINT32 StartIndex = 0;
+    };
+};